@@ -8,6 +8,7 @@
 #include "../binary/binary.h"
 #include "../compiler_extensions.h"
 #include "./base32.h"
+#include "../parallel.h"
 
 #define EXTERN
 
@@ -44,16 +45,6 @@ const uint8_t base32hex[32] = {
 		//
 };
 
-#define ASCII_I 0x49
-#define ASCII_L 0x4c
-#define ASCII_O 0x4f
-#define ASCII_U 0x55
-
-#define ASCII_i 0x69
-#define ASCII_l 0x6c
-#define ASCII_o 0x6f
-#define ASCII_u 0x75
-
 ENCODING_PUBLIC
 EXTERN
 const uint8_t base32crockford[32] = {
@@ -66,6 +57,110 @@ const uint8_t base32crockford[32] = {
 		//
 };
 
+// Marks the bytes which aren't part of an alphabet in the decode tables.
+#define BASE32_INVALID 0xff
+
+// Map every possible byte to its base32 decoded counterpart. Any byte which
+// isn't part of the alphabet, including the padding character, maps to
+// BASE32_INVALID.
+//
+// Generated using tools/gen_decode_tables.c
+static const uint8_t base32_decode_table[256] = {
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x01, 0x02, 0x03, 0x04,
+		0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+		0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+		0x19, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
+// Same as base32_decode_table, but for base32hex.
+static const uint8_t base32hex_decode_table[256] = {
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x01,
+		0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+		0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+		0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
+// Marks '-' in base32crockford_decode_table, which base32crockford_decode
+// skips.
+#define BASE32_HYPHEN 0xfe
+
+// Same as base32_decode_table, but for base32crockford. Lowercase letters are
+// accepted, and 'I', 'L' and 'O' map to the values of '1', '1' and '0'. The
+// characters which can only be used as check symbols map to their values
+// from 32 to 36, which are never valid data.
+static const uint8_t base32crockford_decode_table[256] = {
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x22, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0x20, 0xff, 0xff, 0xfe, 0xff, 0xff, 0x00, 0x01,
+		0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xff, 0xff,
+		0xff, 0x23, 0xff, 0xff, 0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+		0x0f, 0x10, 0x11, 0x01, 0x12, 0x13, 0x01, 0x14, 0x15, 0x00,
+		0x16, 0x17, 0x18, 0x19, 0x1a, 0x24, 0x1b, 0x1c, 0x1d, 0x1e,
+		0x1f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x0a, 0x0b, 0x0c,
+		0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x01, 0x12, 0x13, 0x01, 0x14,
+		0x15, 0x00, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x24, 0x1b, 0x1c,
+		0x1d, 0x1e, 0x1f, 0xff, 0xff, 0xff, 0x21, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
 static size_t
 get_num_padding_chars(const size_t str_len, const uint8_t* str)
 {
@@ -81,115 +176,160 @@ get_num_padding_chars(const size_t str_len, const uint8_t* str)
 	return result;
 }
 
+// Returns true if a final group with num_padding_chars padding characters
+// holds a whole number of bytes.
 static bool
-base32_isalpha(uint8_t c)
+padding_valid(const size_t num_padding_chars)
 {
-	return ((c | 32) - 0x61) < 26;
+	switch (num_padding_chars) {
+	case 0: // fallthrough
+	case 1: // fallthrough
+	case 3: // fallthrough
+	case 4: // fallthrough
+	case 6:
+		return true;
+	default:
+		return false;
+	}
 }
 
 static bool
 base32_isdigit(uint8_t c)
 {
-	return c - 0x30 < 10;
+	return (uint8_t)(c - 0x30) < 10;
 }
 
+// Checks that every character in str before the padding is between lo1 and
+// hi1 or between lo2 and hi2, 8 characters at a time. The base32 and
+// base32hex alphabets are both made up of two such ranges.
 static bool
-base32_valid_fast(const size_t str_len, const uint8_t* str,
-		const size_t num_padding_chars)
+valid_fast(const size_t str_len, const uint8_t* str,
+		const size_t num_padding_chars, const uint8_t lo1,
+		const uint8_t hi1, const uint8_t lo2, const uint8_t hi2)
 {
-	int result = 1;
-	for (size_t i = 0; i < str_len - num_padding_chars; i += 8) {
-		// 'A' to 'Z'
-		int tmp1 = (str[i] - 0x41) <= 0x19;
-		int tmp2 = (str[i + 1] - 0x41) <= 0x19;
-		int tmp3 = (str[i + 2] - 0x41) <= 0x19;
-		int tmp4 = (str[i + 3] - 0x41) <= 0x19;
-		int tmp5 = (str[i + 4] - 0x41) <= 0x19;
-		int tmp6 = (str[i + 5] - 0x41) <= 0x19;
-		int tmp7 = (str[i + 6] - 0x41) <= 0x19;
-		int tmp8 = (str[i + 7] - 0x41) <= 0x19;
-
-		// '2' to '7'
-		tmp1 |= (str[i] - 0x32) <= 5;
-		tmp2 |= (str[i + 1] - 0x32) <= 5;
-		tmp3 |= (str[i + 2] - 0x32) <= 5;
-		tmp4 |= (str[i + 3] - 0x32) <= 5;
-		tmp5 |= (str[i + 4] - 0x32) <= 5;
-		tmp6 |= (str[i + 5] - 0x32) <= 5;
-		tmp7 |= (str[i + 6] - 0x32) <= 5;
-		tmp8 |= (str[i + 7] - 0x32) <= 5;
-
-		result &= tmp1 & tmp2 & tmp3 & tmp4 & tmp5 & tmp6 & tmp7 &
-			  tmp8;
+	const uint64_t high_bits = UINT64_C(0x8080808080808080);
+	const size_t   data_len  = str_len - num_padding_chars;
+
+	uint64_t result = high_bits;
+	size_t   i      = 0;
+	for (; i + 8 <= data_len; i += 8) {
+		uint64_t word;
+		binary_uint64_decode(8, &str[i], &word,
+				ENCODING_BYTE_ORDER_LITTLE);
+
+		// Bytes with their high bit set are never valid.
+		const uint64_t ascii = word & ~high_bits;
+		const uint64_t valid = swar_between(ascii, lo1, hi1) |
+				       swar_between(ascii, lo2, hi2);
+
+		result &= valid & ~word;
 	}
 
-	return result;
+	// The last group can be cut short by padding.
+	bool tail = true;
+	for (; i < data_len; i += 1) {
+		const uint8_t c = str[i];
+		tail &= ((c >= lo1) & (c <= hi1)) | ((c >= lo2) & (c <= hi2));
+	}
+
+	return (result == high_bits) & tail;
 }
 
+// Same as valid_fast, but for base32crockford, which accepts lowercase
+// letters, and 'I', 'L' and 'O' in place of digits. 'U' is the only letter
+// which isn't accepted.
 static bool
-base32hex_valid_fast(const size_t str_len, const uint8_t* str,
+crockford_valid_fast(const size_t str_len, const uint8_t* str,
 		const size_t num_padding_chars)
 {
-	int result = 1;
-	for (size_t i = 0; i < str_len - num_padding_chars; i += 8) {
-		// '0' to '9'
-		int tmp1 = base32_isdigit(str[i]);
-		int tmp2 = base32_isdigit(str[i + 1]);
-		int tmp3 = base32_isdigit(str[i + 2]);
-		int tmp4 = base32_isdigit(str[i + 3]);
-		int tmp5 = base32_isdigit(str[i + 4]);
-		int tmp6 = base32_isdigit(str[i + 5]);
-		int tmp7 = base32_isdigit(str[i + 6]);
-		int tmp8 = base32_isdigit(str[i + 7]);
-
-		// 'A' to 'V'
-		tmp1 |= (str[i] - 0x41) <= 0x15;
-		tmp2 |= (str[i + 1] - 0x41) <= 0x15;
-		tmp3 |= (str[i + 2] - 0x41) <= 0x15;
-		tmp4 |= (str[i + 3] - 0x41) <= 0x15;
-		tmp5 |= (str[i + 4] - 0x41) <= 0x15;
-		tmp6 |= (str[i + 5] - 0x41) <= 0x15;
-		tmp7 |= (str[i + 6] - 0x41) <= 0x15;
-		tmp8 |= (str[i + 7] - 0x41) <= 0x15;
-
-		result &= tmp1 & tmp2 & tmp3 & tmp4 & tmp5 & tmp6 & tmp7 &
-			  tmp8;
+	const uint64_t high_bits = UINT64_C(0x8080808080808080);
+	const uint64_t case_bits = UINT64_C(0x2020202020202020);
+	const size_t   data_len  = str_len - num_padding_chars;
+
+	uint64_t result = high_bits;
+	size_t   i      = 0;
+	for (; i + 8 <= data_len; i += 8) {
+		uint64_t word;
+		binary_uint64_decode(8, &str[i], &word,
+				ENCODING_BYTE_ORDER_LITTLE);
+
+		// Setting 0x20 makes each letter lowercase, and doesn't turn
+		// anything else into a letter.
+		const uint64_t ascii = word & ~high_bits;
+		const uint64_t lower = ascii | case_bits;
+
+		// '0' to '9', 'a' to 't' and 'v' to 'z'
+		const uint64_t valid = swar_between(ascii, 0x30, 0x39) |
+				       swar_between(lower, 0x61, 0x74) |
+				       swar_between(lower, 0x76, 0x7a);
+
+		result &= valid & ~word;
 	}
 
-	return result;
+	bool tail = true;
+	for (; i < data_len; i += 1) {
+		const uint8_t c     = str[i];
+		const uint8_t lower = c | 0x20;
+		tail &= base32_isdigit(c) |
+			((lower >= 0x61) & (lower <= 0x74)) |
+			((lower >= 0x76) & (lower <= 0x7a));
+	}
+
+	return (result == high_bits) & tail;
+}
+
+// Fills bitmap so that bit (c & 0x1f) of bitmap[c >> 5] is set for every
+// character c in alphabet.
+static void
+bitmap_fill(const uint8_t alphabet[32], uint32_t bitmap[8])
+{
+	for (size_t i = 0; i < 8; i += 1) {
+		bitmap[i] = 0;
+	}
+
+	for (size_t i = 0; i < 32; i += 1) {
+		const uint8_t c = alphabet[i];
+		bitmap[c >> 5] |= UINT32_C(1) << (c & 0x1f);
+	}
 }
 
+// Checks that every character in str before the padding is in bitmap.
 static bool
-base32crockford_valid(const size_t str_len, const uint8_t* str,
-		const size_t num_padding_chars)
+valid_bitmap(const size_t str_len, const uint8_t* str,
+		const size_t num_padding_chars, const uint32_t bitmap[8])
 {
-	int result = 1;
-	for (size_t i = 0; i < str_len - num_padding_chars; i += 8) {
-		// 'A' to 'Z' and 'a' to 'z'
-		int tmp1 = base32_isalpha(str[i]);
-		int tmp2 = base32_isalpha(str[i + 1]);
-		int tmp3 = base32_isalpha(str[i + 2]);
-		int tmp4 = base32_isalpha(str[i + 3]);
-		int tmp5 = base32_isalpha(str[i + 4]);
-		int tmp6 = base32_isalpha(str[i + 5]);
-		int tmp7 = base32_isalpha(str[i + 6]);
-		int tmp8 = base32_isalpha(str[i + 7]);
-
-		// '0' to '9'
-		tmp1 |= base32_isdigit(str[i]);
-		tmp2 |= base32_isdigit(str[i + 1]);
-		tmp3 |= base32_isdigit(str[i + 2]);
-		tmp4 |= base32_isdigit(str[i + 3]);
-		tmp5 |= base32_isdigit(str[i + 4]);
-		tmp6 |= base32_isdigit(str[i + 5]);
-		tmp7 |= base32_isdigit(str[i + 6]);
-		tmp8 |= base32_isdigit(str[i + 7]);
-
-		result &= tmp1 & tmp2 & tmp3 & tmp4 & tmp5 & tmp6 & tmp7 &
-			  tmp8;
+	uint32_t result = 1;
+	for (size_t i = 0; i < str_len - num_padding_chars; i += 1) {
+		result &= bitmap[str[i] >> 5] >> (str[i] & 0x1f);
 	}
 
-	return result;
+	return result & 1;
+}
+
+// Checks that every character in str is in decode_table, which maps the
+// bytes that aren't part of the alphabet to BASE32_INVALID.
+static bool
+valid_table(const size_t str_len, const uint8_t* str,
+		const uint8_t decode_table[256])
+{
+	// Separate accumulators let the lookups run in parallel.
+	uint8_t a = 0;
+	uint8_t b = 0;
+	uint8_t c = 0;
+	uint8_t d = 0;
+	size_t  i = 0;
+	for (; i + 4 <= str_len; i += 4) {
+		a |= decode_table[str[i]];
+		b |= decode_table[str[i + 1]];
+		c |= decode_table[str[i + 2]];
+		d |= decode_table[str[i + 3]];
+	}
+
+	for (; i < str_len; i += 1) {
+		a |= decode_table[str[i]];
+	}
+
+	return (a | b | c | d) <= 0x1f;
 }
 
 // base32_valid returns true if str is valid base32, false otherwise.
@@ -207,61 +347,27 @@ base32_valid(const size_t str_len, const uint8_t* str,
 	}
 
 	size_t num_padding_chars = get_num_padding_chars(str_len, str);
-	if (UNLIKELY(num_padding_chars > 6 || str_len % 8 != 0)) {
+	if (UNLIKELY(!padding_valid(num_padding_chars) || str_len % 8 != 0)) {
 		return false;
 	}
 
 	if (alphabet == base32) {
-		return base32_valid_fast(str_len, str, num_padding_chars);
+		return valid_fast(str_len, str, num_padding_chars, 0x41, 0x5a,
+				0x32, 0x37);
 	}
 
 	if (alphabet == base32hex) {
-		return base32hex_valid_fast(str_len, str, num_padding_chars);
+		return valid_fast(str_len, str, num_padding_chars, 0x30, 0x39,
+				0x41, 0x56);
 	}
 
 	if (alphabet == base32crockford) {
-		return base32crockford_valid(str_len, str, num_padding_chars);
-	}
-
-	int    result = 1;
-	size_t i      = 0;
-	for (; i + 8 < str_len - num_padding_chars; i += 8) {
-		int valid1 = 0;
-		int valid2 = 0;
-		int valid3 = 0;
-		int valid4 = 0;
-		int valid5 = 0;
-		int valid6 = 0;
-		int valid7 = 0;
-		int valid8 = 0;
-
-		for (size_t j = 0; j < 32; j += 1) {
-			valid1 |= str[i] == alphabet[j];
-			valid2 |= str[i + 1] == alphabet[j];
-			valid3 |= str[i + 2] == alphabet[j];
-			valid4 |= str[i + 3] == alphabet[j];
-			valid5 |= str[i + 4] == alphabet[j];
-			valid6 |= str[i + 5] == alphabet[j];
-			valid7 |= str[i + 6] == alphabet[j];
-			valid8 |= str[i + 7] == alphabet[j];
-		}
-
-		result &= valid1 & valid2 & valid3 & valid4 & valid5 & valid6 &
-			  valid7 & valid8;
+		return crockford_valid_fast(str_len, str, num_padding_chars);
 	}
 
-	i -= 8;
-
-	for (; i < str_len - num_padding_chars; i += 1) {
-		int tmp = 0;
-		for (size_t j = 0; j < 32; j += 1) {
-			tmp |= str[i] == alphabet[j];
-		}
-
-		result &= tmp;
-	}
-
-	return result;
+	uint32_t bitmap[8];
+	bitmap_fill(alphabet, bitmap);
+	return valid_bitmap(str_len, str, num_padding_chars, bitmap);
 }
 
 // base32_encoded_length returns the base32 encoded size of the
@@ -298,6 +404,173 @@ base32_decoded_length(const size_t str_len, const uint8_t* str)
 	return base32_decoded_length_impl(str_len, str);
 }
 
+#if ENCODING_X86_SIMD
+// The SIMD encoders work on two groups of 5 bytes in each 128-bit lane.
+//
+// Each of the 16 characters a lane encodes to is made from at most two
+// neighbouring bytes, so those bytes are shuffled into a 16-bit word, and a
+// multiplication by 1 << (16 - n), keeping the high half, shifts the word
+// right by the n bits which leave the 5-bit value at the bottom. Even and odd
+// characters are handled separately, since each needs a word of its own, and
+// then interleaved. Finally each 5-bit value is translated to its character
+// by looking it up in both halves of the alphabet using pshufb, so any
+// alphabet can be used.
+
+ENCODING_TARGET("ssse3")
+static __m128i
+encode_split_ssse3(const __m128i in)
+{
+	const __m128i mask = _mm_set1_epi16(0x1f);
+
+	// The last character of each group only needs one byte.
+	const __m128i even_words = _mm_shuffle_epi8(in,
+			_mm_setr_epi8(1, 0, 2, 1, 3, 2, 4, 3, 6, 5, 7, 6, 8, 7,
+					9, 8));
+	const __m128i odd_words = _mm_shuffle_epi8(in,
+			_mm_setr_epi8(1, 0, 2, 1, 4, 3, -1, 4, 6, 5, 7, 6, 9,
+					8, -1, 9));
+
+	const __m128i even = _mm_mulhi_epu16(even_words,
+			_mm_setr_epi16(32, 128, 512, 2048, 32, 128, 512,
+					2048));
+	const __m128i odd = _mm_mulhi_epu16(odd_words,
+			_mm_setr_epi16(1024, 4096, 64, 256, 1024, 4096, 64,
+					256));
+	return _mm_or_si128(_mm_and_si128(even, mask),
+			_mm_slli_epi16(_mm_and_si128(odd, mask), 8));
+}
+
+ENCODING_TARGET("ssse3")
+static __m128i
+encode_translate_ssse3(const __m128i indices, const __m128i alphabet_lo,
+		const __m128i alphabet_hi)
+{
+	// pshufb only looks at the low 4 bits of each index, so look up both
+	// halves and pick the right one for each index.
+	const __m128i is_hi = _mm_cmpgt_epi8(indices, _mm_set1_epi8(15));
+	const __m128i lo    = _mm_shuffle_epi8(alphabet_lo, indices);
+	const __m128i hi    = _mm_shuffle_epi8(alphabet_hi, indices);
+	return _mm_or_si128(_mm_andnot_si128(is_hi, lo),
+			_mm_and_si128(is_hi, hi));
+}
+
+// Encodes 10 bytes at a time, returning how many bytes of str were consumed.
+ENCODING_TARGET("ssse3")
+static size_t
+encode_ssse3(const size_t str_len, const uint8_t* str, uint8_t* out,
+		const uint8_t alphabet[32])
+{
+	const __m128i alphabet_lo = _mm_loadu_si128((const __m128i*)alphabet);
+	const __m128i alphabet_hi =
+			_mm_loadu_si128((const __m128i*)(alphabet + 16));
+
+	size_t i = 0;
+	size_t j = 0;
+	// We load 16 bytes but only use 10 of them.
+	for (; i + 16 <= str_len; i += 10, j += 16) {
+		const __m128i in = _mm_loadu_si128((const __m128i*)(str + i));
+		const __m128i indices = encode_split_ssse3(in);
+		_mm_storeu_si128((__m128i*)(out + j),
+				encode_translate_ssse3(indices, alphabet_lo,
+						alphabet_hi));
+	}
+
+	return i;
+}
+
+ENCODING_TARGET("avx2")
+static __m256i
+encode_split_avx2(const __m256i in)
+{
+	const __m256i mask = _mm256_set1_epi16(0x1f);
+
+	const __m256i even_words = _mm256_shuffle_epi8(in,
+			_mm256_setr_epi8(1, 0, 2, 1, 3, 2, 4, 3, 6, 5, 7, 6, 8,
+					7, 9, 8, 1, 0, 2, 1, 3, 2, 4, 3, 6, 5,
+					7, 6, 8, 7, 9, 8));
+	const __m256i odd_words = _mm256_shuffle_epi8(in,
+			_mm256_setr_epi8(1, 0, 2, 1, 4, 3, -1, 4, 6, 5, 7, 6,
+					9, 8, -1, 9, 1, 0, 2, 1, 4, 3, -1, 4,
+					6, 5, 7, 6, 9, 8, -1, 9));
+
+	const __m256i even = _mm256_mulhi_epu16(even_words,
+			_mm256_setr_epi16(32, 128, 512, 2048, 32, 128, 512,
+					2048, 32, 128, 512, 2048, 32, 128, 512,
+					2048));
+	const __m256i odd = _mm256_mulhi_epu16(odd_words,
+			_mm256_setr_epi16(1024, 4096, 64, 256, 1024, 4096, 64,
+					256, 1024, 4096, 64, 256, 1024, 4096,
+					64, 256));
+	return _mm256_or_si256(_mm256_and_si256(even, mask),
+			_mm256_slli_epi16(_mm256_and_si256(odd, mask), 8));
+}
+
+ENCODING_TARGET("avx2")
+static __m256i
+encode_translate_avx2(const __m256i indices, const __m256i alphabet_lo,
+		const __m256i alphabet_hi)
+{
+	const __m256i is_hi = _mm256_cmpgt_epi8(indices, _mm256_set1_epi8(15));
+	const __m256i lo    = _mm256_shuffle_epi8(alphabet_lo, indices);
+	const __m256i hi    = _mm256_shuffle_epi8(alphabet_hi, indices);
+	return _mm256_or_si256(_mm256_andnot_si256(is_hi, lo),
+			_mm256_and_si256(is_hi, hi));
+}
+
+// Encodes 20 bytes at a time, returning how many bytes of str were consumed.
+ENCODING_TARGET("avx2")
+static size_t
+encode_avx2(const size_t str_len, const uint8_t* str, uint8_t* out,
+		const uint8_t alphabet[32])
+{
+	const __m256i alphabet_lo = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((const __m128i*)alphabet));
+	const __m256i alphabet_hi = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((const __m128i*)(alphabet + 16)));
+
+	size_t i = 0;
+	size_t j = 0;
+	// Each 128-bit lane gets 10 bytes of input, so we load 16 bytes for
+	// each lane separately.
+	for (; i + 26 <= str_len; i += 20, j += 32) {
+		const __m128i lo = _mm_loadu_si128((const __m128i*)(str + i));
+		const __m128i hi = _mm_loadu_si128(
+				(const __m128i*)(str + i + 10));
+		const __m256i in = _mm256_inserti128_si256(
+				_mm256_castsi128_si256(lo), hi, 1);
+
+		const __m256i indices = encode_split_avx2(in);
+		_mm256_storeu_si256((__m256i*)(out + j),
+				encode_translate_avx2(indices, alphabet_lo,
+						alphabet_hi));
+	}
+
+	return i;
+}
+
+// Encodes as much of str as possible using the best kernel the CPU supports,
+// returning how many bytes of str were consumed. This is always a multiple
+// of 5.
+static size_t
+encode_simd(const size_t str_len, const uint8_t* str, uint8_t* out,
+		const uint8_t alphabet[32])
+{
+	const int features = encoding_cpu_features();
+
+	size_t i = 0;
+	if (features & ENCODING_CPU_AVX2) {
+		i = encode_avx2(str_len, str, out, alphabet);
+	}
+
+	if (features & ENCODING_CPU_SSSE3) {
+		i += encode_ssse3(str_len - i, str + i, out + (i / 5 * 8),
+				alphabet);
+	}
+
+	return i;
+}
+#endif // ENCODING_X86_SIMD
+
 ENCODING_PUBLIC
 int
 base32_encode(const size_t str_len, const uint8_t* str, const size_t out_len,
@@ -316,8 +589,12 @@ base32_encode(const size_t str_len, const uint8_t* str, const size_t out_len,
 		return ENCODING_BUFFER_TOO_SMALL;
 	}
 
-	size_t j = 0;
 	size_t i = 0;
+#if ENCODING_X86_SIMD
+	i = encode_simd(str_len, str, out, alphabet);
+#endif
+
+	size_t j = i / 5 * 8;
 	while (i + 4 < str_len) {
 		out[j]     = alphabet[(str[i] >> 3)];
 		out[j + 1] = alphabet[(str[i] & 0x07) << 2 | str[i + 1] >> 6];
@@ -387,79 +664,492 @@ base32_encode(const size_t str_len, const uint8_t* str, const size_t out_len,
 	return 0;
 }
 
-static uint8_t
-alphabet_find(const uint8_t ch, const uint8_t alphabet[32])
+// Fills decode_table with the 5-bit value of each byte in alphabet, and
+// BASE32_INVALID for every other byte.
+static void
+decode_table_fill(const uint8_t alphabet[32], uint8_t decode_table[256])
 {
+	for (size_t i = 0; i < 256; i += 1) {
+		decode_table[i] = BASE32_INVALID;
+	}
+
 	for (uint8_t i = 0; i < 32; i += 1) {
-		if (ch == alphabet[i]) {
-			return i;
+		decode_table[alphabet[i]] = i;
+	}
+}
+
+// Fills first, last and value with the ranges of consecutive characters
+// alphabet is made of, as described in struct decode_ranges. Returns false if
+// it has more than two, or they aren't all ASCII.
+static bool
+decode_ranges_fill(const uint8_t alphabet[32], uint8_t first[2],
+		uint8_t last[2], uint8_t value[2])
+{
+	size_t num_ranges = 0;
+	for (size_t i = 0; i < 32; i += 1) {
+		if (i != 0 && alphabet[i] == alphabet[i - 1] + 1) {
+			last[num_ranges - 1] = alphabet[i];
+			continue;
+		}
+
+		if (num_ranges == 2) {
+			return false;
 		}
+
+		first[num_ranges] = alphabet[i];
+		last[num_ranges]  = alphabet[i];
+		value[num_ranges] = (uint8_t)i;
+		num_ranges += 1;
+	}
+
+	if (num_ranges == 1) {
+		first[1] = first[0];
+		last[1]  = last[0];
+		value[1] = value[0];
 	}
 
-	return UINT8_MAX;
+	// The vectorized decoders compare signed bytes against last + 1.
+	return last[0] < 0x7f && last[1] < 0x7f;
 }
 
-static uint8_t
-crockford_normalize(uint8_t c)
+// Fills lookup with the num_rows rows of 16 bytes in table, each XORed with
+// the row before it, for lookup_rows_ssse3 and lookup_rows_avx2.
+static void
+lookup_fill(const uint8_t* table, const size_t num_rows, uint8_t* lookup)
 {
-	if (base32_isdigit(c)) {
-		return c;
+	for (size_t i = 0; i < 16; i += 1) {
+		lookup[i] = table[i];
 	}
 
-	c &= 0x5f;
+	for (size_t i = 16; i < num_rows * 16; i += 1) {
+		lookup[i] = table[i] ^ table[i - 16];
+	}
+}
 
-	switch (c) {
-	case ASCII_I: // fallthrough
-	case ASCII_L:
-		return 0x31;
-	case ASCII_O:
-		return 0x30;
-	default:
-		return c;
+// The tables decode_fast decodes with. ranges and lookup are NULL for
+// alphabets which don't have them. Only compiled alphabets have lookup, and
+// ranges is preferred when both are set.
+struct decode_tables {
+	const uint8_t*               decode;
+	const struct decode_ranges* ranges;
+	const uint8_t*               lookup;
+};
+
+#if ENCODING_X86_SIMD
+// The base32 and base32hex alphabets are both made of two ranges of
+// characters, which the vectorized decoders use to validate and translate
+// each character. The characters from first[n] to last[n] decode to the
+// values starting at value[n]. base32_alphabet_compile finds the ranges of
+// custom alphabets laid out the same way, such as lowercase base32.
+struct decode_ranges {
+	uint8_t first[2];
+	uint8_t last[2];
+	uint8_t value[2];
+};
+
+static const struct decode_ranges base32_decode_ranges = {
+		{0x41, 0x32}, // 'A', '2'
+		{0x5a, 0x37}, // 'Z', '7'
+		{0, 26},
+};
+
+static const struct decode_ranges base32hex_decode_ranges = {
+		{0x30, 0x41}, // '0', 'A'
+		{0x39, 0x56}, // '9', 'V'
+		{0, 10},
+};
+
+// Packs the 5-bit values in each 64-bit lane into 5 bytes, leaving the 10
+// decoded bytes at the start of the register.
+ENCODING_TARGET("ssse3")
+static __m128i
+decode_pack_ssse3(const __m128i quintets)
+{
+	const __m128i pairs = _mm_maddubs_epi16(
+			quintets, _mm_set1_epi16(0x0120));
+	const __m128i quads =
+			_mm_madd_epi16(pairs, _mm_set1_epi32(0x00010400));
+
+	// Each 64-bit lane now holds the first 20 bits of a group in its low
+	// half, and the last 20 bits in its high half.
+	const __m128i first = _mm_and_si128(_mm_slli_epi64(quads, 20),
+			_mm_set1_epi64x(0x000000fffff00000));
+	const __m128i group =
+			_mm_or_si128(first, _mm_srli_epi64(quads, 32));
+	return _mm_shuffle_epi8(group,
+			_mm_setr_epi8(4, 3, 2, 1, 0, 12, 11, 10, 9, 8, -1, -1,
+					-1, -1, -1, -1));
+}
+
+// Stores the 10 decoded bytes at the start of packed into out.
+ENCODING_TARGET("ssse3")
+static void
+decode_store_ssse3(uint8_t* out, const __m128i packed)
+{
+	_mm_storel_epi64((__m128i*)out, packed);
+	binary_uint16_encode((uint16_t)_mm_extract_epi16(packed, 4), 2,
+			out + 8, ENCODING_BYTE_ORDER_LITTLE);
+}
+
+// Decodes 16 characters at a time, returning how many characters of str were
+// consumed. Stops early at the first block containing a character which
+// isn't part of the alphabet.
+ENCODING_TARGET("ssse3")
+static size_t
+decode_ssse3(const size_t str_len, const uint8_t* str, uint8_t* out,
+		const struct decode_ranges* ranges)
+{
+	// The comparisons are signed, so bytes from 0x80 onwards are never in
+	// either range.
+	const __m128i above1  = _mm_set1_epi8((char)(ranges->first[0] - 1));
+	const __m128i below1  = _mm_set1_epi8((char)(ranges->last[0] + 1));
+	const __m128i offset1 = _mm_set1_epi8(
+			(char)(ranges->value[0] - ranges->first[0]));
+	const __m128i above2  = _mm_set1_epi8((char)(ranges->first[1] - 1));
+	const __m128i below2  = _mm_set1_epi8((char)(ranges->last[1] + 1));
+	const __m128i offset2 = _mm_set1_epi8(
+			(char)(ranges->value[1] - ranges->first[1]));
+
+	size_t i = 0;
+	size_t j = 0;
+	for (; i + 16 <= str_len; i += 16, j += 10) {
+		const __m128i in = _mm_loadu_si128((const __m128i*)(str + i));
+		const __m128i in1 = _mm_and_si128(_mm_cmpgt_epi8(in, above1),
+				_mm_cmpgt_epi8(below1, in));
+		const __m128i in2 = _mm_and_si128(_mm_cmpgt_epi8(in, above2),
+				_mm_cmpgt_epi8(below2, in));
+		if (UNLIKELY(_mm_movemask_epi8(_mm_or_si128(in1, in2)) !=
+				0xffff)) {
+			break;
+		}
+
+		const __m128i offsets = _mm_or_si128(
+				_mm_and_si128(in1, offset1),
+				_mm_and_si128(in2, offset2));
+		const __m128i quintets = _mm_add_epi8(in, offsets);
+		decode_store_ssse3(out + j, decode_pack_ssse3(quintets));
+	}
+
+	return i;
+}
+
+// Packs the 5-bit values in each 64-bit lane into 5 bytes, and stores the 20
+// decoded bytes in out.
+ENCODING_TARGET("avx2")
+static void
+decode_store_avx2(uint8_t* out, const __m256i quintets)
+{
+	const __m256i pack = _mm256_setr_epi8(4, 3, 2, 1, 0, 12, 11, 10, 9, 8,
+			-1, -1, -1, -1, -1, -1, 4, 3, 2, 1, 0, 12, 11, 10, 9,
+			8, -1, -1, -1, -1, -1, -1);
+
+	const __m256i pairs = _mm256_maddubs_epi16(
+			quintets, _mm256_set1_epi16(0x0120));
+	const __m256i quads = _mm256_madd_epi16(
+			pairs, _mm256_set1_epi32(0x00010400));
+	const __m256i first = _mm256_and_si256(_mm256_slli_epi64(quads, 20),
+			_mm256_set1_epi64x(0x000000fffff00000));
+	const __m256i group =
+			_mm256_or_si256(first, _mm256_srli_epi64(quads, 32));
+	const __m256i packed = _mm256_shuffle_epi8(group, pack);
+
+	decode_store_ssse3(out, _mm256_castsi256_si128(packed));
+	decode_store_ssse3(out + 10, _mm256_extracti128_si256(packed, 1));
+}
+
+// Same as decode_ssse3, but 32 characters at a time.
+ENCODING_TARGET("avx2")
+static size_t
+decode_avx2(const size_t str_len, const uint8_t* str, uint8_t* out,
+		const struct decode_ranges* ranges)
+{
+	const __m256i above1 = _mm256_set1_epi8((char)(ranges->first[0] - 1));
+	const __m256i below1 = _mm256_set1_epi8((char)(ranges->last[0] + 1));
+	const __m256i offset1 = _mm256_set1_epi8(
+			(char)(ranges->value[0] - ranges->first[0]));
+	const __m256i above2 = _mm256_set1_epi8((char)(ranges->first[1] - 1));
+	const __m256i below2 = _mm256_set1_epi8((char)(ranges->last[1] + 1));
+	const __m256i offset2 = _mm256_set1_epi8(
+			(char)(ranges->value[1] - ranges->first[1]));
+
+	size_t i = 0;
+	size_t j = 0;
+	for (; i + 32 <= str_len; i += 32, j += 20) {
+		const __m256i in =
+				_mm256_loadu_si256((const __m256i*)(str + i));
+		const __m256i in1 = _mm256_and_si256(
+				_mm256_cmpgt_epi8(in, above1),
+				_mm256_cmpgt_epi8(below1, in));
+		const __m256i in2 = _mm256_and_si256(
+				_mm256_cmpgt_epi8(in, above2),
+				_mm256_cmpgt_epi8(below2, in));
+		const __m256i valid = _mm256_or_si256(in1, in2);
+		if (UNLIKELY(_mm256_movemask_epi8(valid) != -1)) {
+			break;
+		}
+
+		const __m256i offsets = _mm256_or_si256(
+				_mm256_and_si256(in1, offset1),
+				_mm256_and_si256(in2, offset2));
+		const __m256i quintets = _mm256_add_epi8(in, offsets);
+		decode_store_avx2(out + j, quintets);
+	}
+
+	return i;
+}
+
+// pshufb only looks at 16 bytes, so the decoders for alphabets which aren't
+// made of two ranges look up the first 128 entries of the decode table one
+// row of 16 at a time. Each row is stored XORed with the previous one by
+// lookup_fill. Subtracting 16 from the indices for each row makes the
+// indices of earlier rows negative, which pshufb turns into 0, so XORing the
+// lookups together leaves just the entry from each index's own row.
+//
+// Indices from 64 to 127 give the entry in the last of the 4 rows with the
+// same low nybble, so the second 4 rows are looked up separately with 64
+// subtracted from the indices. Indices of 128 and above give unspecified
+// results.
+ENCODING_TARGET("ssse3")
+static __m128i
+lookup_rows_ssse3(const __m128i rows[4], const __m128i indices)
+{
+	const __m128i index1 = _mm_sub_epi8(indices, _mm_set1_epi8(16));
+	const __m128i index2 = _mm_sub_epi8(indices, _mm_set1_epi8(32));
+	const __m128i index3 = _mm_sub_epi8(indices, _mm_set1_epi8(48));
+
+	const __m128i row01 = _mm_xor_si128(_mm_shuffle_epi8(rows[0], indices),
+			_mm_shuffle_epi8(rows[1], index1));
+	const __m128i row23 = _mm_xor_si128(_mm_shuffle_epi8(rows[2], index2),
+			_mm_shuffle_epi8(rows[3], index3));
+	return _mm_xor_si128(row01, row23);
+}
+
+// Same as lookup_rows_ssse3, but each row is repeated in both 128-bit lanes.
+ENCODING_TARGET("avx2")
+static __m256i
+lookup_rows_avx2(const __m256i rows[4], const __m256i indices)
+{
+	const __m256i index1 = _mm256_sub_epi8(indices, _mm256_set1_epi8(16));
+	const __m256i index2 = _mm256_sub_epi8(indices, _mm256_set1_epi8(32));
+	const __m256i index3 = _mm256_sub_epi8(indices, _mm256_set1_epi8(48));
+
+	const __m256i row01 = _mm256_xor_si256(
+			_mm256_shuffle_epi8(rows[0], indices),
+			_mm256_shuffle_epi8(rows[1], index1));
+	const __m256i row23 = _mm256_xor_si256(
+			_mm256_shuffle_epi8(rows[2], index2),
+			_mm256_shuffle_epi8(rows[3], index3));
+	return _mm256_xor_si256(row01, row23);
+}
+
+// Same as decode_ssse3, but translates each character using lookup, the
+// first 128 entries of the decode table split into rows by lookup_fill.
+// Characters of 0x80 and above are treated as invalid.
+ENCODING_TARGET("ssse3")
+static size_t
+decode_lookup_ssse3(const size_t str_len, const uint8_t* str, uint8_t* out,
+		const uint8_t lookup[128])
+{
+	__m128i rows[8];
+	for (size_t k = 0; k < 8; k += 1) {
+		rows[k] = _mm_loadu_si128((const __m128i*)&lookup[k * 16]);
+	}
+
+	const __m128i sixty_four = _mm_set1_epi8(64);
+
+	size_t i = 0;
+	size_t j = 0;
+	for (; i + 16 <= str_len; i += 16, j += 10) {
+		const __m128i in = _mm_loadu_si128((const __m128i*)(str + i));
+		const __m128i upper = _mm_sub_epi8(in, sixty_four);
+		const __m128i quintets = _mm_xor_si128(
+				lookup_rows_ssse3(rows, in),
+				lookup_rows_ssse3(&rows[4], upper));
+
+		// Invalid characters, and the unspecified results for bytes
+		// of 0x80 and above, are caught by the high bit.
+		if (UNLIKELY(_mm_movemask_epi8(_mm_or_si128(quintets, in)) !=
+				    0)) {
+			break;
+		}
+
+		decode_store_ssse3(out + j, decode_pack_ssse3(quintets));
+	}
+
+	return i;
+}
+
+// Same as decode_lookup_ssse3, but 32 characters at a time.
+ENCODING_TARGET("avx2")
+static size_t
+decode_lookup_avx2(const size_t str_len, const uint8_t* str, uint8_t* out,
+		const uint8_t lookup[128])
+{
+	__m256i rows[8];
+	for (size_t k = 0; k < 8; k += 1) {
+		rows[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128(
+				(const __m128i*)&lookup[k * 16]));
+	}
+
+	const __m256i sixty_four = _mm256_set1_epi8(64);
+
+	size_t i = 0;
+	size_t j = 0;
+	for (; i + 32 <= str_len; i += 32, j += 20) {
+		const __m256i in =
+				_mm256_loadu_si256((const __m256i*)(str + i));
+		const __m256i upper = _mm256_sub_epi8(in, sixty_four);
+		const __m256i quintets = _mm256_xor_si256(
+				lookup_rows_avx2(rows, in),
+				lookup_rows_avx2(&rows[4], upper));
+		if (UNLIKELY(_mm256_movemask_epi8(
+				    _mm256_or_si256(quintets, in)) != 0)) {
+			break;
+		}
+
+		decode_store_avx2(out + j, quintets);
+	}
+
+	return i;
+}
+
+// Decodes as much of str as possible using the best kernel the CPU supports,
+// returning how many characters of str were consumed. This is always a
+// multiple of 8.
+static size_t
+decode_simd(const size_t str_len, const uint8_t* str, uint8_t* out,
+		const struct decode_tables* tables)
+{
+	const struct decode_ranges* ranges = tables->ranges;
+	const uint8_t*              lookup = tables->lookup;
+
+	const int features = encoding_cpu_features();
+
+	size_t i = 0;
+	if (ranges != NULL) {
+		if (features & ENCODING_CPU_AVX2) {
+			i = decode_avx2(str_len, str, out, ranges);
+		}
+
+		if (features & ENCODING_CPU_SSSE3) {
+			i += decode_ssse3(str_len - i, str + i,
+					out + (i / 8 * 5), ranges);
+		}
+	} else if (lookup != NULL) {
+		if (features & ENCODING_CPU_AVX2) {
+			i = decode_lookup_avx2(str_len, str, out, lookup);
+		}
+
+		if (features & ENCODING_CPU_SSSE3) {
+			i += decode_lookup_ssse3(str_len - i, str + i,
+					out + (i / 8 * 5), lookup);
+		}
+	}
+
+	return i;
+}
+#endif // ENCODING_X86_SIMD
+
+// Points tables at the tables for alphabet. Custom alphabets only get a decode
+// table, which is built in custom_decode_table.
+static void
+decode_tables_init(struct decode_tables* tables, const uint8_t alphabet[32],
+		uint8_t custom_decode_table[256])
+{
+	tables->ranges = NULL;
+	tables->lookup = NULL;
+	if (alphabet == base32) {
+		tables->decode = base32_decode_table;
+#if ENCODING_X86_SIMD
+		tables->ranges = &base32_decode_ranges;
+#endif
+	} else if (alphabet == base32hex) {
+		tables->decode = base32hex_decode_table;
+#if ENCODING_X86_SIMD
+		tables->ranges = &base32hex_decode_ranges;
+#endif
+	} else if (alphabet == base32crockford) {
+		tables->decode = base32crockford_decode_table;
+	} else {
+		decode_table_fill(alphabet, custom_decode_table);
+		tables->decode = custom_decode_table;
 	}
 }
 
+// Decodes str, which must be a multiple of 8 characters long, validating
+// each character as it goes.
 static int
-base32crockford_decode(const size_t str_len, const uint8_t* str, uint8_t* out)
-{
-	size_t out_index = 0;
-	for (size_t i = 0; i < str_len; i += 8, out_index += 5) {
-		uint8_t byte1 = alphabet_find(crockford_normalize(str[i + 0]),
-				base32crockford);
-		uint8_t byte2 = alphabet_find(crockford_normalize(str[i + 1]),
-				base32crockford);
-		uint8_t byte3 = alphabet_find(crockford_normalize(str[i + 2]),
-				base32crockford);
-		uint8_t byte4 = alphabet_find(crockford_normalize(str[i + 3]),
-				base32crockford);
-		uint8_t byte5 = alphabet_find(crockford_normalize(str[i + 4]),
-				base32crockford);
-		uint8_t byte6 = alphabet_find(crockford_normalize(str[i + 5]),
-				base32crockford);
-		uint8_t byte7 = alphabet_find(crockford_normalize(str[i + 6]),
-				base32crockford);
-		uint8_t byte8 = alphabet_find(crockford_normalize(str[i + 7]),
-				base32crockford);
-
-		out[out_index]     = (byte1 << 3) | (byte2 >> 2);
-		out[out_index + 1] = ((byte2 & 0x03) << 6) | (byte3 << 1) |
-				     (byte4 >> 4);
-		out[out_index + 2] = (byte4 << 4) | (byte5 >> 1);
-		out[out_index + 3] =
-				(byte5 << 7) | (byte6 << 2) | (byte7 >> 3);
-		out[out_index + 4] = (byte7 << 5) | byte8;
+decode_fast(const size_t str_len, const uint8_t* str,
+		const size_t num_padding_chars, uint8_t* out,
+		const struct decode_tables* tables)
+{
+	const uint8_t* decode_table = tables->decode;
+
+	// The last group is handled separately when it has padding, since it
+	// decodes to less than 5 bytes.
+	const size_t full_len = str_len - (num_padding_chars != 0 ? 8 : 0);
+
+	size_t i = 0;
+#if ENCODING_X86_SIMD
+	i = decode_simd(full_len, str, out, tables);
+#endif
+
+	size_t j = i / 8 * 5;
+	for (; i < full_len; i += 8, j += 5) {
+		const uint8_t byte1 = decode_table[str[i]];
+		const uint8_t byte2 = decode_table[str[i + 1]];
+		const uint8_t byte3 = decode_table[str[i + 2]];
+		const uint8_t byte4 = decode_table[str[i + 3]];
+		const uint8_t byte5 = decode_table[str[i + 4]];
+		const uint8_t byte6 = decode_table[str[i + 5]];
+		const uint8_t byte7 = decode_table[str[i + 6]];
+		const uint8_t byte8 = decode_table[str[i + 7]];
+		if (UNLIKELY((byte1 | byte2 | byte3 | byte4 | byte5 | byte6 |
+					     byte7 | byte8) > 0x1f)) {
+			return ENCODING_INVALID_ARGUMENT;
+		}
+
+		out[j]     = (byte1 << 3) | (byte2 >> 2);
+		out[j + 1] = ((byte2 & 0x03) << 6) | (byte3 << 1) |
+			     (byte4 >> 4);
+		out[j + 2] = (byte4 << 4) | (byte5 >> 1);
+		out[j + 3] = (byte5 << 7) | (byte6 << 2) | (byte7 >> 3);
+		out[j + 4] = (byte7 << 5) | byte8;
+	}
+
+	if (num_padding_chars == 0) {
+		return 0;
+	}
+
+	// The padding characters decode as 0 bits.
+	uint8_t bytes[8] = {0};
+	for (size_t k = 0; k < 8 - num_padding_chars; k += 1) {
+		bytes[k] = decode_table[str[i + k]];
+		if (UNLIKELY(bytes[k] > 0x1f)) {
+			return ENCODING_INVALID_ARGUMENT;
+		}
+	}
+
+	uint8_t tmp[5];
+	tmp[0] = (bytes[0] << 3) | (bytes[1] >> 2);
+	tmp[1] = ((bytes[1] & 0x03) << 6) | (bytes[2] << 1) | (bytes[3] >> 4);
+	tmp[2] = (bytes[3] << 4) | (bytes[4] >> 1);
+	tmp[3] = (bytes[4] << 7) | (bytes[5] << 2) | (bytes[6] >> 3);
+	tmp[4] = (bytes[6] << 5) | bytes[7];
+
+	for (size_t k = 0; k < (8 - num_padding_chars) * 5 / 8; k += 1) {
+		out[j + k] = tmp[k];
 	}
 
 	return 0;
 }
 
-ENCODING_PUBLIC
-int
-base32_decode(const size_t str_len, const uint8_t* str, const size_t out_len,
-		uint8_t* out, const uint8_t alphabet[32])
+// Checks the length and padding of str and the size of out, then decodes str
+// using decode_fast.
+static int
+decode_impl(const size_t str_len, const uint8_t* str, const size_t out_len,
+		uint8_t* out, const struct decode_tables* tables)
 {
-	assert(alphabet != NULL);
-
 	if (UNLIKELY(str_len == 0)) {
 		return 0;
 	}
@@ -470,6 +1160,11 @@ base32_decode(const size_t str_len, const uint8_t* str, const size_t out_len,
 		return ENCODING_INVALID_ARGUMENT;
 	}
 
+	const size_t num_padding_chars = get_num_padding_chars(str_len, str);
+	if (UNLIKELY(!padding_valid(num_padding_chars))) {
+		return ENCODING_INVALID_ARGUMENT;
+	}
+
 	size_t decoded_len = base32_decoded_length(str_len, str);
 	if (UNLIKELY(out_len < decoded_len)) {
 		return ENCODING_BUFFER_TOO_SMALL;
@@ -477,30 +1172,851 @@ base32_decode(const size_t str_len, const uint8_t* str, const size_t out_len,
 
 	assert(out_len == 0 || out != NULL);
 
-	if (alphabet == base32crockford) {
-		return base32crockford_decode(str_len, str, out);
+	return decode_fast(str_len, str, num_padding_chars, out, tables);
+}
+
+ENCODING_PUBLIC
+int
+base32_decode(const size_t str_len, const uint8_t* str, const size_t out_len,
+		uint8_t* out, const uint8_t alphabet[32])
+{
+	assert(alphabet != NULL);
+
+	uint8_t              custom_decode_table[256];
+	struct decode_tables tables;
+	decode_tables_init(&tables, alphabet, custom_decode_table);
+	return decode_impl(str_len, str, out_len, out, &tables);
+}
+
+ENCODING_PUBLIC
+int
+base32_decode_in_place(const size_t str_len, uint8_t* str, size_t* out_len,
+		const uint8_t alphabet[32])
+{
+	if (out_len != NULL) {
+		*out_len = 0;
 	}
 
-	size_t out_index = 0;
-	for (size_t i = 0; i < str_len; i += 8, out_index += 5) {
-		uint8_t byte1 = alphabet_find(str[i + 0], alphabet);
-		uint8_t byte2 = alphabet_find(str[i + 1], alphabet);
-		uint8_t byte3 = alphabet_find(str[i + 2], alphabet);
-		uint8_t byte4 = alphabet_find(str[i + 3], alphabet);
-		uint8_t byte5 = alphabet_find(str[i + 4], alphabet);
-		uint8_t byte6 = alphabet_find(str[i + 5], alphabet);
-		uint8_t byte7 = alphabet_find(str[i + 6], alphabet);
-		uint8_t byte8 = alphabet_find(str[i + 7], alphabet);
+	if (UNLIKELY(str_len == 0)) {
+		return 0;
+	}
+
+	assert(str != NULL);
+
+	// decode_fast reads each group before writing it, and the output is
+	// always behind the input.
+	const size_t decoded_len = base32_decoded_length(str_len, str);
+	int err = base32_decode(str_len, str, str_len, str, alphabet);
+	if (UNLIKELY(err != 0)) {
+		return err;
+	}
+
+	if (out_len != NULL) {
+		*out_len = decoded_len;
+	}
+
+	return 0;
+}
 
-		out[out_index]     = (byte1 << 3) | (byte2 >> 2);
-		out[out_index + 1] = ((byte2 & 0x03) << 6) | (byte3 << 1) |
-				     (byte4 >> 4);
-		out[out_index + 2] = (byte4 << 4) | (byte5 >> 1);
-		out[out_index + 3] =
-				(byte5 << 7) | (byte6 << 2) | (byte7 >> 3);
-		out[out_index + 4] = (byte7 << 5) | byte8;
+// The characters base32crockford_encode uses for check symbols. The first 32
+// are the same as base32crockford.
+static const uint8_t crockford_check_symbols[37] = {
+		// ASCII '0' to '9'
+		0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39,
+		// ASCII 'A' to 'Z', excluding 'I', 'L', 'O', 'U'
+		0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x4a, 0x4b,
+		0x4d, 0x4e, 0x50, 0x51, 0x52, 0x53, 0x54, 0x56, 0x57, 0x58,
+		0x59, 0x5a,
+		// ASCII '*', '~', '$', '=', 'U'
+		0x2a, 0x7e, 0x24, 0x3d, 0x55,
+		//
+};
+
+ENCODING_PUBLIC
+size_t
+base32crockford_encoded_length(const size_t str_len, const bool check)
+{
+	return (str_len * 8 + 4) / 5 + (check ? 1 : 0);
+}
+
+ENCODING_PUBLIC
+int
+base32crockford_encode(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out, const bool check)
+{
+	const size_t encoded_len =
+			base32crockford_encoded_length(str_len, check);
+	if (UNLIKELY(out_len < encoded_len)) {
+		return ENCODING_BUFFER_TOO_SMALL;
+	}
+
+	if (UNLIKELY(encoded_len == 0)) {
+		return 0;
+	}
+
+	assert(str_len == 0 || str != NULL);
+	assert(out != NULL);
+
+	// The whole groups don't need any padding, so they can be encoded
+	// directly into out. The last group is encoded on its own, without
+	// its padding.
+	const size_t full_len   = str_len / 5 * 5;
+	const size_t data_chars = encoded_len - (check ? 1 : 0);
+	int err = base32_encode(full_len, str, out_len, out, base32crockford);
+	assert(err == 0);
+
+	if (full_len != str_len) {
+		uint8_t last[8];
+		err = base32_encode(str_len - full_len, &str[full_len],
+				sizeof(last), last, base32crockford);
+		assert(err == 0);
+
+		for (size_t i = full_len / 5 * 8; i < data_chars; i += 1) {
+			out[i] = last[i - full_len / 5 * 8];
+		}
+	}
+
+	(void)err;
+	if (!check) {
+		return 0;
+	}
+
+	// The check symbol is the value of the whole encoded number modulo 37.
+	uint32_t remainder = 0;
+	for (size_t i = 0; i < data_chars; i += 1) {
+		const uint8_t value = base32crockford_decode_table[out[i]];
+		remainder           = (remainder * 32 + value) % 37;
+	}
+
+	out[data_chars] = crockford_check_symbols[remainder];
+	return 0;
+}
+
+ENCODING_PUBLIC
+int
+base32crockford_decode(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out, const bool check,
+		size_t* written)
+{
+	if (written != NULL) {
+		*written = 0;
+	}
+
+	assert(str_len == 0 || str != NULL);
+
+	// Find where the data ends, which is either at the check symbol or at
+	// the padding.
+	size_t data_len = str_len;
+	while (data_len > 0 &&
+			base32crockford_decode_table[str[data_len - 1]] ==
+					BASE32_HYPHEN) {
+		data_len -= 1;
+	}
+
+	uint8_t check_value = 0;
+	size_t  num_padding = 0;
+	if (check) {
+		if (UNLIKELY(data_len == 0)) {
+			return ENCODING_INVALID_ARGUMENT;
+		}
+
+		data_len -= 1;
+		check_value = base32crockford_decode_table[str[data_len]];
+		if (UNLIKELY(check_value > 36)) {
+			return ENCODING_INVALID_ARGUMENT;
+		}
+	} else {
+		while (data_len > 0 && str[data_len - 1] == BASE32_PAD) {
+			data_len -= 1;
+			num_padding += 1;
+		}
+	}
+
+	uint32_t bits      = 0;
+	size_t   num_bits  = 0;
+	size_t   num_chars = 0;
+	uint32_t remainder = 0;
+	size_t   j         = 0;
+	for (size_t i = 0; i < data_len; i += 1) {
+		const uint8_t value = base32crockford_decode_table[str[i]];
+		if (value == BASE32_HYPHEN) {
+			continue;
+		}
+
+		if (UNLIKELY(value > 0x1f)) {
+			return ENCODING_INVALID_ARGUMENT;
+		}
+
+		bits = bits << 5 | value;
+		num_bits += 5;
+		num_chars += 1;
+		if (check) {
+			remainder = (remainder * 32 + value) % 37;
+		}
+
+		if (num_bits >= 8) {
+			if (UNLIKELY(j == out_len)) {
+				return ENCODING_BUFFER_TOO_SMALL;
+			}
+
+			num_bits -= 8;
+			out[j] = (uint8_t)(bits >> num_bits);
+			j += 1;
+		}
+	}
+
+	// A group can't end after 1, 3 or 6 characters, since that leaves
+	// more than 4 bits over, and padding has to fill the last group.
+	const size_t group_len = num_chars % 8;
+	if (UNLIKELY(group_len == 1 || group_len == 3 || group_len == 6)) {
+		return ENCODING_INVALID_ARGUMENT;
+	}
+
+	if (UNLIKELY(num_padding != 0 && (group_len + num_padding) != 8)) {
+		return ENCODING_INVALID_ARGUMENT;
+	}
+
+	if (UNLIKELY(check && remainder != check_value)) {
+		return ENCODING_INVALID_ARGUMENT;
+	}
+
+	if (written != NULL) {
+		*written = j;
+	}
+
+	return 0;
+}
+
+ENCODING_PUBLIC
+void
+base32crockford_ulid_encode(const uint8_t ulid[16], uint8_t out[26])
+{
+	assert(ulid != NULL);
+	assert(out != NULL);
+
+	uint64_t hi = 0;
+	uint64_t lo = 0;
+	for (size_t i = 0; i < 8; i += 1) {
+		hi = hi << 8 | ulid[i];
+		lo = lo << 8 | ulid[i + 8];
+	}
+
+	// A ULID is a 128-bit big endian number, so the first character only
+	// holds 3 bits. Working from the end, each character takes the lowest
+	// 5 bits left.
+	for (size_t i = 26; i > 0; i -= 1) {
+		out[i - 1] = base32crockford[lo & 0x1f];
+		lo         = lo >> 5 | hi << 59;
+		hi >>= 5;
+	}
+}
+
+ENCODING_PUBLIC
+int
+base32crockford_ulid_decode(const uint8_t str[26], uint8_t out[16])
+{
+	assert(str != NULL);
+	assert(out != NULL);
+
+	uint64_t hi      = 0;
+	uint64_t lo      = 0;
+	uint8_t  invalid = 0;
+	for (size_t i = 0; i < 26; i += 1) {
+		const uint8_t value = base32crockford_decode_table[str[i]];
+		invalid |= value;
+		hi = hi << 5 | lo >> 59;
+		lo = lo << 5 | (value & 0x1f);
+	}
+
+	// The first character can only hold 3 bits.
+	const uint8_t first = base32crockford_decode_table[str[0]];
+	if (UNLIKELY(invalid > 0x1f || first > 7)) {
+		return ENCODING_INVALID_ARGUMENT;
+	}
+
+	for (size_t i = 8; i > 0; i -= 1) {
+		out[i - 1] = (uint8_t)hi;
+		out[i + 7] = (uint8_t)lo;
+		hi >>= 8;
+		lo >>= 8;
+	}
+
+	return 0;
+}
+
+// The state shared by the tasks of base32_encode_parallel and
+// base32_decode_parallel. Task i handles the chunk_len bytes or characters of
+// str starting at i * chunk_len.
+struct parallel_job {
+	size_t         str_len;
+	const uint8_t* str;
+	uint8_t*       out;
+	size_t         chunk_len;
+	const uint8_t*       alphabet;
+	struct decode_tables decode;
+	size_t               num_padding_chars;
+	int                  results[PARALLEL_MAX_TASKS];
+};
+
+static void
+encode_task(void* context, size_t index)
+{
+	struct parallel_job* job   = (struct parallel_job*)context;
+	const size_t         start = index * job->chunk_len;
+
+	size_t len = job->str_len - start;
+	if (len > job->chunk_len) {
+		len = job->chunk_len;
+	}
+
+	job->results[index] = base32_encode(len, &job->str[start],
+			base32_encoded_length(len), &job->out[start / 5 * 8],
+			job->alphabet);
+}
+
+ENCODING_PUBLIC
+int
+base32_encode_parallel(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out, const uint8_t alphabet[32],
+		const struct encoding_executor* executor)
+{
+	assert(alphabet != NULL);
+
+	if (executor == NULL) {
+		return base32_encode(str_len, str, out_len, out, alphabet);
+	}
+
+	if (UNLIKELY(str_len == 0)) {
+		return 0;
+	}
+
+	assert(str != NULL);
+
+	if (UNLIKELY(out_len < base32_encoded_length(str_len))) {
+		return ENCODING_BUFFER_TOO_SMALL;
+	}
+
+	assert(out != NULL);
+
+	// Every chunk but the last is a multiple of 5 bytes long, so only the
+	// last one is padded.
+	struct parallel_job job;
+	job.str_len           = str_len;
+	job.str               = str;
+	job.out               = out;
+	job.chunk_len         = parallel_chunk_len(str_len, 5, executor);
+	job.alphabet          = alphabet;
+	job.num_padding_chars = 0;
+
+	const size_t num_tasks = (str_len + job.chunk_len - 1) / job.chunk_len;
+	if (num_tasks == 1) {
+		return base32_encode(str_len, str, out_len, out, alphabet);
+	}
+
+	assert(executor->run != NULL);
+	executor->run(executor->user, num_tasks, encode_task, &job);
+	return parallel_result(num_tasks, job.results);
+}
+
+static void
+decode_task(void* context, size_t index)
+{
+	struct parallel_job* job   = (struct parallel_job*)context;
+	const size_t         start = index * job->chunk_len;
+
+	// Only the last chunk can end in padding.
+	size_t len               = job->str_len - start;
+	size_t num_padding_chars = job->num_padding_chars;
+	if (len > job->chunk_len) {
+		len               = job->chunk_len;
+		num_padding_chars = 0;
+	}
+
+	job->results[index] = decode_fast(len, &job->str[start],
+			num_padding_chars, &job->out[start / 8 * 5],
+			&job->decode);
+}
+
+ENCODING_PUBLIC
+int
+base32_decode_parallel(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out, const uint8_t alphabet[32],
+		const struct encoding_executor* executor)
+{
+	assert(alphabet != NULL);
+
+	if (executor == NULL) {
+		return base32_decode(str_len, str, out_len, out, alphabet);
+	}
+
+	if (UNLIKELY(str_len == 0)) {
+		return 0;
+	}
+
+	assert(str != NULL);
+
+	if (UNLIKELY(str_len % 8 != 0)) {
+		return ENCODING_INVALID_ARGUMENT;
+	}
+
+	const size_t num_padding_chars = get_num_padding_chars(str_len, str);
+	if (UNLIKELY(!padding_valid(num_padding_chars))) {
+		return ENCODING_INVALID_ARGUMENT;
+	}
+
+	if (UNLIKELY(out_len < base32_decoded_length(str_len, str))) {
+		return ENCODING_BUFFER_TOO_SMALL;
+	}
+
+	assert(out_len == 0 || out != NULL);
+
+	uint8_t custom_decode_table[256];
+
+	struct parallel_job job;
+	job.str_len           = str_len;
+	job.str               = str;
+	job.out               = out;
+	job.chunk_len         = parallel_chunk_len(str_len, 8, executor);
+	job.alphabet          = alphabet;
+	job.num_padding_chars = num_padding_chars;
+	decode_tables_init(&job.decode, alphabet, custom_decode_table);
+
+	const size_t num_tasks = (str_len + job.chunk_len - 1) / job.chunk_len;
+	if (num_tasks == 1) {
+		return decode_fast(str_len, str, num_padding_chars, out,
+				&job.decode);
+	}
+
+	assert(executor->run != NULL);
+	executor->run(executor->user, num_tasks, decode_task, &job);
+	return parallel_result(num_tasks, job.results);
+}
+
+// The values of base32_alphabet.builtin.
+#define BUILTIN_NONE      0
+#define BUILTIN_BASE32    1
+#define BUILTIN_BASE32HEX 2
+#define BUILTIN_CROCKFORD 3
+
+static bool
+alphabet_equal(const uint8_t a[32], const uint8_t b[32])
+{
+	bool result = true;
+	for (size_t i = 0; i < 32; i += 1) {
+		result &= a[i] == b[i];
+	}
+
+	return result;
+}
+
+// Returns the provided alphabet which alphabet was compiled from, so their
+// fast paths can be used, or NULL if it was compiled from a custom alphabet.
+static const uint8_t*
+builtin_alphabet(const struct base32_alphabet* alphabet)
+{
+	switch (alphabet->builtin) {
+	case BUILTIN_BASE32:
+		return base32;
+	case BUILTIN_BASE32HEX:
+		return base32hex;
+	case BUILTIN_CROCKFORD:
+		return base32crockford;
+	default:
+		return NULL;
+	}
+}
+
+ENCODING_PUBLIC
+int
+base32_alphabet_compile(
+		const uint8_t alphabet[32], struct base32_alphabet* out)
+{
+	assert(alphabet != NULL);
+	assert(out != NULL);
+
+	decode_table_fill(alphabet, out->decode);
+	for (uint8_t i = 0; i < 32; i += 1) {
+		// If the decode table doesn't map alphabet[i] back to i, then
+		// it appears again later in the alphabet.
+		if (UNLIKELY(alphabet[i] == BASE32_PAD ||
+				    out->decode[alphabet[i]] != i)) {
+			return ENCODING_INVALID_ARGUMENT;
+		}
+
+		out->encode[i] = alphabet[i];
+	}
+
+	lookup_fill(out->decode, 8, out->decode_lookup);
+	out->decode_ranges = decode_ranges_fill(alphabet, out->decode_first,
+			out->decode_last, out->decode_value);
+
+	out->builtin = BUILTIN_NONE;
+	if (alphabet_equal(alphabet, base32)) {
+		out->builtin = BUILTIN_BASE32;
+	} else if (alphabet_equal(alphabet, base32hex)) {
+		out->builtin = BUILTIN_BASE32HEX;
+	} else if (alphabet_equal(alphabet, base32crockford)) {
+		out->builtin = BUILTIN_CROCKFORD;
+	}
+
+	return 0;
+}
+
+ENCODING_PUBLIC
+bool
+base32_valid_compiled(const size_t str_len, const uint8_t* str,
+		const struct base32_alphabet* alphabet)
+{
+	if (UNLIKELY(alphabet == NULL)) {
+		return false;
+	}
+
+	const uint8_t* builtin = builtin_alphabet(alphabet);
+	if (builtin != NULL) {
+		return base32_valid(str_len, str, builtin);
+	}
+
+	if (UNLIKELY(str_len == 0)) {
+		return true;
+	}
+
+	if (UNLIKELY(str == NULL)) {
+		return false;
+	}
+
+	size_t num_padding_chars = get_num_padding_chars(str_len, str);
+	if (UNLIKELY(!padding_valid(num_padding_chars) || str_len % 8 != 0)) {
+		return false;
+	}
+
+	if (alphabet->decode_ranges) {
+		return valid_fast(str_len, str, num_padding_chars,
+				alphabet->decode_first[0],
+				alphabet->decode_last[0],
+				alphabet->decode_first[1],
+				alphabet->decode_last[1]);
+	}
+
+	return valid_table(str_len - num_padding_chars, str, alphabet->decode);
+}
+
+ENCODING_PUBLIC
+int
+base32_encode_compiled(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out,
+		const struct base32_alphabet* alphabet)
+{
+	assert(alphabet != NULL);
+
+	const uint8_t* builtin = builtin_alphabet(alphabet);
+	if (builtin != NULL) {
+		return base32_encode(str_len, str, out_len, out, builtin);
+	}
+
+	return base32_encode(str_len, str, out_len, out, alphabet->encode);
+}
+
+ENCODING_PUBLIC
+int
+base32_decode_compiled(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out,
+		const struct base32_alphabet* alphabet)
+{
+	assert(alphabet != NULL);
+
+	const uint8_t* builtin = builtin_alphabet(alphabet);
+	if (builtin != NULL) {
+		return base32_decode(str_len, str, out_len, out, builtin);
+	}
+
+	struct decode_tables tables;
+	tables.decode = alphabet->decode;
+	tables.ranges = NULL;
+	tables.lookup = alphabet->decode_lookup;
+
+#if ENCODING_X86_SIMD
+	struct decode_ranges ranges;
+	if (alphabet->decode_ranges) {
+		for (size_t i = 0; i < 2; i += 1) {
+			ranges.first[i] = alphabet->decode_first[i];
+			ranges.last[i]  = alphabet->decode_last[i];
+			ranges.value[i] = alphabet->decode_value[i];
+		}
+
+		tables.ranges = &ranges;
+	}
+#endif
+
+	return decode_impl(str_len, str, out_len, out, &tables);
+}
+
+ENCODING_PUBLIC
+void
+base32_encoder_init(
+		struct base32_encoder* encoder, const uint8_t alphabet[32])
+{
+	assert(encoder != NULL);
+	assert(alphabet != NULL);
+
+	encoder->alphabet   = alphabet;
+	encoder->buffer_len = 0;
+}
+
+ENCODING_PUBLIC
+size_t
+base32_encoder_update_length(
+		const struct base32_encoder* encoder, const size_t str_len)
+{
+	assert(encoder != NULL);
+
+	return (encoder->buffer_len + str_len) / 5 * 8;
+}
+
+ENCODING_PUBLIC
+int
+base32_encoder_update(struct base32_encoder* encoder, const size_t str_len,
+		const uint8_t* str, const size_t out_len, uint8_t* out,
+		size_t* written)
+{
+	assert(encoder != NULL);
+
+	if (written != NULL) {
+		*written = 0;
+	}
+
+	if (UNLIKELY(str_len == 0)) {
+		return 0;
+	}
+
+	assert(str != NULL);
+
+	const size_t encoded_len =
+			base32_encoder_update_length(encoder, str_len);
+	if (UNLIKELY(out_len < encoded_len)) {
+		return ENCODING_BUFFER_TOO_SMALL;
+	}
+
+	assert(encoded_len == 0 || out != NULL);
+
+	// Complete the bytes left over from the last call first.
+	size_t i = 0;
+	size_t j = 0;
+	if (encoder->buffer_len != 0) {
+		while (encoder->buffer_len < 5 && i < str_len) {
+			encoder->buffer[encoder->buffer_len] = str[i];
+			encoder->buffer_len += 1;
+			i += 1;
+		}
+
+		if (encoder->buffer_len < 5) {
+			return 0;
+		}
+
+		(void)base32_encode(
+				5, encoder->buffer, 8, out, encoder->alphabet);
+		encoder->buffer_len = 0;
+		j                   = 8;
+	}
+
+	// Then encode the whole groups directly from str into out.
+	const size_t len = (str_len - i) / 5 * 5;
+	(void)base32_encode(len, &str[i], out_len - j, &out[j],
+			encoder->alphabet);
+	i += len;
+	j += len / 5 * 8;
+
+	for (; i < str_len; i += 1) {
+		encoder->buffer[encoder->buffer_len] = str[i];
+		encoder->buffer_len += 1;
+	}
+
+	if (written != NULL) {
+		*written = j;
+	}
+
+	return 0;
+}
+
+ENCODING_PUBLIC
+int
+base32_encoder_final(struct base32_encoder* encoder, const size_t out_len,
+		uint8_t* out, size_t* written)
+{
+	assert(encoder != NULL);
+
+	if (written != NULL) {
+		*written = 0;
+	}
+
+	const size_t encoded_len = base32_encoded_length(encoder->buffer_len);
+	if (UNLIKELY(out_len < encoded_len)) {
+		return ENCODING_BUFFER_TOO_SMALL;
+	}
+
+	(void)base32_encode(encoder->buffer_len, encoder->buffer, out_len, out,
+			encoder->alphabet);
+	encoder->buffer_len = 0;
+
+	if (written != NULL) {
+		*written = encoded_len;
+	}
+
+	return 0;
+}
+
+ENCODING_PUBLIC
+void
+base32_decoder_init(
+		struct base32_decoder* decoder, const uint8_t alphabet[32])
+{
+	assert(decoder != NULL);
+	assert(alphabet != NULL);
+
+	decoder->alphabet   = alphabet;
+	decoder->buffer_len = 0;
+	decoder->finished   = 0;
+}
+
+ENCODING_PUBLIC
+size_t
+base32_decoder_update_length(const struct base32_decoder* decoder,
+		const size_t str_len, const uint8_t* str)
+{
+	assert(decoder != NULL);
+
+	const size_t total_len = decoder->buffer_len + str_len;
+	const size_t end       = total_len / 8 * 8;
+
+	// Only the last complete group can have padding, which doesn't decode
+	// to anything.
+	size_t num_padding_chars = 0;
+	for (size_t i = end; i != 0 && i + 8 > end; i -= 1) {
+		const size_t k = i - 1;
+		uint8_t      c;
+		if (k < decoder->buffer_len) {
+			c = decoder->buffer[k];
+		} else {
+			c = str[k - decoder->buffer_len];
+		}
+
+		if (c != BASE32_PAD) {
+			break;
+		}
+
+		num_padding_chars += 1;
+	}
+
+	return (end - num_padding_chars) * 5 / 8;
+}
+
+ENCODING_PUBLIC
+int
+base32_decoder_update(struct base32_decoder* decoder, const size_t str_len,
+		const uint8_t* str, const size_t out_len, uint8_t* out,
+		size_t* written)
+{
+	assert(decoder != NULL);
+
+	if (written != NULL) {
+		*written = 0;
+	}
+
+	if (UNLIKELY(str_len == 0)) {
+		return 0;
+	}
+
+	assert(str != NULL);
+
+	// Nothing may follow the padding.
+	if (UNLIKELY(decoder->finished)) {
+		return ENCODING_INVALID_ARGUMENT;
+	}
+
+	const size_t decoded_len =
+			base32_decoder_update_length(decoder, str_len, str);
+	if (UNLIKELY(out_len < decoded_len)) {
+		return ENCODING_BUFFER_TOO_SMALL;
+	}
+
+	assert(decoded_len == 0 || out != NULL);
+
+	// Complete the characters left over from the last call first.
+	size_t i = 0;
+	size_t j = 0;
+	if (decoder->buffer_len != 0) {
+		while (decoder->buffer_len < 8 && i < str_len) {
+			decoder->buffer[decoder->buffer_len] = str[i];
+			decoder->buffer_len += 1;
+			i += 1;
+		}
+
+		if (decoder->buffer_len < 8) {
+			return 0;
+		}
+
+		int err = base32_decode(
+				8, decoder->buffer, 5, out, decoder->alphabet);
+		if (UNLIKELY(err != 0)) {
+			return err;
+		}
+
+		j = base32_decoded_length(8, decoder->buffer);
+		decoder->buffer_len = 0;
+		decoder->finished   = decoder->buffer[7] == BASE32_PAD;
+		if (UNLIKELY(decoder->finished && i != str_len)) {
+			return ENCODING_INVALID_ARGUMENT;
+		}
+	}
+
+	// Then decode the whole groups directly from str into out. Padding
+	// anywhere but the end of them is rejected by base32_decode.
+	const size_t len = (str_len - i) / 8 * 8;
+	if (len != 0) {
+		int err = base32_decode(len, &str[i], out_len - j, &out[j],
+				decoder->alphabet);
+		if (UNLIKELY(err != 0)) {
+			return err;
+		}
+
+		j += base32_decoded_length(len, &str[i]);
+		i += len;
+		decoder->finished = str[i - 1] == BASE32_PAD;
+		if (UNLIKELY(decoder->finished && i != str_len)) {
+			return ENCODING_INVALID_ARGUMENT;
+		}
+	}
+
+	for (; i < str_len; i += 1) {
+		decoder->buffer[decoder->buffer_len] = str[i];
+		decoder->buffer_len += 1;
+	}
+
+	if (written != NULL) {
+		*written = j;
+	}
+
+	return 0;
+}
+
+ENCODING_PUBLIC
+int
+base32_decoder_final(struct base32_decoder* decoder, const size_t out_len,
+		uint8_t* out, size_t* written)
+{
+	assert(decoder != NULL);
+
+	// Padding is required, so every group has already been decoded.
+	(void)out_len;
+	(void)out;
+	if (written != NULL) {
+		*written = 0;
+	}
+
+	if (UNLIKELY(decoder->buffer_len != 0)) {
+		return ENCODING_INVALID_ARGUMENT;
 	}
 
+	decoder->finished = 0;
 	return 0;
 }
 
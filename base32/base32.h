@@ -14,6 +14,11 @@
 // an alternative alphabet meant for human consumption and input, called
 // base32crockford. The decoder for base32crockford is more forgiving.
 //
+// Custom alphabets are slower to use than the provided ones, since their
+// lookup tables have to be built on each call. If the same custom alphabet is
+// used repeatedly, compile it once using base32_alphabet_compile and use the
+// *_compiled functions instead.
+//
 // RFC 4648 is included in the doc/ subdirectory of the source distribution,
 // but can also be found at: https://datatracker.ietf.org/doc/html/rfc4648
 
@@ -37,6 +42,26 @@
 extern "C" {
 #endif
 
+#if !defined(ENCODING_EXECUTOR)
+#define ENCODING_EXECUTOR
+
+// encoding_executor describes how the *_parallel functions should run their
+// work, so that they can use whatever threads the caller already has instead
+// of the library starting its own.
+//
+// run must call task(context, i) once for every i from 0 to count - 1,
+// possibly concurrently, and only return once every call has returned. user
+// is passed to run unchanged. The input is split into at most concurrency
+// tasks, so it should usually be the number of threads available.
+struct encoding_executor {
+	void (*run)(void* user, size_t count,
+			void (*task)(void* context, size_t index),
+			void* context);
+	void*  user;
+	size_t concurrency;
+};
+#endif // !defined(ENCODING_EXECUTOR)
+
 // The alphabet for the "base32" encoding specified in RFC 4648.
 ENCODING_PUBLIC
 extern const uint8_t base32[32];
@@ -102,6 +127,302 @@ int base32_decode(const size_t str_len, const uint8_t* str,
 		const size_t out_len, uint8_t* out,
 		const uint8_t alphabet[32]);
 
+// base32_decode_in_place decodes the str_len bytes of str as base32 like
+// base32_decode, writing the decoded data over the start of str. If out_len
+// is not NULL, *out_len is set to the length of the decoded data.
+//
+// str must not be NULL unless str_len is 0.
+//
+// On success, returns 0.
+// On failure, returns one of the following negative error codes:
+//
+// ENCODING_INVALID_ARGUMENT
+//	str was not valid base32. The contents of str are unspecified.
+ENCODING_PUBLIC
+int base32_decode_in_place(const size_t str_len, uint8_t* str,
+		size_t* out_len, const uint8_t alphabet[32]);
+
+// base32crockford_encoded_length returns the length of str_len bytes encoded
+// by base32crockford_encode, including the check symbol if check is true.
+ENCODING_PUBLIC
+size_t base32crockford_encoded_length(const size_t str_len, const bool check);
+
+// base32crockford_encode encodes str using base32crockford without padding,
+// reading at most str_len bytes from str and writing at most out_len bytes to
+// out. If check is true, a check symbol is appended, which is the value of
+// the encoded symbols modulo 37 written using base32crockford followed by
+// '*', '~', '$', '=' and 'U'.
+//
+// out must not be NULL unless the encoded length is 0. str must not be NULL
+// unless str_len is 0.
+//
+// On success, returns 0.
+// On failure, returns one of the following negative error codes:
+//
+// ENCODING_BUFFER_TOO_SMALL
+//	out_len was too small to encode the input data. To find out how large
+//	the output buffer should be, call base32crockford_encoded_length.
+ENCODING_PUBLIC
+int base32crockford_encode(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out, const bool check);
+
+// base32crockford_decode decodes str as Crockford's base32 in a single pass,
+// reading at most str_len bytes from str and writing at most out_len bytes to
+// out. Lowercase letters are accepted, 'I' and 'L' are read as '1', 'O' is
+// read as '0' and hyphens are ignored. If check is true, the last symbol
+// must be the check symbol written by base32crockford_encode. Otherwise, the
+// input may end with '=' padding. If written is not NULL, *written is set to
+// the number of bytes written to out.
+//
+// str must not be NULL unless str_len is 0.
+//
+// On success, returns 0.
+// On failure, returns one of the following negative error codes:
+//
+// ENCODING_BUFFER_TOO_SMALL
+//	out_len was too small to decode the input into. The decoded length is
+//	at most base32_decoded_length(str_len, str).
+//
+// ENCODING_INVALID_ARGUMENT
+//	str was not valid Crockford base32, or its check symbol didn't match.
+ENCODING_PUBLIC
+int base32crockford_decode(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out, const bool check,
+		size_t* written);
+
+// base32crockford_ulid_encode writes the 128-bit big endian ULID in ulid to
+// out as its 26 character string form.
+//
+// ulid and out must not be NULL.
+ENCODING_PUBLIC
+void base32crockford_ulid_encode(const uint8_t ulid[16], uint8_t out[26]);
+
+// base32crockford_ulid_decode reads the 26 character ULID string str into out
+// as a 128-bit big endian number. The same characters are accepted as by
+// base32crockford_decode, except for hyphens.
+//
+// str and out must not be NULL.
+//
+// On success, returns 0.
+// On failure, returns one of the following negative error codes:
+//
+// ENCODING_INVALID_ARGUMENT
+//	str was not a valid ULID, or its value didn't fit in 128 bits.
+ENCODING_PUBLIC
+int base32crockford_ulid_decode(const uint8_t str[26], uint8_t out[16]);
+
+// base32_encode_parallel is the same as base32_encode, but splits the input
+// into chunks which are encoded concurrently using executor. The output is
+// identical to base32_encode's. If executor is NULL, or the input is too
+// small to be worth splitting, the input is encoded on the calling thread.
+ENCODING_PUBLIC
+int base32_encode_parallel(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out,
+		const uint8_t alphabet[32],
+		const struct encoding_executor* executor);
+
+// base32_decode_parallel is the same as base32_decode, but splits the input
+// into chunks which are decoded concurrently using executor. If executor is
+// NULL, or the input is too small to be worth splitting, the input is decoded
+// on the calling thread.
+ENCODING_PUBLIC
+int base32_decode_parallel(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out,
+		const uint8_t alphabet[32],
+		const struct encoding_executor* executor);
+
+// base32_alphabet is an alphabet which has been compiled by
+// base32_alphabet_compile into lookup tables, so that they don't need to be
+// built again for each call. A compiled provided alphabet is as fast as
+// passing the alphabet itself.
+//
+// Custom alphabets encode as fast as the provided ones. Those made of at most
+// two ranges of consecutive ASCII characters, like base32 and base32hex, also
+// decode and validate as fast. Other alphabets are decoded by a slower SIMD
+// implementation, and a few times slower than that if they contain bytes of
+// 0x80 and above, which it can't decode.
+//
+// Its members should be considered private.
+struct base32_alphabet {
+	uint8_t encode[32];
+	uint8_t decode[256];
+	uint8_t decode_lookup[128];
+	uint8_t decode_first[2];
+	uint8_t decode_last[2];
+	uint8_t decode_value[2];
+	bool    decode_ranges;
+	uint8_t builtin;
+};
+
+// base32_alphabet_compile compiles alphabet into out. The result can then be
+// passed to base32_valid_compiled, base32_encode_compiled and
+// base32_decode_compiled for as long as needed. Compiling base32crockford
+// keeps its more forgiving decoder.
+//
+// alphabet and out must not be NULL.
+//
+// On success, returns 0.
+// On failure, returns one of the following negative error codes:
+//
+// ENCODING_INVALID_ARGUMENT
+//	alphabet contains the same byte more than once, or contains the padding
+//	character '='.
+ENCODING_PUBLIC
+int base32_alphabet_compile(
+		const uint8_t alphabet[32], struct base32_alphabet* out);
+
+// base32_valid_compiled is the same as base32_valid, but uses an alphabet
+// compiled by base32_alphabet_compile.
+ENCODING_PUBLIC
+bool base32_valid_compiled(const size_t str_len, const uint8_t* str,
+		const struct base32_alphabet* alphabet);
+
+// base32_encode_compiled is the same as base32_encode, but uses an alphabet
+// compiled by base32_alphabet_compile.
+ENCODING_PUBLIC
+int base32_encode_compiled(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out,
+		const struct base32_alphabet* alphabet);
+
+// base32_decode_compiled is the same as base32_decode, but uses an alphabet
+// compiled by base32_alphabet_compile.
+ENCODING_PUBLIC
+int base32_decode_compiled(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out,
+		const struct base32_alphabet* alphabet);
+
+// base32_encoder holds the state needed to encode data which arrives in
+// chunks of any size, such as reads from a socket. Each chunk is encoded
+// directly into the output buffer, except for up to 4 bytes which are kept
+// until the next call.
+//
+// Its members should be considered private.
+struct base32_encoder {
+	const uint8_t* alphabet;
+	uint8_t        buffer[5];
+	uint8_t        buffer_len;
+};
+
+// base32_encoder_init initializes encoder to encode using alphabet.
+// alphabet must remain valid until encoding is finished.
+//
+// encoder and alphabet must not be NULL.
+ENCODING_PUBLIC
+void base32_encoder_init(
+		struct base32_encoder* encoder, const uint8_t alphabet[32]);
+
+// base32_encoder_update_length returns the number of bytes
+// base32_encoder_update will write when given str_len bytes.
+//
+// encoder must not be NULL.
+ENCODING_PUBLIC
+size_t base32_encoder_update_length(
+		const struct base32_encoder* encoder, const size_t str_len);
+
+// base32_encoder_update encodes the next str_len bytes of str into base32,
+// writing at most out_len bytes to out. If written is not NULL, *written is
+// set to the number of bytes written to out.
+//
+// encoder must not be NULL. str must not be NULL unless str_len is 0.
+//
+// On success, returns 0.
+// On failure, returns one of the following negative error codes:
+//
+// ENCODING_BUFFER_TOO_SMALL
+//	out_len was too small to encode the input data into. To find out how
+//	large the output buffer should be, call base32_encoder_update_length.
+//	Nothing is consumed from str.
+ENCODING_PUBLIC
+int base32_encoder_update(struct base32_encoder* encoder,
+		const size_t str_len, const uint8_t* str, const size_t out_len,
+		uint8_t* out, size_t* written);
+
+// base32_encoder_final encodes the bytes left over from the previous calls
+// to base32_encoder_update along with the padding, writing at most 8 bytes
+// to out. If written is not NULL, *written is set to the number of bytes
+// written to out. Afterwards, encoder can be used to encode new data with the
+// same alphabet.
+//
+// encoder must not be NULL.
+//
+// On success, returns 0.
+// On failure, returns one of the following negative error codes:
+//
+// ENCODING_BUFFER_TOO_SMALL
+//	out_len was too small to encode the remaining data into. An out_len of
+//	8 is always enough.
+ENCODING_PUBLIC
+int base32_encoder_final(struct base32_encoder* encoder,
+		const size_t out_len, uint8_t* out, size_t* written);
+
+// base32_decoder holds the state needed to decode base32 which arrives in
+// chunks of any size. Each chunk is decoded directly into the output buffer,
+// except for up to 7 characters which are kept until the next call.
+//
+// Its members should be considered private.
+struct base32_decoder {
+	const uint8_t* alphabet;
+	uint8_t        buffer[8];
+	uint8_t        buffer_len;
+	uint8_t        finished;
+};
+
+// base32_decoder_init initializes decoder to decode using alphabet.
+// alphabet must remain valid until decoding is finished.
+//
+// decoder and alphabet must not be NULL.
+ENCODING_PUBLIC
+void base32_decoder_init(
+		struct base32_decoder* decoder, const uint8_t alphabet[32]);
+
+// base32_decoder_update_length returns the number of bytes
+// base32_decoder_update will write when given the str_len characters in str,
+// if they are valid.
+//
+// decoder must not be NULL. str must not be NULL unless str_len is 0.
+ENCODING_PUBLIC
+size_t base32_decoder_update_length(const struct base32_decoder* decoder,
+		const size_t str_len, const uint8_t* str);
+
+// base32_decoder_update decodes the next str_len characters of str as
+// base32, writing at most out_len bytes to out. If written is not NULL,
+// *written is set to the number of bytes written to out.
+//
+// decoder must not be NULL. str must not be NULL unless str_len is 0.
+//
+// On success, returns 0.
+// On failure, returns one of the following negative error codes:
+//
+// ENCODING_BUFFER_TOO_SMALL
+//	out_len was too small to decode the input into. To find out how large
+//	the output buffer should be, call base32_decoder_update_length.
+//	Nothing is consumed from str.
+//
+// ENCODING_INVALID_ARGUMENT
+//	The input so far was not valid base32, or more input followed the
+//	padding. decoder must be initialized again before being reused.
+ENCODING_PUBLIC
+int base32_decoder_update(struct base32_decoder* decoder,
+		const size_t str_len, const uint8_t* str, const size_t out_len,
+		uint8_t* out, size_t* written);
+
+// base32_decoder_final finishes decoding, checking that the input ended on a
+// complete group. If written is not NULL, *written is set to the number of
+// bytes written to out, which is currently always 0 since padding is
+// required. Afterwards, decoder can be used to decode new data with the same
+// alphabet.
+//
+// decoder must not be NULL.
+//
+// On success, returns 0.
+// On failure, returns one of the following negative error codes:
+//
+// ENCODING_INVALID_ARGUMENT
+//	The input ended part way through a group.
+ENCODING_PUBLIC
+int base32_decoder_final(struct base32_decoder* decoder,
+		const size_t out_len, uint8_t* out, size_t* written);
+
 #ifdef __cplusplus
 }
 #endif
@@ -13,6 +13,11 @@
 // base64url for use with the "base64url" encoding defined in
 // RFC 4648.
 //
+// Custom alphabets are slower to use than the provided ones, since their
+// lookup tables have to be built on each call. If the same custom alphabet is
+// used repeatedly, compile it once using base64_alphabet_compile and use the
+// *_compiled functions instead.
+//
 // RFC 4648 is included in the doc/ subdirectory of the source distribution,
 // but can also be found at: https://datatracker.ietf.org/doc/html/rfc4648
 
@@ -36,6 +41,44 @@
 extern "C" {
 #endif
 
+#if !defined(ENCODING_EXECUTOR)
+#define ENCODING_EXECUTOR
+
+// encoding_executor describes how the *_parallel functions should run their
+// work, so that they can use whatever threads the caller already has instead
+// of the library starting its own.
+//
+// run must call task(context, i) once for every i from 0 to count - 1,
+// possibly concurrently, and only return once every call has returned. user
+// is passed to run unchanged. The input is split into at most concurrency
+// tasks, so it should usually be the number of threads available.
+struct encoding_executor {
+	void (*run)(void* user, size_t count,
+			void (*task)(void* context, size_t index),
+			void* context);
+	void*  user;
+	size_t concurrency;
+};
+#endif // !defined(ENCODING_EXECUTOR)
+
+// The values accepted by the padding parameter of the *_with_padding
+// functions.
+//
+// BASE64_PADDING_REQUIRED
+//	Output is padded, and input must be padded. This is how the functions
+//	without a padding parameter behave.
+//
+// BASE64_PADDING_OPTIONAL
+//	Output is padded, and input may or may not be padded. If it is, the
+//	padding must be correct.
+//
+// BASE64_PADDING_FORBIDDEN
+//	Output is not padded, and input must not be padded. This is what JWTs
+//	and most URL tokens use.
+#define BASE64_PADDING_REQUIRED  0
+#define BASE64_PADDING_OPTIONAL  1
+#define BASE64_PADDING_FORBIDDEN 2
+
 // The alphabet for the "base64" encoding specified in RFC 4648.
 ENCODING_PUBLIC
 extern const uint8_t base64[64];
@@ -54,6 +97,20 @@ ENCODING_PUBLIC
 bool base64_valid(const size_t str_len, const uint8_t* str,
 		const uint8_t alphabet[64]);
 
+// base64_encoded_length_with_padding is the same as base64_encoded_length,
+// but for base64_encode_with_padding using the given padding. It returns 0
+// if padding is not one of the BASE64_PADDING_* constants.
+ENCODING_PUBLIC
+size_t base64_encoded_length_with_padding(
+		const size_t str_len, const int padding);
+
+// base64_valid_with_padding is the same as base64_valid, but treats the
+// padding as specified by padding, which is one of the BASE64_PADDING_*
+// constants.
+ENCODING_PUBLIC
+bool base64_valid_with_padding(const size_t str_len, const uint8_t* str,
+		const uint8_t alphabet[64], const int padding);
+
 // base64_encode encodes str into base64, reading at most str_len bytes from
 // str and writing at most out_len bytes to out.
 //
@@ -70,8 +127,49 @@ int base64_encode(const size_t str_len, const uint8_t* str,
 		const size_t out_len, uint8_t* out,
 		const uint8_t alphabet[64]);
 
+// base64_encode_with_padding is the same as base64_encode, but only pads the
+// output if padding is not BASE64_PADDING_FORBIDDEN. To find out how large
+// the output buffer should be, call base64_encoded_length_with_padding.
+//
+// Returns ENCODING_INVALID_ARGUMENT if padding is not one of the
+// BASE64_PADDING_* constants.
+ENCODING_PUBLIC
+int base64_encode_with_padding(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out,
+		const uint8_t alphabet[64], const int padding);
+
+// base64_encoded_length_wrapped returns the size of str_len bytes encoded by
+// base64_encode_wrapped with the given line_len and separator_len.
+ENCODING_PUBLIC
+size_t base64_encoded_length_wrapped(const size_t str_len,
+		const size_t line_len, const size_t separator_len);
+
+// base64_encode_wrapped is the same as base64_encode, but writes the
+// separator_len bytes of separator after every line_len characters of
+// output, except after the last line. For example, MIME uses a line_len of
+// 76 with "\r\n" as the separator, and PEM uses a line_len of 64 with "\n".
+//
+// line_len must be a multiple of 4, so that each line is made up of whole
+// quanta. out and str must not be NULL. separator must not be NULL unless
+// separator_len is 0.
+//
+// On success, returns 0.
+// On failure, returns one of the following negative error codes:
+//
+// ENCODING_INVALID_ARGUMENT
+//	line_len was 0 or not a multiple of 4.
+//
+// ENCODING_BUFFER_TOO_SMALL
+//	out_len was too small to encode the input data. To find out how large
+//	the output buffer should be, call base64_encoded_length_wrapped.
+ENCODING_PUBLIC
+int base64_encode_wrapped(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out,
+		const uint8_t alphabet[64], const size_t line_len,
+		const size_t separator_len, const uint8_t* separator);
+
 // base64_decoded_length gets the length of str decoded as base64. Reads at
-// most str_len bytes from str.
+// most str_len bytes from str. str can be padded or unpadded.
 //
 // str must not be NULL.
 ENCODING_PUBLIC
@@ -80,6 +178,10 @@ size_t base64_decoded_length(const size_t str_len, const uint8_t* str);
 // base64_decode decodes str as base64, reading at most str_len bytes from str
 // and writing at most out_len bytes to out.
 //
+// str is validated while it is decoded, so there is no need to call
+// base64_valid beforehand. If str turns out to be invalid, the contents of out
+// are unspecified.
+//
 // out and str must not be NULL.
 //
 // On success, returns 0.
@@ -96,6 +198,276 @@ int base64_decode(const size_t str_len, const uint8_t* str,
 		const size_t out_len, uint8_t* out,
 		const uint8_t alphabet[64]);
 
+// base64_decode_in_place decodes the str_len bytes of str as base64 like
+// base64_decode, writing the decoded data over the start of str. If out_len
+// is not NULL, *out_len is set to the length of the decoded data.
+//
+// str must not be NULL unless str_len is 0.
+//
+// On success, returns 0.
+// On failure, returns one of the following negative error codes:
+//
+// ENCODING_INVALID_ARGUMENT
+//	str was not valid base64. The contents of str are unspecified.
+ENCODING_PUBLIC
+int base64_decode_in_place(const size_t str_len, uint8_t* str,
+		size_t* out_len, const uint8_t alphabet[64]);
+
+// base64_decode_with_padding is the same as base64_decode, but treats the
+// padding as specified by padding, which is one of the BASE64_PADDING_*
+// constants. Unpadded input whose last quantum has 2 or 3 characters is
+// decoded directly, without needing to be padded first.
+//
+// ENCODING_INVALID_ARGUMENT is also returned if padding isn't one of the
+// BASE64_PADDING_* constants.
+ENCODING_PUBLIC
+int base64_decode_with_padding(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out,
+		const uint8_t alphabet[64], const int padding);
+
+// base64_decode_forgiving decodes str as base64 like base64_decode, but
+// follows the "forgiving-base64 decode" algorithm from the WHATWG Infra
+// Standard, which is what atob() uses. ASCII whitespace anywhere in str is
+// skipped, so line-wrapped MIME and PEM payloads can be decoded as is, and
+// the padding at the end is optional. Reads at most str_len bytes from str
+// and writes at most out_len bytes to out. If written is not NULL, *written
+// is set to the number of bytes written to out.
+//
+// An out_len of (str_len / 4 * 3 + 2) is always enough. alphabet must not
+// contain any whitespace characters.
+//
+// alphabet must not be NULL. str must not be NULL unless str_len is 0.
+//
+// On success, returns 0.
+// On failure, returns one of the following negative error codes:
+//
+// ENCODING_BUFFER_TOO_SMALL
+//	out_len was too small to decode the input into. Part of the output
+//	might have been written.
+//
+// ENCODING_INVALID_ARGUMENT
+//	str was not valid base64. Part of the output might have been written.
+ENCODING_PUBLIC
+int base64_decode_forgiving(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out,
+		const uint8_t alphabet[64], size_t* written);
+
+// base64_encode_parallel is the same as base64_encode, but splits the input
+// into chunks which are encoded concurrently using executor. The output is
+// identical to base64_encode's. If executor is NULL, or the input is too
+// small to be worth splitting, the input is encoded on the calling thread.
+ENCODING_PUBLIC
+int base64_encode_parallel(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out,
+		const uint8_t alphabet[64],
+		const struct encoding_executor* executor);
+
+// base64_decode_parallel is the same as base64_decode, but splits the input
+// into chunks which are decoded concurrently using executor. If executor is
+// NULL, or the input is too small to be worth splitting, the input is decoded
+// on the calling thread.
+ENCODING_PUBLIC
+int base64_decode_parallel(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out,
+		const uint8_t alphabet[64],
+		const struct encoding_executor* executor);
+
+// base64_alphabet is an alphabet which has been compiled by
+// base64_alphabet_compile into lookup tables, so that they don't need to be
+// built again for each call. A compiled base64 or base64url is as fast as
+// passing the alphabet itself. Custom alphabets get their own copies of the
+// tables the provided alphabets use, including the ones for the SIMD
+// implementations, which take up about 13KB.
+//
+// Custom alphabets encode and validate about as fast as the provided ones.
+// Those laid out like base64, such as ones which only change its last two
+// characters, also decode as fast. Other alphabets decode at around two
+// thirds of the speed, or a few times slower if they also contain bytes of
+// 0x80 and above, since the SIMD implementations can't decode those.
+//
+// Its members should be considered private.
+struct base64_alphabet {
+	uint8_t  encode[64];
+	uint8_t  decode[256];
+	uint8_t  encode_lookup[64];
+	uint8_t  decode_lookup[128];
+	uint8_t  decode_lo[16];
+	uint8_t  decode_hi[16];
+	int8_t   decode_roll[16];
+	uint8_t  decode_special;
+	bool     decode_luts;
+	uint16_t encode_pairs[4096];
+	uint32_t decode_shifted[4][256];
+	uint8_t  builtin;
+};
+
+// base64_alphabet_compile compiles alphabet into out. The result can then be
+// passed to base64_valid_compiled, base64_encode_compiled and
+// base64_decode_compiled for as long as needed.
+//
+// alphabet and out must not be NULL.
+//
+// On success, returns 0.
+// On failure, returns one of the following negative error codes:
+//
+// ENCODING_INVALID_ARGUMENT
+//	alphabet contains the same byte more than once, or contains the padding
+//	character '='.
+ENCODING_PUBLIC
+int base64_alphabet_compile(
+		const uint8_t alphabet[64], struct base64_alphabet* out);
+
+// base64_valid_compiled is the same as base64_valid, but uses an alphabet
+// compiled by base64_alphabet_compile.
+ENCODING_PUBLIC
+bool base64_valid_compiled(const size_t str_len, const uint8_t* str,
+		const struct base64_alphabet* alphabet);
+
+// base64_encode_compiled is the same as base64_encode, but uses an alphabet
+// compiled by base64_alphabet_compile.
+ENCODING_PUBLIC
+int base64_encode_compiled(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out,
+		const struct base64_alphabet* alphabet);
+
+// base64_decode_compiled is the same as base64_decode, but uses an alphabet
+// compiled by base64_alphabet_compile.
+ENCODING_PUBLIC
+int base64_decode_compiled(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out,
+		const struct base64_alphabet* alphabet);
+
+// base64_encoder holds the state needed to encode data which arrives in
+// chunks of any size, such as reads from a socket. Each chunk is encoded
+// directly into the output buffer, except for up to 2 bytes which are kept
+// until the next call.
+//
+// Its members should be considered private.
+struct base64_encoder {
+	const uint8_t* alphabet;
+	uint8_t        buffer[3];
+	uint8_t        buffer_len;
+};
+
+// base64_encoder_init initializes encoder to encode using alphabet.
+// alphabet must remain valid until encoding is finished.
+//
+// encoder and alphabet must not be NULL.
+ENCODING_PUBLIC
+void base64_encoder_init(
+		struct base64_encoder* encoder, const uint8_t alphabet[64]);
+
+// base64_encoder_update_length returns the number of bytes
+// base64_encoder_update will write when given str_len bytes.
+//
+// encoder must not be NULL.
+ENCODING_PUBLIC
+size_t base64_encoder_update_length(
+		const struct base64_encoder* encoder, const size_t str_len);
+
+// base64_encoder_update encodes the next str_len bytes of str into base64,
+// writing at most out_len bytes to out. If written is not NULL, *written is
+// set to the number of bytes written to out.
+//
+// encoder must not be NULL. str must not be NULL unless str_len is 0.
+//
+// On success, returns 0.
+// On failure, returns one of the following negative error codes:
+//
+// ENCODING_BUFFER_TOO_SMALL
+//	out_len was too small to encode the input data into. To find out how
+//	large the output buffer should be, call base64_encoder_update_length.
+//	Nothing is consumed from str.
+ENCODING_PUBLIC
+int base64_encoder_update(struct base64_encoder* encoder,
+		const size_t str_len, const uint8_t* str, const size_t out_len,
+		uint8_t* out, size_t* written);
+
+// base64_encoder_final encodes the bytes left over from the previous calls
+// to base64_encoder_update, writing at most 4 bytes to out. If written is not
+// NULL, *written is set to the number of bytes written to out. Afterwards,
+// encoder can be used to encode new data with the same alphabet.
+//
+// encoder must not be NULL.
+//
+// On success, returns 0.
+// On failure, returns one of the following negative error codes:
+//
+// ENCODING_BUFFER_TOO_SMALL
+//	out_len was too small to encode the remaining data into. An out_len of
+//	4 is always enough.
+ENCODING_PUBLIC
+int base64_encoder_final(struct base64_encoder* encoder,
+		const size_t out_len, uint8_t* out, size_t* written);
+
+// base64_decoder holds the state needed to decode base64 which arrives in
+// chunks of any size. Each chunk is decoded directly into the output buffer,
+// except for up to 3 characters which are kept until the next call.
+//
+// Its members should be considered private.
+struct base64_decoder {
+	const uint8_t* alphabet;
+	uint8_t        buffer[4];
+	uint8_t        buffer_len;
+	uint8_t        finished;
+};
+
+// base64_decoder_init initializes decoder to decode using alphabet.
+// alphabet must remain valid until decoding is finished.
+//
+// decoder and alphabet must not be NULL.
+ENCODING_PUBLIC
+void base64_decoder_init(
+		struct base64_decoder* decoder, const uint8_t alphabet[64]);
+
+// base64_decoder_update_length returns the number of bytes
+// base64_decoder_update will write when given the str_len characters in str,
+// if they are valid.
+//
+// decoder must not be NULL. str must not be NULL unless str_len is 0.
+ENCODING_PUBLIC
+size_t base64_decoder_update_length(const struct base64_decoder* decoder,
+		const size_t str_len, const uint8_t* str);
+
+// base64_decoder_update decodes the next str_len characters of str as
+// base64, writing at most out_len bytes to out. If written is not NULL,
+// *written is set to the number of bytes written to out.
+//
+// decoder must not be NULL. str must not be NULL unless str_len is 0.
+//
+// On success, returns 0.
+// On failure, returns one of the following negative error codes:
+//
+// ENCODING_BUFFER_TOO_SMALL
+//	out_len was too small to decode the input into. To find out how large
+//	the output buffer should be, call base64_decoder_update_length.
+//	Nothing is consumed from str.
+//
+// ENCODING_INVALID_ARGUMENT
+//	The input so far was not valid base64, or more input followed the
+//	padding. decoder must be initialized again before being reused.
+ENCODING_PUBLIC
+int base64_decoder_update(struct base64_decoder* decoder,
+		const size_t str_len, const uint8_t* str, const size_t out_len,
+		uint8_t* out, size_t* written);
+
+// base64_decoder_final finishes decoding, checking that the input ended on a
+// complete quantum. If written is not NULL, *written is set to the number of
+// bytes written to out, which is currently always 0 since padding is
+// required. Afterwards, decoder can be used to decode new data with the same
+// alphabet.
+//
+// decoder must not be NULL.
+//
+// On success, returns 0.
+// On failure, returns one of the following negative error codes:
+//
+// ENCODING_INVALID_ARGUMENT
+//	The input ended part way through a quantum.
+ENCODING_PUBLIC
+int base64_decoder_final(struct base64_decoder* decoder,
+		const size_t out_len, uint8_t* out, size_t* written);
+
 #ifdef __cplusplus
 }
 #endif
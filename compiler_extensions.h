@@ -5,6 +5,8 @@
 
 // This file contains commonly implemented extensions which we make use of.
 
+#include <stdint.h>
+
 #if !defined(ENCODING_PUBLIC)
 #define ENCODING_PUBLIC
 #endif
@@ -54,4 +56,72 @@
 #endif // defined(__has_builtin)
 #endif // !defined(UNLIKELY)
 
+// Portable helpers
+
+// Returns a word with the high bit of each byte set if the corresponding byte
+// of x is between lo and hi inclusive, and every other bit clear. Every byte
+// of x must be less than 0x80, so that adding to it never carries into the
+// next byte.
+static inline uint64_t
+swar_between(const uint64_t x, const uint8_t lo, const uint8_t hi)
+{
+	const uint64_t ones = UINT64_C(0x0101010101010101);
+
+	// Adding 0x80 - lo sets the high bit if the byte is at least lo, and
+	// adding 0x7f - hi sets it if the byte is greater than hi.
+	const uint64_t at_least_lo = x + ones * (uint8_t)(0x80 - lo);
+	const uint64_t above_hi    = x + ones * (uint8_t)(0x7f - hi);
+	return at_least_lo & ~above_hi & (ones * 0x80);
+}
+
+// Finding SIMD support
+//
+// On x86-64 when compiling with GCC or Clang, some routines have SSSE3 and
+// AVX2 implementations which are compiled using the target attribute and
+// selected at runtime based on what the CPU supports. The rest of the library
+// is still compiled for the baseline target, so the same binary runs
+// anywhere.
+//
+// Define ENCODING_NO_SIMD to only use the portable implementations, or
+// ENCODING_NO_AVX2 to never use the AVX2 implementations.
+
+#if !defined(ENCODING_X86_SIMD)
+#define ENCODING_X86_SIMD 0
+#if !defined(ENCODING_NO_SIMD) && defined(__x86_64__) &&                      \
+		(defined(__GNUC__) || defined(__clang__))
+#undef ENCODING_X86_SIMD
+#define ENCODING_X86_SIMD 1
+#endif
+#endif // !defined(ENCODING_X86_SIMD)
+
+#if ENCODING_X86_SIMD
+#include <immintrin.h>
+
+#define ENCODING_TARGET(isa) __attribute__((target(isa)))
+
+#define ENCODING_CPU_SSSE3 (1 << 0)
+#define ENCODING_CPU_AVX2  (1 << 1)
+
+// encoding_cpu_features returns a combination of the ENCODING_CPU_* flags
+// describing which instruction set extensions the current CPU supports.
+static inline int
+encoding_cpu_features(void)
+{
+	__builtin_cpu_init();
+
+	int result = 0;
+	if (__builtin_cpu_supports("ssse3")) {
+		result |= ENCODING_CPU_SSSE3;
+	}
+
+#if !defined(ENCODING_NO_AVX2)
+	if (__builtin_cpu_supports("avx2")) {
+		result |= ENCODING_CPU_AVX2;
+	}
+#endif
+
+	return result;
+}
+#endif // ENCODING_X86_SIMD
+
 #endif // COMPILER_EXTENSIONS_H
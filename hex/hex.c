@@ -7,6 +7,7 @@
 #include "../binary/binary.h"
 #include "../compiler_extensions.h"
 #include "./hex.h"
+#include "../parallel.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -22,16 +23,114 @@ const uint8_t hex_chars[] = {
 		//
 };
 
+// Map every byte to the value of the hexadecimal character it is, or 0xff if
+// it isn't one.
+//
 // Generated using tools/gen_hex_char_to_nybble.c
-const uint8_t char_to_nybble[0x67] = {
-		//
-		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-		0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 0, 0, 0, 0,
-		0, 0, 10, 11, 12, 13, 14, 15, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 10, 11, 12, 13,
-		14, 15
-		//
+static const uint8_t char_to_nybble[256] = {
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x01,
+		0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+		0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x0a, 0x0b, 0x0c,
+		0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
+// Map every byte to the two hexadecimal characters it encodes to, with the
+// first character in the low byte.
+//
+// Generated using tools/gen_encode_pair_tables.c
+static const uint16_t hex_encode_pairs[256] = {
+		0x3030, 0x3130, 0x3230, 0x3330, 0x3430, 0x3530, 0x3630, 0x3730,
+		0x3830, 0x3930, 0x6130, 0x6230, 0x6330, 0x6430, 0x6530, 0x6630,
+		0x3031, 0x3131, 0x3231, 0x3331, 0x3431, 0x3531, 0x3631, 0x3731,
+		0x3831, 0x3931, 0x6131, 0x6231, 0x6331, 0x6431, 0x6531, 0x6631,
+		0x3032, 0x3132, 0x3232, 0x3332, 0x3432, 0x3532, 0x3632, 0x3732,
+		0x3832, 0x3932, 0x6132, 0x6232, 0x6332, 0x6432, 0x6532, 0x6632,
+		0x3033, 0x3133, 0x3233, 0x3333, 0x3433, 0x3533, 0x3633, 0x3733,
+		0x3833, 0x3933, 0x6133, 0x6233, 0x6333, 0x6433, 0x6533, 0x6633,
+		0x3034, 0x3134, 0x3234, 0x3334, 0x3434, 0x3534, 0x3634, 0x3734,
+		0x3834, 0x3934, 0x6134, 0x6234, 0x6334, 0x6434, 0x6534, 0x6634,
+		0x3035, 0x3135, 0x3235, 0x3335, 0x3435, 0x3535, 0x3635, 0x3735,
+		0x3835, 0x3935, 0x6135, 0x6235, 0x6335, 0x6435, 0x6535, 0x6635,
+		0x3036, 0x3136, 0x3236, 0x3336, 0x3436, 0x3536, 0x3636, 0x3736,
+		0x3836, 0x3936, 0x6136, 0x6236, 0x6336, 0x6436, 0x6536, 0x6636,
+		0x3037, 0x3137, 0x3237, 0x3337, 0x3437, 0x3537, 0x3637, 0x3737,
+		0x3837, 0x3937, 0x6137, 0x6237, 0x6337, 0x6437, 0x6537, 0x6637,
+		0x3038, 0x3138, 0x3238, 0x3338, 0x3438, 0x3538, 0x3638, 0x3738,
+		0x3838, 0x3938, 0x6138, 0x6238, 0x6338, 0x6438, 0x6538, 0x6638,
+		0x3039, 0x3139, 0x3239, 0x3339, 0x3439, 0x3539, 0x3639, 0x3739,
+		0x3839, 0x3939, 0x6139, 0x6239, 0x6339, 0x6439, 0x6539, 0x6639,
+		0x3061, 0x3161, 0x3261, 0x3361, 0x3461, 0x3561, 0x3661, 0x3761,
+		0x3861, 0x3961, 0x6161, 0x6261, 0x6361, 0x6461, 0x6561, 0x6661,
+		0x3062, 0x3162, 0x3262, 0x3362, 0x3462, 0x3562, 0x3662, 0x3762,
+		0x3862, 0x3962, 0x6162, 0x6262, 0x6362, 0x6462, 0x6562, 0x6662,
+		0x3063, 0x3163, 0x3263, 0x3363, 0x3463, 0x3563, 0x3663, 0x3763,
+		0x3863, 0x3963, 0x6163, 0x6263, 0x6363, 0x6463, 0x6563, 0x6663,
+		0x3064, 0x3164, 0x3264, 0x3364, 0x3464, 0x3564, 0x3664, 0x3764,
+		0x3864, 0x3964, 0x6164, 0x6264, 0x6364, 0x6464, 0x6564, 0x6664,
+		0x3065, 0x3165, 0x3265, 0x3365, 0x3465, 0x3565, 0x3665, 0x3765,
+		0x3865, 0x3965, 0x6165, 0x6265, 0x6365, 0x6465, 0x6565, 0x6665,
+		0x3066, 0x3166, 0x3266, 0x3366, 0x3466, 0x3566, 0x3666, 0x3766,
+		0x3866, 0x3966, 0x6166, 0x6266, 0x6366, 0x6466, 0x6566, 0x6666,
+};
+
+// Same as hex_encode_pairs, but with uppercase letters.
+//
+// Generated using tools/gen_encode_pair_tables.c
+static const uint16_t hex_encode_upper_pairs[256] = {
+		0x3030, 0x3130, 0x3230, 0x3330, 0x3430, 0x3530, 0x3630, 0x3730,
+		0x3830, 0x3930, 0x4130, 0x4230, 0x4330, 0x4430, 0x4530, 0x4630,
+		0x3031, 0x3131, 0x3231, 0x3331, 0x3431, 0x3531, 0x3631, 0x3731,
+		0x3831, 0x3931, 0x4131, 0x4231, 0x4331, 0x4431, 0x4531, 0x4631,
+		0x3032, 0x3132, 0x3232, 0x3332, 0x3432, 0x3532, 0x3632, 0x3732,
+		0x3832, 0x3932, 0x4132, 0x4232, 0x4332, 0x4432, 0x4532, 0x4632,
+		0x3033, 0x3133, 0x3233, 0x3333, 0x3433, 0x3533, 0x3633, 0x3733,
+		0x3833, 0x3933, 0x4133, 0x4233, 0x4333, 0x4433, 0x4533, 0x4633,
+		0x3034, 0x3134, 0x3234, 0x3334, 0x3434, 0x3534, 0x3634, 0x3734,
+		0x3834, 0x3934, 0x4134, 0x4234, 0x4334, 0x4434, 0x4534, 0x4634,
+		0x3035, 0x3135, 0x3235, 0x3335, 0x3435, 0x3535, 0x3635, 0x3735,
+		0x3835, 0x3935, 0x4135, 0x4235, 0x4335, 0x4435, 0x4535, 0x4635,
+		0x3036, 0x3136, 0x3236, 0x3336, 0x3436, 0x3536, 0x3636, 0x3736,
+		0x3836, 0x3936, 0x4136, 0x4236, 0x4336, 0x4436, 0x4536, 0x4636,
+		0x3037, 0x3137, 0x3237, 0x3337, 0x3437, 0x3537, 0x3637, 0x3737,
+		0x3837, 0x3937, 0x4137, 0x4237, 0x4337, 0x4437, 0x4537, 0x4637,
+		0x3038, 0x3138, 0x3238, 0x3338, 0x3438, 0x3538, 0x3638, 0x3738,
+		0x3838, 0x3938, 0x4138, 0x4238, 0x4338, 0x4438, 0x4538, 0x4638,
+		0x3039, 0x3139, 0x3239, 0x3339, 0x3439, 0x3539, 0x3639, 0x3739,
+		0x3839, 0x3939, 0x4139, 0x4239, 0x4339, 0x4439, 0x4539, 0x4639,
+		0x3041, 0x3141, 0x3241, 0x3341, 0x3441, 0x3541, 0x3641, 0x3741,
+		0x3841, 0x3941, 0x4141, 0x4241, 0x4341, 0x4441, 0x4541, 0x4641,
+		0x3042, 0x3142, 0x3242, 0x3342, 0x3442, 0x3542, 0x3642, 0x3742,
+		0x3842, 0x3942, 0x4142, 0x4242, 0x4342, 0x4442, 0x4542, 0x4642,
+		0x3043, 0x3143, 0x3243, 0x3343, 0x3443, 0x3543, 0x3643, 0x3743,
+		0x3843, 0x3943, 0x4143, 0x4243, 0x4343, 0x4443, 0x4543, 0x4643,
+		0x3044, 0x3144, 0x3244, 0x3344, 0x3444, 0x3544, 0x3644, 0x3744,
+		0x3844, 0x3944, 0x4144, 0x4244, 0x4344, 0x4444, 0x4544, 0x4644,
+		0x3045, 0x3145, 0x3245, 0x3345, 0x3445, 0x3545, 0x3645, 0x3745,
+		0x3845, 0x3945, 0x4145, 0x4245, 0x4345, 0x4445, 0x4545, 0x4645,
+		0x3046, 0x3146, 0x3246, 0x3346, 0x3446, 0x3546, 0x3646, 0x3746,
+		0x3846, 0x3946, 0x4146, 0x4246, 0x4346, 0x4446, 0x4546, 0x4646,
 };
 
 ENCODING_PUBLIC
@@ -46,21 +145,36 @@ hex_valid(const size_t str_len, const uint8_t* str)
 		return true;
 	}
 
-	int result = true;
-	for (size_t i = 0; i < str_len; i += 2) {
-		int tmp1 = (str[i] >= 0x30) & (str[i] <= 0x39);
-		int tmp2 = (str[i + 1] >= 0x30) & (str[i + 1] <= 0x39);
+	const uint64_t high_bits = UINT64_C(0x8080808080808080);
+	const uint64_t case_bits = UINT64_C(0x2020202020202020);
 
-		tmp1 |= (str[i] >= 0x41) & (str[i] <= 0x46);
-		tmp2 |= (str[i + 1] >= 0x41) & (str[i + 1] <= 0x46);
+	uint64_t result = high_bits;
+	size_t   i      = 0;
+	for (; i + 8 <= str_len; i += 8) {
+		uint64_t word;
+		binary_uint64_decode(8, &str[i], &word,
+				ENCODING_BYTE_ORDER_LITTLE);
 
-		tmp1 |= (str[i] >= 0x61) & (str[i] <= 0x66);
-		tmp2 |= (str[i + 1] >= 0x61) & (str[i + 1] <= 0x66);
+		// Bytes with their high bit set are never valid. Setting 0x20
+		// makes 'A' to 'F' lowercase, and doesn't turn anything else
+		// into 'a' to 'f'.
+		const uint64_t ascii = word & ~high_bits;
+		const uint64_t lower = ascii | case_bits;
+		const uint64_t valid = swar_between(ascii, 0x30, 0x39) |
+				       swar_between(lower, 0x61, 0x66);
 
-		result &= tmp1 & tmp2;
+		result &= valid & ~word;
 	}
 
-	return result;
+	bool tail = true;
+	for (; i < str_len; i += 1) {
+		const uint8_t c     = str[i];
+		const uint8_t lower = c | 0x20;
+		tail &= ((c >= 0x30) & (c <= 0x39)) |
+			((lower >= 0x61) & (lower <= 0x66));
+	}
+
+	return (result == high_bits) & tail;
 }
 
 ENCODING_PUBLIC
@@ -70,10 +184,109 @@ hex_encoded_length(const size_t len)
 	return len * 2;
 }
 
-ENCODING_PUBLIC
-int
-hex_encode(const size_t str_len, const uint8_t* str, const size_t out_len,
-		uint8_t* out)
+// The digits hex_encode_upper writes. The uppercase letters in hex_chars
+// don't follow the digits, which the SIMD encoders need.
+static const uint8_t hex_upper_digits[16] = {
+		// '0' to '9'
+		0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39,
+		// 'A' to 'F'
+		0x41, 0x42, 0x43, 0x44, 0x45, 0x46,
+		//
+};
+
+#if ENCODING_X86_SIMD
+// The SIMD encoders split each byte into its two nybbles, translate both
+// using a single pshufb lookup into the 16 digits, and then interleave them
+// so that the character for the high nybble comes first.
+
+// Encodes 16 bytes at a time, returning how many bytes of str were consumed.
+ENCODING_TARGET("ssse3")
+static size_t
+encode_ssse3(const size_t str_len, const uint8_t* str, uint8_t* out,
+		const uint8_t digits[16])
+{
+	const __m128i table = _mm_loadu_si128((const __m128i*)digits);
+	const __m128i mask  = _mm_set1_epi8(0x0f);
+
+	size_t i = 0;
+	for (; i + 16 <= str_len; i += 16) {
+		const __m128i in = _mm_loadu_si128((const __m128i*)(str + i));
+		const __m128i hi_nybbles =
+				_mm_and_si128(_mm_srli_epi16(in, 4), mask);
+		const __m128i lo_nybbles = _mm_and_si128(in, mask);
+		const __m128i hi = _mm_shuffle_epi8(table, hi_nybbles);
+		const __m128i lo = _mm_shuffle_epi8(table, lo_nybbles);
+		_mm_storeu_si128((__m128i*)(out + i * 2),
+				_mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128((__m128i*)(out + i * 2 + 16),
+				_mm_unpackhi_epi8(hi, lo));
+	}
+
+	return i;
+}
+
+// Encodes 32 bytes at a time, returning how many bytes of str were consumed.
+ENCODING_TARGET("avx2")
+static size_t
+encode_avx2(const size_t str_len, const uint8_t* str, uint8_t* out,
+		const uint8_t digits[16])
+{
+	const __m256i table = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((const __m128i*)digits));
+	const __m256i mask = _mm256_set1_epi8(0x0f);
+
+	size_t i = 0;
+	for (; i + 32 <= str_len; i += 32) {
+		const __m256i in =
+				_mm256_loadu_si256((const __m256i*)(str + i));
+		const __m256i shifted    = _mm256_srli_epi16(in, 4);
+		const __m256i hi_nybbles = _mm256_and_si256(shifted, mask);
+		const __m256i lo_nybbles = _mm256_and_si256(in, mask);
+		const __m256i hi = _mm256_shuffle_epi8(table, hi_nybbles);
+		const __m256i lo = _mm256_shuffle_epi8(table, lo_nybbles);
+
+		// The unpacks work within each 128-bit lane, so the halves
+		// have to be put back in order.
+		const __m256i first  = _mm256_unpacklo_epi8(hi, lo);
+		const __m256i second = _mm256_unpackhi_epi8(hi, lo);
+		const __m256i out_lo =
+				_mm256_permute2x128_si256(first, second, 0x20);
+		const __m256i out_hi =
+				_mm256_permute2x128_si256(first, second, 0x31);
+		_mm256_storeu_si256((__m256i*)(out + i * 2), out_lo);
+		_mm256_storeu_si256((__m256i*)(out + i * 2 + 32), out_hi);
+	}
+
+	return i;
+}
+
+// Encodes as much of str as possible using the best kernel the CPU supports,
+// returning how many bytes of str were consumed.
+static size_t
+encode_simd(const size_t str_len, const uint8_t* str, uint8_t* out,
+		const uint8_t digits[16])
+{
+	const int features = encoding_cpu_features();
+
+	size_t i = 0;
+	if (features & ENCODING_CPU_AVX2) {
+		i = encode_avx2(str_len, str, out, digits);
+	}
+
+	if (features & ENCODING_CPU_SSSE3) {
+		i += encode_ssse3(str_len - i, str + i, out + i * 2, digits);
+	}
+
+	return i;
+}
+#endif // ENCODING_X86_SIMD
+
+// Checks the size of out, then encodes str using digits, or pairs for
+// whatever the SIMD encoders leave over.
+static int
+encode_impl(const size_t str_len, const uint8_t* str, const size_t out_len,
+		uint8_t* out, const uint8_t digits[16],
+		const uint16_t pairs[256])
 {
 	if (UNLIKELY(str_len == 0)) {
 		return 0;
@@ -87,16 +300,39 @@ hex_encode(const size_t str_len, const uint8_t* str, const size_t out_len,
 
 	assert(out != NULL);
 
-	size_t out_index = 0;
-	for (size_t i = 0; i < str_len; i += 1) {
-		out[out_index]     = hex_chars[(str[i] & 0xf0) >> 4];
-		out[out_index + 1] = hex_chars[(str[i] & 0x0f) >> 0];
-		out_index += 2;
+	size_t i = 0;
+#if ENCODING_X86_SIMD
+	i = encode_simd(str_len, str, out, digits);
+#else
+	(void)digits;
+#endif
+
+	for (; i < str_len; i += 1) {
+		binary_uint16_encode(pairs[str[i]], 2, &out[i * 2],
+				ENCODING_BYTE_ORDER_LITTLE);
 	}
 
 	return 0;
 }
 
+ENCODING_PUBLIC
+int
+hex_encode(const size_t str_len, const uint8_t* str, const size_t out_len,
+		uint8_t* out)
+{
+	return encode_impl(str_len, str, out_len, out, hex_chars,
+			hex_encode_pairs);
+}
+
+ENCODING_PUBLIC
+int
+hex_encode_upper(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out)
+{
+	return encode_impl(str_len, str, out_len, out, hex_upper_digits,
+			hex_encode_upper_pairs);
+}
+
 ENCODING_PUBLIC
 size_t
 hex_decoded_length(const size_t len)
@@ -104,12 +340,186 @@ hex_decoded_length(const size_t len)
 	return len / 2;
 }
 
+#if ENCODING_X86_SIMD
+// The SIMD decoders find the value of each character as both a digit and a
+// letter, using the fact that c - '0' is at most 9 only for digits and
+// (c | 0x20) - 'a' is at most 5 only for letters, when compared unsigned. If
+// any character is neither the block is left to the scalar decoder, which
+// reports the error. Each pair of values is then combined into a byte with a
+// single multiply-add, and the 16-bit results are packed together.
+
+// Returns the values of the 16 characters in in, setting *valid to a mask
+// with every byte set to 0xff if its character was valid and 0 if not.
+ENCODING_TARGET("ssse3")
+static __m128i
+decode_values_ssse3(const __m128i in, __m128i* valid)
+{
+	const __m128i digit  = _mm_sub_epi8(in, _mm_set1_epi8(0x30));
+	const __m128i folded = _mm_or_si128(in, _mm_set1_epi8(0x20));
+	const __m128i letter = _mm_sub_epi8(folded, _mm_set1_epi8(0x61));
+
+	const __m128i nine = _mm_set1_epi8(9);
+	const __m128i five = _mm_set1_epi8(5);
+	const __m128i is_digit =
+			_mm_cmpeq_epi8(_mm_max_epu8(digit, nine), nine);
+	const __m128i is_letter =
+			_mm_cmpeq_epi8(_mm_max_epu8(letter, five), five);
+
+	*valid = _mm_or_si128(is_digit, is_letter);
+	const __m128i letter_value =
+			_mm_add_epi8(letter, _mm_set1_epi8(10));
+	return _mm_or_si128(_mm_and_si128(is_digit, digit),
+			_mm_and_si128(is_letter, letter_value));
+}
+
+// Decodes 32 characters at a time, returning how many characters of str were
+// consumed. Stops early at the first block containing a character which
+// isn't hexadecimal.
+ENCODING_TARGET("ssse3")
+static size_t
+decode_ssse3(const size_t str_len, const uint8_t* str, uint8_t* out)
+{
+	// Multiplies the first value of each pair by 16 and adds the second.
+	const __m128i weights = _mm_set1_epi16(0x0110);
+
+	size_t i = 0;
+	for (; i + 32 <= str_len; i += 32) {
+		const __m128i* in = (const __m128i*)(str + i);
+
+		__m128i       valid_a;
+		__m128i       valid_b;
+		const __m128i a = decode_values_ssse3(
+				_mm_loadu_si128(in), &valid_a);
+		const __m128i b = decode_values_ssse3(
+				_mm_loadu_si128(in + 1), &valid_b);
+		const __m128i valid = _mm_and_si128(valid_a, valid_b);
+		if (UNLIKELY(_mm_movemask_epi8(valid) != 0xffff)) {
+			break;
+		}
+
+		const __m128i bytes = _mm_packus_epi16(
+				_mm_maddubs_epi16(a, weights),
+				_mm_maddubs_epi16(b, weights));
+		_mm_storeu_si128((__m128i*)(out + i / 2), bytes);
+	}
+
+	return i;
+}
+
+// Same as decode_values_ssse3, but for 32 characters.
+ENCODING_TARGET("avx2")
+static __m256i
+decode_values_avx2(const __m256i in, __m256i* valid)
+{
+	const __m256i digit  = _mm256_sub_epi8(in, _mm256_set1_epi8(0x30));
+	const __m256i folded = _mm256_or_si256(in, _mm256_set1_epi8(0x20));
+	const __m256i letter =
+			_mm256_sub_epi8(folded, _mm256_set1_epi8(0x61));
+
+	const __m256i nine = _mm256_set1_epi8(9);
+	const __m256i five = _mm256_set1_epi8(5);
+	const __m256i is_digit =
+			_mm256_cmpeq_epi8(_mm256_max_epu8(digit, nine), nine);
+	const __m256i is_letter =
+			_mm256_cmpeq_epi8(_mm256_max_epu8(letter, five), five);
+
+	*valid = _mm256_or_si256(is_digit, is_letter);
+	const __m256i letter_value =
+			_mm256_add_epi8(letter, _mm256_set1_epi8(10));
+	return _mm256_or_si256(_mm256_and_si256(is_digit, digit),
+			_mm256_and_si256(is_letter, letter_value));
+}
+
+// Decodes 64 characters at a time, returning how many characters of str were
+// consumed. Stops early at the first block containing a character which
+// isn't hexadecimal.
+ENCODING_TARGET("avx2")
+static size_t
+decode_avx2(const size_t str_len, const uint8_t* str, uint8_t* out)
+{
+	const __m256i weights = _mm256_set1_epi16(0x0110);
+
+	size_t i = 0;
+	for (; i + 64 <= str_len; i += 64) {
+		const __m256i* in = (const __m256i*)(str + i);
+
+		__m256i       valid_a;
+		__m256i       valid_b;
+		const __m256i a = decode_values_avx2(
+				_mm256_loadu_si256(in), &valid_a);
+		const __m256i b = decode_values_avx2(
+				_mm256_loadu_si256(in + 1), &valid_b);
+		const __m256i valid = _mm256_and_si256(valid_a, valid_b);
+		if (UNLIKELY(_mm256_movemask_epi8(valid) != -1)) {
+			break;
+		}
+
+		// The pack works within each 128-bit lane, so the 64-bit
+		// quarters have to be put back in order.
+		const __m256i bytes = _mm256_packus_epi16(
+				_mm256_maddubs_epi16(a, weights),
+				_mm256_maddubs_epi16(b, weights));
+		_mm256_storeu_si256((__m256i*)(out + i / 2),
+				_mm256_permute4x64_epi64(bytes, 0xd8));
+	}
+
+	return i;
+}
+
+// Decodes as much of str as possible using the best kernel the CPU supports,
+// returning how many characters of str were consumed. This is always a
+// multiple of 32.
+static size_t
+decode_simd(const size_t str_len, const uint8_t* str, uint8_t* out)
+{
+	const int features = encoding_cpu_features();
+
+	size_t i = 0;
+	if (features & ENCODING_CPU_AVX2) {
+		i = decode_avx2(str_len, str, out);
+	}
+
+	if (features & ENCODING_CPU_SSSE3) {
+		i += decode_ssse3(str_len - i, str + i, out + i / 2);
+	}
+
+	return i;
+}
+#endif // ENCODING_X86_SIMD
+
+// Decodes the str_len characters of str, which must be a multiple of 2, into
+// out. Returns false if str contains a character which isn't hexadecimal.
+static bool
+decode_pairs(const size_t str_len, const uint8_t* str, uint8_t* out)
+{
+	size_t i = 0;
+#if ENCODING_X86_SIMD
+	i = decode_simd(str_len, str, out);
+#endif
+
+	for (; i < str_len; i += 2) {
+		const uint8_t hi = char_to_nybble[str[i]];
+		const uint8_t lo = char_to_nybble[str[i + 1]];
+		if (UNLIKELY((hi | lo) > 0x0f)) {
+			return false;
+		}
+
+		out[i / 2] = (uint8_t)(hi << 4 | lo);
+	}
+
+	return true;
+}
+
 ENCODING_PUBLIC
 int
 hex_decode(const size_t str_len, const uint8_t* str, const size_t out_len,
 		uint8_t* out)
 {
-	assert(str_len == 0 || str != NULL);
+	if (UNLIKELY(str_len == 0)) {
+		return 0;
+	}
+
+	assert(str != NULL);
 
 	if (UNLIKELY(str_len % 2 != 0)) {
 		return ENCODING_INVALID_ARGUMENT;
@@ -121,136 +531,1435 @@ hex_decode(const size_t str_len, const uint8_t* str, const size_t out_len,
 
 	assert(out != NULL);
 
-	size_t out_index = 0;
-	for (size_t i = 0; i < str_len; i += 2) {
-		out[out_index] = char_to_nybble[str[i]] << 4 |
-				 char_to_nybble[str[i + 1]] << 0;
-		out_index += 1;
+	if (UNLIKELY(!decode_pairs(str_len, str, out))) {
+		return ENCODING_INVALID_ARGUMENT;
 	}
 
 	return 0;
 }
 
-#define HEX_DUMP_LINE_LEN 78
-
 ENCODING_PUBLIC
-size_t
-hex_dump_length(const size_t len)
+int
+hex_decode_in_place(const size_t str_len, uint8_t* str, size_t* out_len)
 {
-	size_t num_lines = (len / 16) + (len % 16);
-	return num_lines * HEX_DUMP_LINE_LEN;
+	if (out_len != NULL) {
+		*out_len = 0;
+	}
+
+	if (UNLIKELY(str_len == 0)) {
+		return 0;
+	}
+
+	// Each pair of characters is read before its byte is written, and the
+	// output is always behind the input.
+	int err = hex_decode(str_len, str, str_len, str);
+	if (UNLIKELY(err != 0)) {
+		return err;
+	}
+
+	if (out_len != NULL) {
+		*out_len = hex_decoded_length(str_len);
+	}
+
+	return 0;
 }
 
-// A small buffer to hold the address in the hex dump output.
-static uint8_t address_buffer[8] = {0};
+// The state shared by the tasks of hex_encode_parallel and
+// hex_decode_parallel. Task i handles the chunk_len bytes or characters of str
+// starting at i * chunk_len.
+struct parallel_job {
+	size_t         str_len;
+	const uint8_t* str;
+	uint8_t*       out;
+	size_t         chunk_len;
+	int            results[PARALLEL_MAX_TASKS];
+};
 
-// Fills address_buffer with num formatted as a string of 8 hexadecimal
-// characters.
 static void
-uint64_to_str(uint64_t num)
+encode_task(void* context, size_t index)
 {
-	uint8_t tmp[8] = {0};
-	size_t  sz     = 0;
-	for (size_t i = 0; i < 8; i += 1) {
-		if (num == 0) {
-			break;
-		}
+	struct parallel_job* job   = (struct parallel_job*)context;
+	const size_t         start = index * job->chunk_len;
 
-		tmp[i] = hex_chars[num % 16];
-		num /= 16;
-		sz += 1;
+	size_t len = job->str_len - start;
+	if (len > job->chunk_len) {
+		len = job->chunk_len;
 	}
 
-	size_t tmp_index = sz;
-	for (size_t i = 0; i < 8; i += 1) {
-		if (i < 8 - sz) {
-			address_buffer[i] = hex_chars[0];
-		} else {
-			address_buffer[i] = tmp[tmp_index - 1];
-			tmp_index -= 1;
-		}
+	job->results[index] = hex_encode(len, &job->str[start],
+			hex_encoded_length(len), &job->out[start * 2]);
+}
+
+ENCODING_PUBLIC
+int
+hex_encode_parallel(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out,
+		const struct encoding_executor* executor)
+{
+	if (executor == NULL) {
+		return hex_encode(str_len, str, out_len, out);
+	}
+
+	if (UNLIKELY(str_len == 0)) {
+		return 0;
+	}
+
+	assert(str != NULL);
+
+	if (UNLIKELY(out_len < hex_encoded_length(str_len))) {
+		return ENCODING_BUFFER_TOO_SMALL;
+	}
+
+	assert(out != NULL);
+
+	struct parallel_job job;
+	job.str_len   = str_len;
+	job.str       = str;
+	job.out       = out;
+	job.chunk_len = parallel_chunk_len(str_len, 1, executor);
+
+	const size_t num_tasks = (str_len + job.chunk_len - 1) / job.chunk_len;
+	if (num_tasks == 1) {
+		return hex_encode(str_len, str, out_len, out);
+	}
+
+	assert(executor->run != NULL);
+	executor->run(executor->user, num_tasks, encode_task, &job);
+	return parallel_result(num_tasks, job.results);
+}
+
+static void
+decode_task(void* context, size_t index)
+{
+	struct parallel_job* job   = (struct parallel_job*)context;
+	const size_t         start = index * job->chunk_len;
+
+	size_t len = job->str_len - start;
+	if (len > job->chunk_len) {
+		len = job->chunk_len;
+	}
+
+	job->results[index] = hex_decode(len, &job->str[start],
+			hex_decoded_length(len), &job->out[start / 2]);
+}
+
+ENCODING_PUBLIC
+int
+hex_decode_parallel(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out,
+		const struct encoding_executor* executor)
+{
+	if (executor == NULL) {
+		return hex_decode(str_len, str, out_len, out);
+	}
+
+	if (UNLIKELY(str_len == 0)) {
+		return 0;
+	}
+
+	assert(str != NULL);
+
+	if (UNLIKELY(str_len % 2 != 0)) {
+		return ENCODING_INVALID_ARGUMENT;
 	}
+
+	if (UNLIKELY(hex_decoded_length(str_len) > out_len)) {
+		return ENCODING_BUFFER_TOO_SMALL;
+	}
+
+	assert(out != NULL);
+
+	struct parallel_job job;
+	job.str_len   = str_len;
+	job.str       = str;
+	job.out       = out;
+	job.chunk_len = parallel_chunk_len(str_len, 2, executor);
+
+	const size_t num_tasks = (str_len + job.chunk_len - 1) / job.chunk_len;
+	if (num_tasks == 1) {
+		return hex_decode(str_len, str, out_len, out);
+	}
+
+	assert(executor->run != NULL);
+	executor->run(executor->user, num_tasks, decode_task, &job);
+	return parallel_result(num_tasks, job.results);
 }
 
+// The length of a line of hex_dump output holding 16 bytes.
+#define HEX_DUMP_LINE_LEN 79
+
 #define UTF8_SPACE   0x20 // ' '
 #define UTF8_PERIOD  0x2e // '.'
 #define UTF8_NEWLINE 0x0a // '\n'
 #define UTF8_PIPE    0x7c // '|'
 
 ENCODING_PUBLIC
-int
-hex_dump(const size_t buf_len, const uint8_t* buf, const size_t out_len,
-		uint8_t* out, uint64_t* offset)
+const struct hex_dump_format hex_dump_format_canonical = {
+		16,    // bytes_per_row
+		8,     // group_size
+		8,     // address_width
+		true,  // ascii
+		false, // uppercase
+		"",    // line_prefix
+		"  ",  // address_separator
+		"",    // byte_prefix
+		" ",   // byte_suffix
+		"",    // byte_separator
+		" ",   // group_separator
+		"|",   // ascii_prefix
+		"|",   // ascii_suffix
+		"\n",  // line_suffix
+};
+
+ENCODING_PUBLIC
+const struct hex_dump_format hex_dump_format_xxd = {
+		16,    // bytes_per_row
+		2,     // group_size
+		8,     // address_width
+		true,  // ascii
+		false, // uppercase
+		"",    // line_prefix
+		": ",  // address_separator
+		"",    // byte_prefix
+		"",    // byte_suffix
+		"",    // byte_separator
+		" ",   // group_separator
+		" ",   // ascii_prefix
+		"",    // ascii_suffix
+		"\n",  // line_suffix
+};
+
+ENCODING_PUBLIC
+const struct hex_dump_format hex_dump_format_od = {
+		16,    // bytes_per_row
+		16,    // group_size
+		0,     // address_width
+		false, // ascii
+		false, // uppercase
+		"",    // line_prefix
+		"",    // address_separator
+		" ",   // byte_prefix
+		"",    // byte_suffix
+		"",    // byte_separator
+		"",    // group_separator
+		"",    // ascii_prefix
+		"",    // ascii_suffix
+		"\n",  // line_suffix
+};
+
+ENCODING_PUBLIC
+const struct hex_dump_format hex_dump_format_c_array = {
+		12,    // bytes_per_row
+		12,    // group_size
+		0,     // address_width
+		false, // ascii
+		false, // uppercase
+		"  ",  // line_prefix
+		"",    // address_separator
+		"0x",  // byte_prefix
+		",",   // byte_suffix
+		" ",   // byte_separator
+		"",    // group_separator
+		"",    // ascii_prefix
+		"",    // ascii_suffix
+		"\n",  // line_suffix
+};
+
+// Returns the length of the nul-terminated string str, or 0 if str is NULL.
+static size_t
+string_length(const char* str)
 {
-	assert(buf_len == 0 || buf != NULL);
+	size_t result = 0;
+	if (str == NULL) {
+		return result;
+	}
 
-	if (UNLIKELY(hex_dump_length(buf_len) > out_len)) {
-		return ENCODING_BUFFER_TOO_SMALL;
+	while (str[result] != '\0') {
+		result += 1;
 	}
 
-	assert(out != NULL);
+	return result;
+}
 
-	size_t address = 0;
-	if (offset != NULL) {
-		address = *offset;
-		// Detects if address value would wrap around.
-		if (UNLIKELY(address > SIZE_MAX - buf_len)) {
-			return ENCODING_INVALID_ARGUMENT;
-		}
+// Copies the nul-terminated string str to out, returning its length. If str
+// is NULL, nothing is copied.
+static size_t
+string_copy(const char* str, uint8_t* out)
+{
+	size_t result = 0;
+	if (str == NULL) {
+		return result;
 	}
 
-	size_t out_index = 0;
-	for (size_t i = 0; i < buf_len; i += 16) {
-		// Address column
-		uint64_to_str(address);
-		for (size_t j = 0; j < 8; j += 1) {
-			out[out_index + j] = address_buffer[j];
-		}
+	for (; str[result] != '\0'; result += 1) {
+		out[result] = (uint8_t)str[result];
+	}
 
-		out_index += 8;
-		out[out_index]     = UTF8_SPACE;
-		out[out_index + 1] = UTF8_SPACE;
-		out_index += 2;
+	return result;
+}
 
-		address += 16;
+// Returns true if format describes a layout hex_dump_formatted can produce.
+static bool
+format_valid(const struct hex_dump_format* format)
+{
+	return format->bytes_per_row != 0 &&
+	       format->bytes_per_row <= HEX_DUMP_MAX_BYTES_PER_ROW &&
+	       format->group_size != 0 && format->address_width <= 16;
+}
 
-		// 8 hex byte wide columns * 2
-		for (size_t j = 0; j < 2; j += 1) {
-			for (size_t k = 0; k < 8; k += 1) {
-				const size_t idx = (i + k) + (j * 8);
-				if (idx > buf_len - 1) {
-					out[out_index]     = UTF8_SPACE;
-					out[out_index + 1] = UTF8_SPACE;
-				} else {
-					(void)hex_encode(1, &buf[idx],
-							SIZE_MAX,
-							&out[out_index]);
-				}
-				out[out_index + 2] = UTF8_SPACE;
-				out_index += 3;
-			}
+// Returns the length of a line holding line_len bytes, which is at most
+// format->bytes_per_row.
+static size_t
+format_line_length(
+		const struct hex_dump_format* format, const size_t line_len)
+{
+	// When there is an ASCII column, the missing bytes of the last line
+	// are padded with spaces so that it lines up with the others.
+	const size_t columns =
+			format->ascii ? format->bytes_per_row : line_len;
 
-			out[out_index] = UTF8_SPACE;
-			out_index += 1;
-		}
+	// Every column but the last in a group is followed by the byte
+	// separator, and every group, including a partial last one, by the
+	// group separator.
+	const size_t num_groups = (columns + format->group_size - 1) /
+				  format->group_size;
 
-		// ASCII representation column
-		out[out_index] = UTF8_PIPE;
-		out_index += 1;
-		for (size_t j = 0; j < 16 && i + j < buf_len;
-				j += 1, out_index += 1) {
-			if (buf[i + j] < 0x7f && buf[i + j] > 0x1f) {
-				out[out_index] = buf[i + j];
-			} else {
-				out[out_index] = UTF8_PERIOD;
-			}
-		}
-		out[out_index]     = UTF8_PIPE;
-		out[out_index + 1] = UTF8_NEWLINE;
-		out_index += 2;
+	size_t result = string_length(format->line_prefix) +
+			string_length(format->line_suffix);
+	if (format->address_width != 0) {
+		result += format->address_width +
+			  string_length(format->address_separator);
 	}
 
-	return 0;
+	result += columns * (string_length(format->byte_prefix) + 2 +
+				    string_length(format->byte_suffix));
+	result += (columns - num_groups) *
+		  string_length(format->byte_separator);
+	result += num_groups * string_length(format->group_separator);
+
+	if (format->ascii) {
+		result += string_length(format->ascii_prefix) + line_len +
+			  string_length(format->ascii_suffix);
+	}
+
+	return result;
+}
+
+// Writes the low 4 * width bits of address to out as width hexadecimal
+// characters.
+static void
+dump_address(const uint64_t address, const size_t width, const bool upper,
+		uint8_t* out)
+{
+	const uint8_t* digits = upper ? hex_upper_digits : hex_chars;
+	for (size_t i = 0; i < width; i += 1) {
+		out[i] = digits[(address >> ((width - 1 - i) * 4)) & 0x0f];
+	}
+}
+
+// Writes the ASCII column for the 8 bytes in word to out, replacing the bytes
+// which aren't printable with '.'.
+static void
+dump_ascii_word(const uint64_t word, uint8_t* out)
+{
+	const uint64_t ones      = UINT64_C(0x0101010101010101);
+	const uint64_t high_bits = word & (ones * 0x80);
+
+	// Bytes with their high bit set are never printable.
+	const uint64_t ascii = word & ~high_bits;
+	const uint64_t printable =
+			swar_between(ascii, 0x20, 0x7e) & ~high_bits;
+
+	// Spread the high bit of each printable byte over the whole byte.
+	const uint64_t mask   = (printable >> 7) * 0xff;
+	const uint64_t result = (word & mask) | (ones * UTF8_PERIOD & ~mask);
+
+	binary_uint32_encode((uint32_t)result, 4, out,
+			ENCODING_BYTE_ORDER_LITTLE);
+	binary_uint32_encode((uint32_t)(result >> 32), 4, &out[4],
+			ENCODING_BYTE_ORDER_LITTLE);
+}
+
+// Formats the 16 bytes in line as a line of hex_dump_format_canonical output
+// starting with address, writing HEX_DUMP_LINE_LEN bytes to out.
+static void
+dump_canonical_line(
+		const uint8_t* line, const uint64_t address, uint8_t* out)
+{
+	for (size_t i = 0; i < 4; i += 1) {
+		const uint8_t byte = (uint8_t)(address >> (24 - i * 8));
+		binary_uint16_encode(hex_encode_pairs[byte], 2, &out[i * 2],
+				ENCODING_BYTE_ORDER_LITTLE);
+	}
+
+	out[8] = UTF8_SPACE;
+	out[9] = UTF8_SPACE;
+
+	// Each byte is written as its two characters followed by two spaces,
+	// and the next byte overwrites the second space. The second space
+	// after the last byte of each half separates the halves.
+	size_t j = 10;
+	for (size_t i = 0; i < 16; i += 1) {
+		const uint32_t column = hex_encode_pairs[line[i]] |
+					UINT32_C(0x20200000);
+		binary_uint32_encode(column, 4, &out[j],
+				ENCODING_BYTE_ORDER_LITTLE);
+		j += (i == 7 || i == 15) ? 4 : 3;
+	}
+
+	out[60] = UTF8_PIPE;
+	for (size_t i = 0; i < 16; i += 8) {
+		uint64_t word = 0;
+		binary_uint64_decode(8, &line[i], &word,
+				ENCODING_BYTE_ORDER_LITTLE);
+		dump_ascii_word(word, &out[61 + i]);
+	}
+
+	out[77] = UTF8_PIPE;
+	out[78] = UTF8_NEWLINE;
+}
+
+// Formats the line_len bytes in line, which is at most format->bytes_per_row,
+// as a line of output starting with address. Returns the number of bytes
+// written to out, which is format_line_length(format, line_len).
+static size_t
+dump_line(const size_t line_len, const uint8_t* line, const uint64_t address,
+		const struct hex_dump_format* format, uint8_t* out)
+{
+	const uint16_t* pairs = format->uppercase ? hex_encode_upper_pairs
+						  : hex_encode_pairs;
+	const size_t columns =
+			format->ascii ? format->bytes_per_row : line_len;
+
+	size_t j = string_copy(format->line_prefix, out);
+	if (format->address_width != 0) {
+		dump_address(address, format->address_width,
+				format->uppercase, &out[j]);
+		j += format->address_width;
+		j += string_copy(format->address_separator, &out[j]);
+	}
+
+	for (size_t i = 0; i < columns; i += 1) {
+		if (i < line_len) {
+			j += string_copy(format->byte_prefix, &out[j]);
+			binary_uint16_encode(pairs[line[i]], 2, &out[j],
+					ENCODING_BYTE_ORDER_LITTLE);
+			j += 2;
+			j += string_copy(format->byte_suffix, &out[j]);
+		} else {
+			const size_t width =
+					string_length(format->byte_prefix) +
+					2 + string_length(format->byte_suffix);
+			for (size_t k = 0; k < width; k += 1, j += 1) {
+				out[j] = UTF8_SPACE;
+			}
+		}
+
+		if ((i + 1) % format->group_size == 0 || i + 1 == columns) {
+			j += string_copy(format->group_separator, &out[j]);
+		} else {
+			j += string_copy(format->byte_separator, &out[j]);
+		}
+	}
+
+	if (format->ascii) {
+		j += string_copy(format->ascii_prefix, &out[j]);
+		for (size_t i = 0; i < line_len; i += 1, j += 1) {
+			if (line[i] < 0x7f && line[i] > 0x1f) {
+				out[j] = line[i];
+			} else {
+				out[j] = UTF8_PERIOD;
+			}
+		}
+
+		j += string_copy(format->ascii_suffix, &out[j]);
+	}
+
+	j += string_copy(format->line_suffix, &out[j]);
+	return j;
+}
+
+ENCODING_PUBLIC
+size_t
+hex_dump_formatted_length(
+		const size_t len, const struct hex_dump_format* format)
+{
+	assert(format != NULL);
+
+	const size_t bytes_per_row = format->bytes_per_row;
+	size_t       result        = len / bytes_per_row *
+			 format_line_length(format, bytes_per_row);
+	if (len % bytes_per_row != 0) {
+		result += format_line_length(format, len % bytes_per_row);
+	}
+
+	return result;
+}
+
+ENCODING_PUBLIC
+size_t
+hex_dump_length(const size_t len)
+{
+	return hex_dump_formatted_length(len, &hex_dump_format_canonical);
+}
+
+// Formats the buf_len bytes of buf as whole lines starting with address,
+// returning the number of bytes written to out. buf_len must be a multiple
+// of format->bytes_per_row.
+static size_t
+dump_lines(const size_t buf_len, const uint8_t* buf, const uint64_t address,
+		const struct hex_dump_format* format, uint8_t* out)
+{
+	const size_t bytes_per_row = format->bytes_per_row;
+
+	size_t j = 0;
+	if (format == &hex_dump_format_canonical) {
+		for (size_t i = 0; i < buf_len; i += 16) {
+			dump_canonical_line(&buf[i], address + i, &out[j]);
+			j += HEX_DUMP_LINE_LEN;
+		}
+
+		return j;
+	}
+
+	for (size_t i = 0; i < buf_len; i += bytes_per_row) {
+		j += dump_line(bytes_per_row, &buf[i], address + i, format,
+				&out[j]);
+	}
+
+	return j;
+}
+
+ENCODING_PUBLIC
+int
+hex_dump_formatted(const size_t buf_len, const uint8_t* buf,
+		const size_t out_len, uint8_t* out, uint64_t* offset,
+		const struct hex_dump_format* format)
+{
+	assert(buf_len == 0 || buf != NULL);
+	assert(format != NULL);
+
+	if (UNLIKELY(!format_valid(format))) {
+		return ENCODING_INVALID_ARGUMENT;
+	}
+
+	if (UNLIKELY(hex_dump_formatted_length(buf_len, format) > out_len)) {
+		return ENCODING_BUFFER_TOO_SMALL;
+	}
+
+	uint64_t address = 0;
+	if (offset != NULL) {
+		address = *offset;
+		// Detects if address value would wrap around.
+		if (UNLIKELY(address > UINT64_MAX - buf_len)) {
+			return ENCODING_INVALID_ARGUMENT;
+		}
+	}
+
+	if (UNLIKELY(buf_len == 0)) {
+		return 0;
+	}
+
+	assert(out != NULL);
+
+	const size_t full_len = buf_len / format->bytes_per_row *
+				format->bytes_per_row;
+	size_t out_index = dump_lines(full_len, buf, address, format, out);
+	if (full_len != buf_len) {
+		(void)dump_line(buf_len - full_len, &buf[full_len],
+				address + full_len, format, &out[out_index]);
+	}
+
+	if (offset != NULL) {
+		*offset = address + buf_len;
+	}
+
+	return 0;
+}
+
+ENCODING_PUBLIC
+int
+hex_dump(const size_t buf_len, const uint8_t* buf, const size_t out_len,
+		uint8_t* out, uint64_t* offset)
+{
+	return hex_dump_formatted(buf_len, buf, out_len, out, offset,
+			&hex_dump_format_canonical);
+}
+
+ENCODING_PUBLIC
+void
+hex_dumper_init(struct hex_dumper* dumper, const uint64_t offset)
+{
+	assert(dumper != NULL);
+
+	dumper->format   = &hex_dump_format_canonical;
+	dumper->address  = offset;
+	dumper->line_len = 0;
+}
+
+ENCODING_PUBLIC
+int
+hex_dumper_init_formatted(struct hex_dumper* dumper, const uint64_t offset,
+		const struct hex_dump_format* format)
+{
+	assert(dumper != NULL);
+	assert(format != NULL);
+
+	if (UNLIKELY(!format_valid(format))) {
+		return ENCODING_INVALID_ARGUMENT;
+	}
+
+	dumper->format   = format;
+	dumper->address  = offset;
+	dumper->line_len = 0;
+	return 0;
+}
+
+ENCODING_PUBLIC
+size_t
+hex_dumper_update_length(
+		const struct hex_dumper* dumper, const size_t buf_len)
+{
+	assert(dumper != NULL);
+
+	const size_t bytes_per_row = dumper->format->bytes_per_row;
+	return (dumper->line_len + buf_len) / bytes_per_row *
+	       format_line_length(dumper->format, bytes_per_row);
+}
+
+ENCODING_PUBLIC
+int
+hex_dumper_update(struct hex_dumper* dumper, const size_t buf_len,
+		const uint8_t* buf, const size_t out_len, uint8_t* out,
+		size_t* written)
+{
+	assert(dumper != NULL);
+
+	if (written != NULL) {
+		*written = 0;
+	}
+
+	if (UNLIKELY(buf_len == 0)) {
+		return 0;
+	}
+
+	assert(buf != NULL);
+
+	const size_t dump_len = hex_dumper_update_length(dumper, buf_len);
+	if (UNLIKELY(out_len < dump_len)) {
+		return ENCODING_BUFFER_TOO_SMALL;
+	}
+
+	// Same as hex_dump, the address following the input has to fit.
+	const uint64_t end = dumper->address + dumper->line_len;
+	if (UNLIKELY(buf_len > UINT64_MAX - end)) {
+		return ENCODING_INVALID_ARGUMENT;
+	}
+
+	assert(dump_len == 0 || out != NULL);
+
+	const struct hex_dump_format* format        = dumper->format;
+	const size_t                  bytes_per_row = format->bytes_per_row;
+
+	// Complete the line left over from the last call first.
+	size_t i = 0;
+	size_t j = 0;
+	if (dumper->line_len != 0) {
+		while (dumper->line_len < bytes_per_row && i < buf_len) {
+			dumper->line[dumper->line_len] = buf[i];
+			dumper->line_len += 1;
+			i += 1;
+		}
+
+		if (dumper->line_len < bytes_per_row) {
+			return 0;
+		}
+
+		j = dump_lines(bytes_per_row, dumper->line, dumper->address,
+				format, out);
+		dumper->address += bytes_per_row;
+		dumper->line_len = 0;
+	}
+
+	// Then format the whole lines directly from buf into out.
+	const size_t len = (buf_len - i) / bytes_per_row * bytes_per_row;
+	j += dump_lines(len, &buf[i], dumper->address, format, &out[j]);
+	dumper->address += len;
+	i += len;
+
+	for (; i < buf_len; i += 1) {
+		dumper->line[dumper->line_len] = buf[i];
+		dumper->line_len += 1;
+	}
+
+	if (written != NULL) {
+		*written = j;
+	}
+
+	return 0;
+}
+
+ENCODING_PUBLIC
+int
+hex_dumper_final(struct hex_dumper* dumper, const size_t out_len,
+		uint8_t* out, size_t* written)
+{
+	assert(dumper != NULL);
+
+	if (written != NULL) {
+		*written = 0;
+	}
+
+	const struct hex_dump_format* format = dumper->format;
+	const size_t                  dump_len =
+			hex_dump_formatted_length(dumper->line_len, format);
+	if (UNLIKELY(out_len < dump_len)) {
+		return ENCODING_BUFFER_TOO_SMALL;
+	}
+
+	if (dumper->line_len != 0) {
+		assert(out != NULL);
+
+		(void)dump_line(dumper->line_len, dumper->line,
+				dumper->address, format, out);
+		dumper->address += dumper->line_len;
+		dumper->line_len = 0;
+	}
+
+	if (written != NULL) {
+		*written = dump_len;
+	}
+
+	return 0;
+}
+
+// The longest whole line, as given by format_line_length, which
+// hex_undump_formatted checks and decodes without parsing it. Longer lines
+// are always parsed.
+#define UNDUMP_MAX_LINE_LEN 512
+
+// The number of bytes from whole lines which are decoded at once.
+#define UNDUMP_BATCH_LEN 256
+
+#define UTF8_ASTERISK 0x2a // '*'
+
+// The number of hexadecimal characters gathered together by each shuffle.
+#define UNDUMP_SHUFFLE_LEN 8
+
+// undump_layout describes where everything is in a whole line of a format, so
+// that whole lines can be checked and decoded without parsing them.
+struct undump_layout {
+	// The length of a whole line, or 0 if whole lines have to be parsed
+	// like any other.
+	size_t line_len;
+	// line_len rounded up to a multiple of 16. Whole lines are checked 16
+	// bytes at a time, so a whole line needs this much of the input left.
+	size_t check_len;
+	size_t address_start;
+	// A whole line, and a mask which is 0xff for each byte which is the
+	// same in every whole line, and 0 for the address, the hexadecimal
+	// characters, the ASCII column and the bytes past line_len.
+	uint8_t expected[UNDUMP_MAX_LINE_LEN];
+	uint8_t mask[UNDUMP_MAX_LINE_LEN];
+	// The position of each hexadecimal character of the bytes.
+	uint16_t digits[2 * HEX_DUMP_MAX_BYTES_PER_ROW];
+#if ENCODING_X86_SIMD
+	// If every UNDUMP_SHUFFLE_LEN hexadecimal characters are within 16
+	// bytes of each other, they are gathered by shuffling the 16 bytes
+	// starting at shuffle_start.
+	bool     shuffle;
+	uint16_t shuffle_start[2 * HEX_DUMP_MAX_BYTES_PER_ROW /
+			       UNDUMP_SHUFFLE_LEN];
+	uint8_t  shuffle_masks[2 * HEX_DUMP_MAX_BYTES_PER_ROW /
+				      UNDUMP_SHUFFLE_LEN][16];
+#endif
+};
+
+// undumper holds the state of hex_undump_formatted between lines.
+struct undumper {
+	const struct hex_dump_format* format;
+	uint64_t                      base;
+	size_t                        out_len;
+	// NULL if the output is only being counted.
+	uint8_t* out;
+	// The length of the output so far.
+	size_t end;
+	// Where the bytes of the last line were written, for '*' lines.
+	size_t last_start;
+	size_t last_len;
+	bool   squeeze;
+};
+
+#if ENCODING_X86_SIMD
+// Sets up layout->shuffle_start and layout->shuffle_masks, returning false if
+// the hexadecimal characters are too far apart to be shuffled together.
+static bool
+undump_layout_shuffle(struct undump_layout* layout, const size_t num_digits)
+{
+	if (layout->check_len < 16) {
+		return false;
+	}
+
+	const size_t num_blocks = num_digits / UNDUMP_SHUFFLE_LEN;
+	for (size_t i = 0; i < num_blocks; i += 1) {
+		const uint16_t* digits =
+				&layout->digits[i * UNDUMP_SHUFFLE_LEN];
+
+		// The last 16 bytes may start before the first character.
+		size_t start = digits[0];
+		if (start + 16 > layout->check_len) {
+			start = layout->check_len - 16;
+		}
+
+		if (digits[UNDUMP_SHUFFLE_LEN - 1] - start >= 16) {
+			return false;
+		}
+
+		layout->shuffle_start[i] = (uint16_t)start;
+		for (size_t k = 0; k < 16; k += 1) {
+			layout->shuffle_masks[i][k] = 0x80;
+			if (k < UNDUMP_SHUFFLE_LEN) {
+				layout->shuffle_masks[i][k] =
+						(uint8_t)(digits[k] - start);
+			}
+		}
+	}
+
+	return true;
+}
+#endif // ENCODING_X86_SIMD
+
+static void
+undump_layout_init(struct undump_layout* layout,
+		const struct hex_dump_format* format)
+{
+	const size_t bytes_per_row = format->bytes_per_row;
+	const size_t line_len      = format_line_length(format, bytes_per_row);
+	const size_t check_len     = (line_len + 15) / 16 * 16;
+
+	layout->line_len = 0;
+	if (check_len > UNDUMP_MAX_LINE_LEN) {
+		return;
+	}
+
+	const uint8_t zeroes[HEX_DUMP_MAX_BYTES_PER_ROW] = {0};
+	(void)dump_line(bytes_per_row, zeroes, 0, format, layout->expected);
+	for (size_t i = 0; i < check_len; i += 1) {
+		layout->mask[i] = i < line_len ? 0xff : 0;
+	}
+
+	size_t j              = string_length(format->line_prefix);
+	layout->address_start = j;
+	if (format->address_width != 0) {
+		for (size_t i = 0; i < format->address_width; i += 1) {
+			layout->mask[j + i] = 0;
+		}
+
+		j += format->address_width +
+		     string_length(format->address_separator);
+	}
+
+	// The same as dump_line, but only counting.
+	for (size_t i = 0; i < bytes_per_row; i += 1) {
+		j += string_length(format->byte_prefix);
+		layout->digits[i * 2]     = (uint16_t)j;
+		layout->digits[i * 2 + 1] = (uint16_t)(j + 1);
+		layout->mask[j]           = 0;
+		layout->mask[j + 1]       = 0;
+		j += 2 + string_length(format->byte_suffix);
+
+		if ((i + 1) % format->group_size == 0 ||
+				i + 1 == bytes_per_row) {
+			j += string_length(format->group_separator);
+		} else {
+			j += string_length(format->byte_separator);
+		}
+	}
+
+	if (format->ascii) {
+		j += string_length(format->ascii_prefix);
+		for (size_t i = 0; i < bytes_per_row; i += 1) {
+			layout->mask[j + i] = 0;
+		}
+	}
+
+	layout->line_len  = line_len;
+	layout->check_len = check_len;
+
+#if ENCODING_X86_SIMD
+	layout->shuffle = (encoding_cpu_features() & ENCODING_CPU_SSSE3) &&
+			  undump_layout_shuffle(layout, bytes_per_row * 2);
+#endif
+}
+
+#if ENCODING_X86_SIMD
+// Returns true if the layout->check_len bytes of line have everything but the
+// address, hexadecimal characters and ASCII column of a whole line. SSE2 is
+// always available on x86-64, so this needs no runtime check.
+static bool
+undump_line_matches(const struct undump_layout* layout, const uint8_t* line)
+{
+	__m128i difference = _mm_setzero_si128();
+	for (size_t i = 0; i < layout->check_len; i += 16) {
+		const __m128i actual =
+				_mm_loadu_si128((const __m128i*)&line[i]);
+		const __m128i expected = _mm_loadu_si128(
+				(const __m128i*)&layout->expected[i]);
+		const __m128i mask = _mm_loadu_si128(
+				(const __m128i*)&layout->mask[i]);
+		difference = _mm_or_si128(difference,
+				_mm_and_si128(_mm_xor_si128(actual, expected),
+						mask));
+	}
+
+	const __m128i zero = _mm_setzero_si128();
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(difference, zero)) == 0xffff;
+}
+
+// Gathers the num_digits hexadecimal characters of the whole line line into
+// out, UNDUMP_SHUFFLE_LEN at a time.
+ENCODING_TARGET("ssse3")
+static void
+undump_gather_ssse3(const struct undump_layout* layout,
+		const size_t num_digits, const uint8_t* line, uint8_t* out)
+{
+	size_t i = 0;
+	for (; i + UNDUMP_SHUFFLE_LEN <= num_digits; i += UNDUMP_SHUFFLE_LEN) {
+		const size_t  block = i / UNDUMP_SHUFFLE_LEN;
+		const __m128i bytes = _mm_loadu_si128(
+				(const __m128i*)&line[layout->shuffle_start
+								[block]]);
+		const __m128i mask = _mm_loadu_si128(
+				(const __m128i*)layout->shuffle_masks[block]);
+		_mm_storel_epi64((__m128i*)&out[i],
+				_mm_shuffle_epi8(bytes, mask));
+	}
+
+	for (; i < num_digits; i += 1) {
+		out[i] = line[layout->digits[i]];
+	}
+}
+#else
+// Returns true if the layout->check_len bytes of line have everything but the
+// address, hexadecimal characters and ASCII column of a whole line.
+static bool
+undump_line_matches(const struct undump_layout* layout, const uint8_t* line)
+{
+	uint8_t difference = 0;
+	for (size_t i = 0; i < layout->check_len; i += 1) {
+		difference |= (line[i] ^ layout->expected[i]) &
+			      layout->mask[i];
+	}
+
+	return difference == 0;
+}
+#endif // ENCODING_X86_SIMD
+
+// Gathers the num_digits hexadecimal characters of the whole line line into
+// out.
+static void
+undump_gather(const struct undump_layout* layout, const size_t num_digits,
+		const uint8_t* line, uint8_t* out)
+{
+#if ENCODING_X86_SIMD
+	if (layout->shuffle) {
+		undump_gather_ssse3(layout, num_digits, line, out);
+		return;
+	}
+#endif
+
+	for (size_t i = 0; i < num_digits; i += 1) {
+		out[i] = line[layout->digits[i]];
+	}
+}
+
+// If str[*pos] starts with the nul-terminated string expected, advances *pos
+// past it and returns true. NULL is treated as empty.
+static bool
+undump_match(const size_t str_len, const uint8_t* str, size_t* pos,
+		const char* expected)
+{
+	if (expected == NULL) {
+		return true;
+	}
+
+	size_t i = *pos;
+	for (size_t k = 0; expected[k] != '\0'; k += 1, i += 1) {
+		if (i == str_len || str[i] != (uint8_t)expected[k]) {
+			return false;
+		}
+	}
+
+	*pos = i;
+	return true;
+}
+
+// Writes the len bytes of line to the output at position, after filling the
+// gap between the end of the output so far and position.
+static int
+undump_write(struct undumper* undumper, const uint64_t position,
+		const size_t len, const uint8_t* line)
+{
+	const size_t out_len =
+			undumper->out == NULL ? SIZE_MAX : undumper->out_len;
+	if (UNLIKELY(position > out_len || len > out_len - position)) {
+		return ENCODING_BUFFER_TOO_SMALL;
+	}
+
+	// The address following the line has to fit, same as hex_dump.
+	if (UNLIKELY(len > UINT64_MAX - undumper->base - position)) {
+		return ENCODING_INVALID_ARGUMENT;
+	}
+
+	const size_t start = (size_t)position;
+	uint8_t*     out   = undumper->out;
+	if (out != NULL) {
+		// After a '*' line, the line before it repeats until the next
+		// line, and otherwise gaps are filled with zeroes.
+		for (size_t i = undumper->end; i < start; i += 1) {
+			if (undumper->squeeze) {
+				out[i] = out[i - undumper->last_len];
+			} else {
+				out[i] = 0;
+			}
+		}
+
+		for (size_t i = 0; i < len; i += 1) {
+			out[start + i] = line[i];
+		}
+	}
+
+	if (start + len > undumper->end) {
+		undumper->end = start + len;
+	}
+
+	undumper->last_start = start;
+	undumper->last_len   = len;
+	undumper->squeeze    = false;
+	return 0;
+}
+
+// Parses the rest of a line holding only '*', which hexdump writes in place
+// of lines which are the same as the line before them, advancing *pos past
+// it.
+static int
+undump_squeeze(struct undumper* undumper, const size_t str_len,
+		const uint8_t* str, size_t* pos)
+{
+	// Only the last line written can be repeated.
+	const size_t last_len = undumper->last_len;
+	const size_t last_end = undumper->last_start + last_len;
+	if (UNLIKELY(last_len == 0 || undumper->squeeze ||
+			last_end != undumper->end)) {
+		return ENCODING_INVALID_ARGUMENT;
+	}
+
+	size_t i = *pos;
+	if (UNLIKELY(i != str_len &&
+			!undump_match(str_len, str, &i,
+					undumper->format->line_suffix))) {
+		return ENCODING_INVALID_ARGUMENT;
+	}
+
+	undumper->squeeze = true;
+	*pos              = i;
+	return 0;
+}
+
+// Parses the line starting at str[*pos], advancing *pos past it.
+static int
+undump_line(struct undumper* undumper, const size_t str_len,
+		const uint8_t* str, size_t* pos)
+{
+	const struct hex_dump_format* format        = undumper->format;
+	const size_t                  bytes_per_row = format->bytes_per_row;
+	const size_t                  group_size    = format->group_size;
+	const char*                   line_suffix   = format->line_suffix;
+
+	size_t i = *pos;
+	if (UNLIKELY(!undump_match(str_len, str, &i, format->line_prefix))) {
+		return ENCODING_INVALID_ARGUMENT;
+	}
+
+	uint64_t position = undumper->end;
+	if (format->address_width != 0) {
+		if (i != str_len && str[i] == UTF8_ASTERISK) {
+			*pos = i + 1;
+			return undump_squeeze(undumper, str_len, str, pos);
+		}
+
+		if (UNLIKELY(str_len - i < format->address_width)) {
+			return ENCODING_INVALID_ARGUMENT;
+		}
+
+		uint64_t address = 0;
+		for (size_t k = 0; k < format->address_width; k += 1, i += 1) {
+			const uint8_t value = char_to_nybble[str[i]];
+			if (UNLIKELY(value > 0x0f)) {
+				return ENCODING_INVALID_ARGUMENT;
+			}
+
+			address = address << 4 | value;
+		}
+
+		if (UNLIKELY(address < undumper->base)) {
+			return ENCODING_INVALID_ARGUMENT;
+		}
+
+		position = address - undumper->base;
+
+		// hexdump ends with a line holding only the address following
+		// the data.
+		const bool has_suffix = string_length(line_suffix) != 0;
+		if (i == str_len ||
+				(has_suffix && undump_match(str_len, str, &i,
+							       line_suffix))) {
+			*pos = i;
+			return undump_write(undumper, position, 0, NULL);
+		}
+
+		if (UNLIKELY(!undump_match(str_len, str, &i,
+				    format->address_separator))) {
+			return ENCODING_INVALID_ARGUMENT;
+		}
+	}
+
+	uint8_t line[HEX_DUMP_MAX_BYTES_PER_ROW];
+	size_t  line_len = 0;
+
+	// Where the byte separator after the last byte started, in case the
+	// line ends there.
+	size_t separator = i;
+	while (line_len < bytes_per_row) {
+		// The line ends at the first column not holding a byte.
+		const size_t column = i;
+		if (!undump_match(str_len, str, &i, format->byte_prefix) ||
+				str_len - i < 2) {
+			i = column;
+			break;
+		}
+
+		const uint8_t hi = char_to_nybble[str[i]];
+		const uint8_t lo = char_to_nybble[str[i + 1]];
+		if ((hi | lo) > 0x0f) {
+			i = column;
+			break;
+		}
+
+		line[line_len] = (uint8_t)(hi << 4 | lo);
+		line_len += 1;
+		i += 2;
+
+		if (UNLIKELY(!undump_match(str_len, str, &i,
+				    format->byte_suffix))) {
+			return ENCODING_INVALID_ARGUMENT;
+		}
+
+		separator = i;
+		if (line_len % group_size == 0 || line_len == bytes_per_row) {
+			if (UNLIKELY(!undump_match(str_len, str, &i,
+					    format->group_separator))) {
+				return ENCODING_INVALID_ARGUMENT;
+			}
+		} else if (!undump_match(str_len, str, &i,
+					   format->byte_separator)) {
+			// Without an ASCII column, the last byte of a shorter
+			// line is followed by the group separator.
+			const char* separator = format->group_separator;
+			if (UNLIKELY(format->ascii ||
+					!undump_match(str_len, str, &i,
+							separator))) {
+				return ENCODING_INVALID_ARGUMENT;
+			}
+
+			break;
+		}
+	}
+
+	// Without an ASCII column, a line ending partway through a group ends
+	// in the group separator. The byte separator matched in its place
+	// could be a prefix of it, or empty.
+	if (!format->ascii && line_len != 0 && line_len % group_size != 0 &&
+			line_len < bytes_per_row) {
+		const size_t end = i;
+		i                = separator;
+		if (!undump_match(str_len, str, &i, format->group_separator)) {
+			i = end;
+		}
+	}
+
+	if (format->ascii) {
+		// The missing bytes are padded with spaces.
+		const size_t width = string_length(format->byte_prefix) + 2 +
+				     string_length(format->byte_suffix);
+		for (size_t k = line_len; k < bytes_per_row; k += 1) {
+			for (size_t l = 0; l < width; l += 1, i += 1) {
+				if (UNLIKELY(i == str_len ||
+						    str[i] != UTF8_SPACE)) {
+					return ENCODING_INVALID_ARGUMENT;
+				}
+			}
+
+			const char* separator = format->byte_separator;
+			if ((k + 1) % group_size == 0 ||
+					k + 1 == bytes_per_row) {
+				separator = format->group_separator;
+			}
+
+			if (UNLIKELY(!undump_match(
+					    str_len, str, &i, separator))) {
+				return ENCODING_INVALID_ARGUMENT;
+			}
+		}
+
+		if (UNLIKELY(!undump_match(str_len, str, &i,
+				    format->ascii_prefix))) {
+			return ENCODING_INVALID_ARGUMENT;
+		}
+
+		if (UNLIKELY(str_len - i < line_len)) {
+			return ENCODING_INVALID_ARGUMENT;
+		}
+
+		i += line_len;
+		if (UNLIKELY(!undump_match(str_len, str, &i,
+				    format->ascii_suffix))) {
+			return ENCODING_INVALID_ARGUMENT;
+		}
+	}
+
+	// The suffix of the last line can be left out.
+	if (UNLIKELY(i != str_len &&
+			!undump_match(str_len, str, &i, line_suffix))) {
+		return ENCODING_INVALID_ARGUMENT;
+	}
+
+	// Every line has to hold something, or else this would never end.
+	if (UNLIKELY(i == *pos)) {
+		return ENCODING_INVALID_ARGUMENT;
+	}
+
+	*pos = i;
+	return undump_write(undumper, position, line_len, line);
+}
+
+// Returns true if the whole line line belongs at position, which is the end
+// of the output so far, and the address following it fits.
+static bool
+undump_line_continues(const struct undumper* undumper,
+		const struct undump_layout* layout, const uint8_t* line,
+		const size_t position)
+{
+	const struct hex_dump_format* format = undumper->format;
+	const uint64_t                base   = undumper->base;
+	if (UNLIKELY(format->bytes_per_row > UINT64_MAX - base - position)) {
+		return false;
+	}
+
+	// Without addresses, every line follows the one before it.
+	if (format->address_width == 0) {
+		return true;
+	}
+
+	const uint8_t* digits  = &line[layout->address_start];
+	uint64_t       address = 0;
+	uint8_t        invalid = 0;
+	for (size_t i = 0; i < format->address_width; i += 1) {
+		const uint8_t value = char_to_nybble[digits[i]];
+		invalid |= value;
+		address = address << 4 | (value & 0x0f);
+	}
+
+	return invalid <= 0x0f && address >= base &&
+	       address - base == position;
+}
+
+// Checks and decodes as many whole lines starting at str[*pos] which continue
+// on from the output so far as possible, without parsing them, advancing *pos
+// past them. Their hexadecimal characters are gathered together so that
+// UNDUMP_BATCH_LEN bytes can be decoded at once. Anything else is left to
+// undump_line, including whole lines with invalid hexadecimal characters, so
+// that the result is the same as if every line was parsed.
+static void
+undump_lines(struct undumper* undumper, const struct undump_layout* layout,
+		const size_t str_len, const uint8_t* str, size_t* pos)
+{
+	const struct hex_dump_format* format        = undumper->format;
+	const size_t                  bytes_per_row = format->bytes_per_row;
+	const size_t                  check_len     = layout->check_len;
+	const size_t                  out_len =
+			undumper->out == NULL ? SIZE_MAX : undumper->out_len;
+
+	if (layout->line_len == 0 || undumper->squeeze) {
+		return;
+	}
+
+	uint8_t digits[UNDUMP_BATCH_LEN * 2];
+	while (true) {
+		size_t i   = *pos;
+		size_t len = 0;
+		while (len + bytes_per_row <= UNDUMP_BATCH_LEN &&
+				str_len - i >= check_len &&
+				undump_line_matches(layout, &str[i])) {
+			// Lines anywhere else are left to undump_line, which
+			// fills the gap before them.
+			const uint8_t* line     = &str[i];
+			const size_t   position = undumper->end + len;
+			if (bytes_per_row > out_len - position ||
+					!undump_line_continues(undumper,
+							layout, line,
+							position)) {
+				break;
+			}
+
+			if (undumper->out != NULL) {
+				undump_gather(layout, bytes_per_row * 2, line,
+						&digits[len * 2]);
+			}
+
+			len += bytes_per_row;
+			i += layout->line_len;
+		}
+
+		if (len == 0) {
+			return;
+		}
+
+		uint8_t* out = undumper->out;
+		if (out != NULL &&
+				!decode_pairs(len * 2, digits,
+						&out[undumper->end])) {
+			return;
+		}
+
+		undumper->last_start = undumper->end + len - bytes_per_row;
+		undumper->last_len   = bytes_per_row;
+		undumper->end += len;
+		*pos = i;
+	}
+}
+
+// Parses the str_len bytes of str as a dump in format, setting *end to the
+// length of the output. If out is NULL, the output is only counted.
+static int
+undump(const size_t str_len, const uint8_t* str, const size_t out_len,
+		uint8_t* out, const uint64_t base,
+		const struct hex_dump_format* format, size_t* end)
+{
+	struct undump_layout layout;
+	undump_layout_init(&layout, format);
+
+	struct undumper undumper;
+	undumper.format     = format;
+	undumper.base       = base;
+	undumper.out_len    = out_len;
+	undumper.out        = out;
+	undumper.end        = 0;
+	undumper.last_start = 0;
+	undumper.last_len   = 0;
+	undumper.squeeze    = false;
+
+	int    err = 0;
+	size_t pos = 0;
+	while (pos < str_len) {
+		undump_lines(&undumper, &layout, str_len, str, &pos);
+		if (pos == str_len) {
+			break;
+		}
+
+		err = undump_line(&undumper, str_len, str, &pos);
+		if (UNLIKELY(err != 0)) {
+			break;
+		}
+	}
+
+	// A '*' line is always followed by the address it repeats until.
+	if (UNLIKELY(err == 0 && undumper.squeeze)) {
+		err = ENCODING_INVALID_ARGUMENT;
+	}
+
+	*end = undumper.end;
+	return err;
+}
+
+ENCODING_PUBLIC
+size_t
+hex_undump_formatted_length(const size_t str_len, const uint8_t* str,
+		const uint64_t offset, const struct hex_dump_format* format)
+{
+	assert(str_len == 0 || str != NULL);
+	assert(format != NULL);
+
+	size_t result = 0;
+	if (UNLIKELY(!format_valid(format))) {
+		return result;
+	}
+
+	(void)undump(str_len, str, 0, NULL, offset, format, &result);
+	return result;
+}
+
+ENCODING_PUBLIC
+int
+hex_undump_formatted(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out, uint64_t* offset,
+		const struct hex_dump_format* format, size_t* written)
+{
+	assert(format != NULL);
+
+	if (written != NULL) {
+		*written = 0;
+	}
+
+	if (UNLIKELY(!format_valid(format))) {
+		return ENCODING_INVALID_ARGUMENT;
+	}
+
+	if (UNLIKELY(str_len == 0)) {
+		return 0;
+	}
+
+	assert(str != NULL);
+	assert(out != NULL);
+
+	uint64_t base = 0;
+	if (offset != NULL) {
+		base = *offset;
+	}
+
+	size_t len = 0;
+	int    err = undump(str_len, str, out_len, out, base, format, &len);
+	if (UNLIKELY(err != 0)) {
+		return err;
+	}
+
+	if (offset != NULL) {
+		*offset = base + len;
+	}
+
+	if (written != NULL) {
+		*written = len;
+	}
+
+	return 0;
+}
+
+ENCODING_PUBLIC
+size_t
+hex_undump_length(const size_t str_len, const uint8_t* str,
+		const uint64_t offset)
+{
+	return hex_undump_formatted_length(
+			str_len, str, offset, &hex_dump_format_canonical);
+}
+
+ENCODING_PUBLIC
+int
+hex_undump(const size_t str_len, const uint8_t* str, const size_t out_len,
+		uint8_t* out, uint64_t* offset, size_t* written)
+{
+	return hex_undump_formatted(str_len, str, out_len, out, offset,
+			&hex_dump_format_canonical, written);
 }
 
 #if defined(__cplusplus)
@@ -6,9 +6,9 @@
 // encoding/hex.h provides functions for encoding and decoding binary data into
 // a string of hexadecimal characters. This is also known as base16.
 //
-// The functions hex_decoded_length and hex_decode
-// both assume the input is a valid hex string, so be sure to validate their
-// input using hex_valid before use.
+// hex_decoded_length assumes the input is a valid hex string, so be sure to
+// validate its input using hex_valid before use. hex_decode checks its input
+// while decoding it, so untrusted input can be decoded in a single pass.
 //
 // The accepted characters in a hex string are '0' to '9', 'a' to 'f', and 'A'
 // to 'F'.
@@ -33,6 +33,26 @@
 extern "C" {
 #endif
 
+#if !defined(ENCODING_EXECUTOR)
+#define ENCODING_EXECUTOR
+
+// encoding_executor describes how the *_parallel functions should run their
+// work, so that they can use whatever threads the caller already has instead
+// of the library starting its own.
+//
+// run must call task(context, i) once for every i from 0 to count - 1,
+// possibly concurrently, and only return once every call has returned. user
+// is passed to run unchanged. The input is split into at most concurrency
+// tasks, so it should usually be the number of threads available.
+struct encoding_executor {
+	void (*run)(void* user, size_t count,
+			void (*task)(void* context, size_t index),
+			void* context);
+	void*  user;
+	size_t concurrency;
+};
+#endif // !defined(ENCODING_EXECUTOR)
+
 // hex_valid checks if the first str_len bytes of str only contain pairs of
 // hexadecimal characters.
 ENCODING_PUBLIC
@@ -58,6 +78,12 @@ ENCODING_PUBLIC
 int hex_encode(const size_t str_len, const uint8_t* str, const size_t out_len,
 		uint8_t* out);
 
+// hex_encode_upper is the same as hex_encode, but writes the letters 'A' to
+// 'F' in uppercase.
+ENCODING_PUBLIC
+int hex_encode_upper(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out);
+
 // hex_decoded_length counts the number of bytes needed to decode len bytes of
 // a hexadecimal string into binary data.
 //
@@ -69,11 +95,7 @@ size_t hex_decoded_length(const size_t len);
 // hex_decode decodes the first str_len bytes of the string of hexadecimal
 // characters str into the first out_len bytes of out.
 //
-// Assumes the string in str is a valid string of hexadecimal characters. It is
-// undefined behaviour what the result is when str is not valid. To check if
-// str is valid, hex_valid should be called.
-//
-// out and str must not be NULL.
+// out and str must not be NULL unless str_len is 0.
 //
 // On success, returns 0.
 // On failure, returns one of the negative error values below:
@@ -83,13 +105,134 @@ size_t hex_decoded_length(const size_t len);
 //      bytes are needed to encode the data, call hex_encoded_length.
 //
 // ENCODING_INVALID_ARGUMENT
-//	str_len is not a multiple of 2.
+//	str_len is not a multiple of 2, or str contains a character which is
+//	not hexadecimal. The contents of out are unspecified.
 ENCODING_PUBLIC
 int hex_decode(const size_t str_len, const uint8_t* str, const size_t out_len,
 		uint8_t* out);
 
-// hex_dump_length counts the number of bytes needed to contain len bytes in a
-// formatted dump output produced by hex_dump.
+// hex_decode_in_place decodes the first str_len bytes of the string of
+// hexadecimal characters str like hex_decode, writing the decoded data over
+// the start of str. If out_len is not NULL, *out_len is set to the length of
+// the decoded data.
+//
+// str must not be NULL unless str_len is 0.
+//
+// On success, returns 0.
+// On failure, returns one of the negative error values below:
+//
+// ENCODING_INVALID_ARGUMENT
+//	str_len is not a multiple of 2, or str contains a character which is
+//	not hexadecimal. The contents of str are unspecified.
+ENCODING_PUBLIC
+int hex_decode_in_place(const size_t str_len, uint8_t* str, size_t* out_len);
+
+// hex_encode_parallel is the same as hex_encode, but splits the input into
+// chunks which are encoded concurrently using executor. If executor is NULL,
+// or the input is too small to be worth splitting, the input is encoded on
+// the calling thread.
+ENCODING_PUBLIC
+int hex_encode_parallel(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out,
+		const struct encoding_executor* executor);
+
+// hex_decode_parallel is the same as hex_decode, but splits the input into
+// chunks which are decoded concurrently using executor. If executor is NULL,
+// or the input is too small to be worth splitting, the input is decoded on
+// the calling thread.
+ENCODING_PUBLIC
+int hex_decode_parallel(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out,
+		const struct encoding_executor* executor);
+
+// The largest bytes_per_row a hex_dump_format can have.
+#define HEX_DUMP_MAX_BYTES_PER_ROW 64
+
+// hex_dump_format describes the layout of each line of hex_dump_formatted
+// output, so that dumps in formats other than hex_dump's can be made in a
+// single pass.
+//
+// Each line is made of line_prefix, the low address_width hexadecimal digits
+// of the address of its first byte followed by address_separator, and then
+// each byte written as byte_prefix, two hexadecimal digits and byte_suffix.
+// The bytes are split into groups of group_size. Each byte is followed by
+// byte_separator, except the last byte of each group, which is followed by
+// group_separator instead. If ascii is true, then ascii_prefix, the bytes of
+// the line with any which aren't printable replaced by '.', and ascii_suffix
+// follow. Finally, the line ends with line_suffix.
+//
+// If ascii is true, the missing bytes of the last line are written as spaces
+// so that the ASCII column lines up with the lines above it. If address_width
+// is 0, the address and address_separator are left out. NULL strings are
+// treated as empty.
+//
+// bytes_per_row must be between 1 and HEX_DUMP_MAX_BYTES_PER_ROW, group_size
+// must not be 0 and address_width must be at most 16.
+struct hex_dump_format {
+	size_t      bytes_per_row;
+	size_t      group_size;
+	size_t      address_width;
+	bool        ascii;
+	bool        uppercase;
+	const char* line_prefix;
+	const char* address_separator;
+	const char* byte_prefix;
+	const char* byte_suffix;
+	const char* byte_separator;
+	const char* group_separator;
+	const char* ascii_prefix;
+	const char* ascii_suffix;
+	const char* line_suffix;
+};
+
+// The format used by hex_dump, which is the same as "hexdump -C".
+ENCODING_PUBLIC
+extern const struct hex_dump_format hex_dump_format_canonical;
+
+// The format used by xxd, with the bytes in groups of 2.
+ENCODING_PUBLIC
+extern const struct hex_dump_format hex_dump_format_xxd;
+
+// The format used by "od -An -tx1", with no addresses or ASCII column.
+ENCODING_PUBLIC
+extern const struct hex_dump_format hex_dump_format_od;
+
+// A format which writes the bytes as the body of a C array initializer, 12
+// bytes to a line, like "xxd -i".
+ENCODING_PUBLIC
+extern const struct hex_dump_format hex_dump_format_c_array;
+
+// hex_dump_formatted_length returns the exact number of bytes
+// hex_dump_formatted writes when given len bytes and format.
+//
+// format must not be NULL, and must be valid as described by
+// hex_dump_format.
+ENCODING_PUBLIC
+size_t hex_dump_formatted_length(
+		const size_t len, const struct hex_dump_format* format);
+
+// hex_dump_formatted is the same as hex_dump, but uses the layout described
+// by format.
+//
+// format must not be NULL.
+//
+// On success, returns 0.
+// On failure, returns one of the negative error values below:
+//
+// ENCODING_BUFFER_TOO_SMALL
+// 	out_len was too small to hold the encoded data. To find out how many
+//	bytes are needed to encode the data, call hex_dump_formatted_length.
+//
+// ENCODING_INVALID_ARGUMENT
+//	format was not valid, or the starting address specified in *offset
+//	would overflow given the input data.
+ENCODING_PUBLIC
+int hex_dump_formatted(const size_t buf_len, const uint8_t* buf,
+		const size_t out_len, uint8_t* out, uint64_t* offset,
+		const struct hex_dump_format* format);
+
+// hex_dump_length returns the exact number of bytes hex_dump writes when
+// given len bytes.
 ENCODING_PUBLIC
 size_t hex_dump_length(const size_t len);
 
@@ -98,9 +241,12 @@ size_t hex_dump_length(const size_t len);
 //
 // If offset != NULL, the value pointed to by offset will be used as the first
 // address in the output, and the next address which would be printed had there
-// been more input will be placed in *output.
+// been more input will be placed in *offset. This way, input which is a
+// multiple of 16 bytes long can be dumped in pieces. To dump input which
+// arrives in pieces of any size, use hex_dumper.
 //
-// out and buf must not be NULL.
+// out and buf must not be NULL unless buf_len is 0. hex_dump can be called
+// from multiple threads at once.
 //
 // If offset is NULL, 0 will be displayed as the first address.
 //
@@ -124,6 +270,153 @@ ENCODING_PUBLIC
 int hex_dump(const size_t buf_len, const uint8_t* buf, const size_t out_len,
 		uint8_t* out, uint64_t* offset);
 
+// hex_dumper holds the state needed to dump data which arrives in chunks of
+// any size. Each whole line is formatted directly into the output buffer, and
+// the bytes of the last line are kept until the next call. The output is the
+// same as hex_dump's, or hex_dump_formatted's, for all of the input at once.
+//
+// Its members should be considered private.
+struct hex_dumper {
+	const struct hex_dump_format* format;
+	uint64_t                      address;
+	uint8_t                       line[HEX_DUMP_MAX_BYTES_PER_ROW];
+	uint8_t                       line_len;
+};
+
+// hex_dumper_init initializes dumper to start dumping at the address offset,
+// using hex_dump_format_canonical.
+//
+// dumper must not be NULL.
+ENCODING_PUBLIC
+void hex_dumper_init(struct hex_dumper* dumper, const uint64_t offset);
+
+// hex_dumper_init_formatted initializes dumper to start dumping at the
+// address offset, using format. format must remain valid until dumping is
+// finished.
+//
+// dumper and format must not be NULL.
+//
+// On success, returns 0.
+// On failure, returns one of the negative error values below:
+//
+// ENCODING_INVALID_ARGUMENT
+//	format was not valid.
+ENCODING_PUBLIC
+int hex_dumper_init_formatted(struct hex_dumper* dumper,
+		const uint64_t offset, const struct hex_dump_format* format);
+
+// hex_dumper_update_length returns the number of bytes hex_dumper_update
+// will write when given buf_len bytes.
+//
+// dumper must not be NULL.
+ENCODING_PUBLIC
+size_t hex_dumper_update_length(
+		const struct hex_dumper* dumper, const size_t buf_len);
+
+// hex_dumper_update formats every line completed by the next buf_len bytes of
+// buf, writing at most out_len bytes to out. If written is not NULL, *written
+// is set to the number of bytes written to out.
+//
+// dumper must not be NULL. buf must not be NULL unless buf_len is 0.
+//
+// On success, returns 0.
+// On failure, returns one of the negative error values below:
+//
+// ENCODING_BUFFER_TOO_SMALL
+//	out_len was too small to hold the formatted lines. To find out how
+//	large the output buffer should be, call hex_dumper_update_length.
+//	Nothing is consumed from buf.
+//
+// ENCODING_INVALID_ARGUMENT
+//	The address would overflow given the input data. Nothing is consumed
+//	from buf.
+ENCODING_PUBLIC
+int hex_dumper_update(struct hex_dumper* dumper, const size_t buf_len,
+		const uint8_t* buf, const size_t out_len, uint8_t* out,
+		size_t* written);
+
+// hex_dumper_final formats the last line, if the input so far didn't end on
+// a whole line, writing at most out_len bytes to out. If written is not NULL,
+// *written is set to the number of bytes written to out. Afterwards, dumper
+// continues from the address following the input so far.
+//
+// dumper must not be NULL.
+//
+// On success, returns 0.
+// On failure, returns one of the negative error values below:
+//
+// ENCODING_BUFFER_TOO_SMALL
+//	out_len was too small to hold the last line. When using
+//	hex_dump_format_canonical, an out_len of 79 is always enough.
+ENCODING_PUBLIC
+int hex_dumper_final(struct hex_dumper* dumper, const size_t out_len,
+		uint8_t* out, size_t* written);
+
+// hex_undump_formatted_length returns the number of bytes
+// hex_undump_formatted writes when given the first str_len bytes of str,
+// using offset as the address of the first byte of the output.
+//
+// Assumes str is a valid dump in the layout described by format. str must
+// not be NULL unless str_len is 0, and format must not be NULL.
+ENCODING_PUBLIC
+size_t hex_undump_formatted_length(const size_t str_len, const uint8_t* str,
+		const uint64_t offset, const struct hex_dump_format* format);
+
+// hex_undump_formatted turns the first str_len bytes of str, which is a dump
+// in the layout described by format, back into the bytes it was made from,
+// writing at most out_len bytes to out. If written is not NULL, *written is
+// set to the number of bytes written to out.
+//
+// If format has an address column, each line is written to out at its
+// address minus the address of the first byte of out, so dumps of sparse
+// data or of data which didn't start at address 0 are reconstructed as they
+// were. Any gap before a line is filled with zeroes. Like "hexdump -C", a
+// line holding only '*' repeats the line before it until the address of the
+// line after it, and a line holding only an address ends the data at that
+// address. Without an address column, the lines follow one another.
+//
+// If offset != NULL, *offset is used as the address of the first byte of
+// out, and on success is set to the address following the last byte written.
+// If offset is NULL, the first byte of out has the address 0.
+//
+// The lines can be any length up to format->bytes_per_row, so the output of
+// several calls to hex_dump_formatted or a hex_dumper can be given at once.
+// Addresses are read as exactly format->address_width digits, and the line
+// suffix of the last line may be left out. The ASCII column isn't checked
+// beyond its length.
+//
+// out and str must not be NULL unless str_len is 0. format must not be NULL.
+//
+// On success, returns 0.
+// On failure, returns one of the negative error values below:
+//
+// ENCODING_BUFFER_TOO_SMALL
+//	out_len was too small to hold the data. To find out how many bytes
+//	are needed, call hex_undump_formatted_length. Part of the output might
+//	have been written.
+//
+// ENCODING_INVALID_ARGUMENT
+//	format was not valid, str doesn't follow format, an address is lower
+//	than the address of the first byte of out, or the address following
+//	the data would overflow. Part of the output might have been written.
+ENCODING_PUBLIC
+int hex_undump_formatted(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint8_t* out, uint64_t* offset,
+		const struct hex_dump_format* format, size_t* written);
+
+// hex_undump_length is the same as hex_undump_formatted_length, using
+// hex_dump_format_canonical.
+ENCODING_PUBLIC
+size_t hex_undump_length(const size_t str_len, const uint8_t* str,
+		const uint64_t offset);
+
+// hex_undump is the same as hex_undump_formatted, using
+// hex_dump_format_canonical. It turns the output of hex_dump or "hexdump -C"
+// back into the bytes it was made from, like "xxd -r" does for xxd.
+ENCODING_PUBLIC
+int hex_undump(const size_t str_len, const uint8_t* str, const size_t out_len,
+		uint8_t* out, uint64_t* offset, size_t* written);
+
 #ifdef __cplusplus
 }
 #endif
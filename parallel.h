@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#ifndef ENCODING_PARALLEL_H
+#define ENCODING_PARALLEL_H
+
+// This file contains the parts of the *_parallel functions shared between
+// the modules. It must be included after compiler_extensions.h and the
+// module's own header, which defines struct encoding_executor.
+
+#include <stddef.h>
+
+// The least amount of input given to each task by the *_parallel functions,
+// since splitting up less than this costs more than it saves.
+#define PARALLEL_MIN_CHUNK_LEN 65536
+
+// The most tasks the *_parallel functions split their input into.
+#define PARALLEL_MAX_TASKS 64
+
+// Returns the length of the chunks len bytes should be split into to be run
+// by executor. The result is a multiple of block_len.
+static inline size_t
+parallel_chunk_len(const size_t len, const size_t block_len,
+		const struct encoding_executor* executor)
+{
+	size_t tasks = executor->concurrency;
+	if (tasks > PARALLEL_MAX_TASKS) {
+		tasks = PARALLEL_MAX_TASKS;
+	} else if (tasks == 0) {
+		tasks = 1;
+	}
+
+	size_t result = len / tasks + (len % tasks != 0);
+	if (result < PARALLEL_MIN_CHUNK_LEN) {
+		result = PARALLEL_MIN_CHUNK_LEN;
+	}
+
+	return (result + block_len - 1) / block_len * block_len;
+}
+
+// Returns the first error in results, or 0 if there were none.
+static inline int
+parallel_result(const size_t num_tasks, const int* results)
+{
+	for (size_t i = 0; i < num_tasks; i += 1) {
+		if (UNLIKELY(results[i] != 0)) {
+			return results[i];
+		}
+	}
+
+	return 0;
+}
+
+#endif // ENCODING_PARALLEL_H
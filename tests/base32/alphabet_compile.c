@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base32/base32.h"
+#include "common.h"
+
+// ASCII 'a' to 'z' followed by '0' to '5'.
+static const uint8_t sample_alphabet[32] = {
+		0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+		0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72, 0x73, 0x74,
+		0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x30, 0x31, 0x32, 0x33,
+		0x34, 0x35,
+};
+
+int
+main()
+{
+	struct base32_alphabet compiled;
+
+	assert(base32_alphabet_compile(base32, &compiled) == 0);
+	assert(base32_alphabet_compile(base32hex, &compiled) == 0);
+	assert(base32_alphabet_compile(base32crockford, &compiled) == 0);
+	assert(base32_alphabet_compile(sample_alphabet, &compiled) == 0);
+	assert(mem_equal(compiled.encode, sample_alphabet, 32));
+
+	// Duplicate characters aren't allowed.
+	uint8_t bad_alphabet[32];
+	for (size_t i = 0; i < 32; i += 1) {
+		bad_alphabet[i] = sample_alphabet[i];
+	}
+
+	bad_alphabet[31] = sample_alphabet[0];
+	assert(base32_alphabet_compile(bad_alphabet, &compiled) ==
+			ENCODING_INVALID_ARGUMENT);
+
+	// Neither is the padding character.
+	bad_alphabet[31] = 0x3d;
+	assert(base32_alphabet_compile(bad_alphabet, &compiled) ==
+			ENCODING_INVALID_ARGUMENT);
+}
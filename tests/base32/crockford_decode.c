@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../../base32/base32.h"
+#include "common.h"
+
+int
+main()
+{
+	// "foobar"
+	const uint8_t foobar[] = {0x66, 0x6f, 0x6f, 0x62, 0x61, 0x72};
+	// "csqp-yrkl-e8r", which is "CSQPYRK1E8" with check symbol 'R'
+	// written in lowercase, with hyphens and with 'L' in place of '1'.
+	const uint8_t foobar_forgiving[] = {0x63, 0x73, 0x71, 0x70, 0x2d,
+			0x79, 0x72, 0x6b, 0x6c, 0x2d, 0x65, 0x38, 0x72};
+
+	uint8_t out[64];
+	size_t  written = 0;
+	assert(base32crockford_decode(ARRAY_SIZEOF(foobar_forgiving),
+			       foobar_forgiving, ARRAY_SIZEOF(out), out, true,
+			       &written) == 0);
+	assert(written == ARRAY_SIZEOF(foobar));
+	assert(mem_equal(out, foobar, ARRAY_SIZEOF(foobar)));
+
+	// Without the check symbol, the 'r' at the end is a data symbol, which
+	// leaves 11 symbols.
+	int err = base32crockford_decode(ARRAY_SIZEOF(foobar_forgiving),
+			foobar_forgiving, ARRAY_SIZEOF(out), out, false, NULL);
+	assert(err == ENCODING_INVALID_ARGUMENT);
+	err = base32crockford_decode(ARRAY_SIZEOF(foobar_forgiving) - 1,
+			foobar_forgiving, ARRAY_SIZEOF(out), out, false,
+			&written);
+	assert(err == 0);
+	assert(written == ARRAY_SIZEOF(foobar));
+	assert(mem_equal(out, foobar, ARRAY_SIZEOF(foobar)));
+
+	// "0OoIiLl1-" decodes to the same bits as "00011111", ignoring the
+	// hyphen.
+	const uint8_t confusable[] = {
+			0x30, 0x4f, 0x6f, 0x49, 0x69, 0x4c, 0x6c, 0x31, 0x2d};
+	const uint8_t confusable_decoded[] = {0x00, 0x00, 0x10, 0x84, 0x21};
+	assert(base32crockford_decode(ARRAY_SIZEOF(confusable), confusable,
+			       ARRAY_SIZEOF(out), out, false, &written) == 0);
+	assert(written == ARRAY_SIZEOF(confusable_decoded));
+	assert(mem_equal(out, confusable_decoded,
+			ARRAY_SIZEOF(confusable_decoded)));
+
+	// Round trip every length with and without a check symbol, and check
+	// that every wrong check symbol is rejected.
+	uint8_t input[100];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 37 + 11);
+	}
+
+	uint8_t encoded[168];
+	uint8_t decoded[100];
+	for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+		for (int check = 0; check < 2; check += 1) {
+			const size_t encoded_len =
+					base32crockford_encoded_length(
+							len, check != 0);
+			assert(base32crockford_encode(len, input,
+					       ARRAY_SIZEOF(encoded), encoded,
+					       check != 0) == 0);
+			written = 0;
+			assert(base32crockford_decode(encoded_len, encoded,
+					       ARRAY_SIZEOF(decoded), decoded,
+					       check != 0, &written) == 0);
+			assert(written == len);
+			assert(mem_equal(decoded, input, len));
+		}
+
+		// "0123456789ABCDEFGHJKMNPQRSTVWXYZ*~$=U"
+		const uint8_t check_symbols[] = {0x30, 0x31, 0x32, 0x33,
+				0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x41, 0x42,
+				0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x4a, 0x4b,
+				0x4d, 0x4e, 0x50, 0x51, 0x52, 0x53, 0x54, 0x56,
+				0x57, 0x58, 0x59, 0x5a, 0x2a, 0x7e, 0x24, 0x3d,
+				0x55};
+		const size_t  check_index =
+				base32crockford_encoded_length(len, false);
+		const uint8_t correct = encoded[check_index];
+		for (size_t i = 0; i < ARRAY_SIZEOF(check_symbols); i += 1) {
+			encoded[check_index] = check_symbols[i];
+			err = base32crockford_decode(check_index + 1, encoded,
+					ARRAY_SIZEOF(decoded), decoded, true,
+					NULL);
+			assert((err == 0) == (check_symbols[i] == correct));
+		}
+	}
+
+	// Padded input from base32_decode is accepted, and base32_decode still
+	// accepts the forgiving forms.
+	uint8_t padded[168];
+	for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+		const size_t encoded_len = base32_encoded_length(len);
+		assert(base32_encode(len, input, ARRAY_SIZEOF(padded), padded,
+				       base32crockford) == 0);
+		assert(base32crockford_decode(encoded_len, padded,
+				       ARRAY_SIZEOF(decoded), decoded, false,
+				       &written) == 0);
+		assert(written == len);
+		assert(mem_equal(decoded, input, len));
+	}
+
+	assert(base32_decode(ARRAY_SIZEOF(confusable) - 1, confusable,
+			       ARRAY_SIZEOF(out), out, base32crockford) == 0);
+	assert(mem_equal(out, confusable_decoded,
+			ARRAY_SIZEOF(confusable_decoded)));
+
+	// Invalid input
+
+	// "CSQPYRK1E8=" has the wrong amount of padding.
+	const uint8_t bad_padding[] = {0x43, 0x53, 0x51, 0x50, 0x59, 0x52,
+			0x4b, 0x31, 0x45, 0x38, 0x3d};
+	assert(base32crockford_decode(ARRAY_SIZEOF(bad_padding), bad_padding,
+			       ARRAY_SIZEOF(out), out, false,
+			       NULL) == ENCODING_INVALID_ARGUMENT);
+
+	// "CSQ" can't be the end of a group.
+	assert(base32crockford_decode(3, bad_padding, ARRAY_SIZEOF(out), out,
+			       false, NULL) == ENCODING_INVALID_ARGUMENT);
+
+	// "CS*P" uses a check symbol as data.
+	const uint8_t check_as_data[] = {0x43, 0x53, 0x2a, 0x50};
+	assert(base32crockford_decode(ARRAY_SIZEOF(check_as_data),
+			       check_as_data, ARRAY_SIZEOF(out), out, false,
+			       NULL) == ENCODING_INVALID_ARGUMENT);
+
+	// "CSUP" uses 'U', which is only a check symbol.
+	const uint8_t with_u[] = {0x43, 0x53, 0x55, 0x50};
+	assert(base32crockford_decode(ARRAY_SIZEOF(with_u), with_u,
+			       ARRAY_SIZEOF(out), out, false,
+			       NULL) == ENCODING_INVALID_ARGUMENT);
+
+	assert(base32crockford_decode(ARRAY_SIZEOF(foobar_forgiving),
+			       foobar_forgiving, ARRAY_SIZEOF(foobar) - 1, out,
+			       true, NULL) == ENCODING_BUFFER_TOO_SMALL);
+
+	// Edge cases
+
+	written = 1;
+	assert(base32crockford_decode(0, NULL, 0, NULL, false, &written) ==
+			0);
+	assert(written == 0);
+	assert(base32crockford_decode(0, NULL, 0, NULL, true, NULL) ==
+			ENCODING_INVALID_ARGUMENT);
+}
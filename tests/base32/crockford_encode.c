@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../../base32/base32.h"
+#include "common.h"
+
+int
+main()
+{
+	// "foobar"
+	const uint8_t foobar[] = {0x66, 0x6f, 0x6f, 0x62, 0x61, 0x72};
+	// "CSQPYRK1E8"
+	const uint8_t foobar_encoded[] = {
+			0x43, 0x53, 0x51, 0x50, 0x59, 0x52, 0x4b, 0x31, 0x45,
+			0x38};
+	// "hello"
+	const uint8_t hello[] = {0x68, 0x65, 0x6c, 0x6c, 0x6f};
+	// "D1JPRV3FJ", where the 'J' at the end is the check symbol.
+	const uint8_t hello_encoded[] = {
+			0x44, 0x31, 0x4a, 0x50, 0x52, 0x56, 0x33, 0x46, 0x4a};
+
+	uint8_t out[64];
+	assert(base32crockford_encoded_length(ARRAY_SIZEOF(foobar), false) ==
+			ARRAY_SIZEOF(foobar_encoded));
+	assert(base32crockford_encode(ARRAY_SIZEOF(foobar), foobar,
+			       ARRAY_SIZEOF(out), out, false) == 0);
+	assert(mem_equal(out, foobar_encoded, ARRAY_SIZEOF(foobar_encoded)));
+
+	// The check symbol of "CSQPYRK1E8" is 'R'.
+	mem_set(out, 0, ARRAY_SIZEOF(out));
+	assert(base32crockford_encode(ARRAY_SIZEOF(foobar), foobar,
+			       ARRAY_SIZEOF(out), out, true) == 0);
+	assert(mem_equal(out, foobar_encoded, ARRAY_SIZEOF(foobar_encoded)));
+	assert(out[ARRAY_SIZEOF(foobar_encoded)] == 0x52);
+	assert(out[ARRAY_SIZEOF(foobar_encoded) + 1] == 0);
+
+	assert(base32crockford_encoded_length(ARRAY_SIZEOF(hello), true) ==
+			ARRAY_SIZEOF(hello_encoded));
+	assert(base32crockford_encode(ARRAY_SIZEOF(hello), hello,
+			       ARRAY_SIZEOF(out), out, true) == 0);
+	assert(mem_equal(out, hello_encoded, ARRAY_SIZEOF(hello_encoded)));
+
+	// The output without a check symbol is base32_encode's without the
+	// padding, for every length.
+	uint8_t input[100];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 37 + 11);
+	}
+
+	uint8_t padded[168];
+	uint8_t unpadded[168];
+	for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+		assert(base32_encode(len, input, ARRAY_SIZEOF(padded), padded,
+				       base32crockford) == 0);
+		const size_t encoded_len =
+				base32crockford_encoded_length(len, false);
+		assert(base32crockford_encode(len, input, encoded_len,
+				       unpadded, false) == 0);
+		assert(mem_equal(padded, unpadded, encoded_len));
+		for (size_t i = encoded_len; i < base32_encoded_length(len);
+				i += 1) {
+			assert(padded[i] == 0x3d); // '='
+		}
+	}
+
+	// Edge cases
+
+	assert(base32crockford_encoded_length(0, false) == 0);
+	assert(base32crockford_encoded_length(0, true) == 1);
+	assert(base32crockford_encode(0, NULL, 0, NULL, false) == 0);
+	assert(base32crockford_encode(0, NULL, 1, out, true) == 0);
+	assert(out[0] == 0x30); // '0'
+	assert(base32crockford_encode(ARRAY_SIZEOF(foobar), foobar,
+			       ARRAY_SIZEOF(foobar_encoded), out,
+			       true) == ENCODING_BUFFER_TOO_SMALL);
+	assert(base32crockford_encode(ARRAY_SIZEOF(hello), hello, 0, out,
+			       false) == ENCODING_BUFFER_TOO_SMALL);
+}
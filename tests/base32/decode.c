@@ -16,6 +16,85 @@ static const uint8_t sample_alphabet[32] = {
 		//
 };
 
+// Decodes str one character at a time, as a reference. Returns the number of
+// bytes written, or ENCODING_INVALID_ARGUMENT if a character before the
+// padding isn't part of alphabet.
+static int
+reference_decode(const size_t str_len, const uint8_t* str, uint8_t* out,
+		const uint8_t alphabet[32])
+{
+	uint32_t bits     = 0;
+	int      num_bits = 0;
+	int      j        = 0;
+	for (size_t i = 0; i < str_len && str[i] != 0x3d; i += 1) {
+		size_t value = 0;
+		while (value < 32 && alphabet[value] != str[i]) {
+			value += 1;
+		}
+
+		if (value == 32) {
+			return ENCODING_INVALID_ARGUMENT;
+		}
+
+		bits = (bits << 5 | (uint32_t)value) & 0xfff;
+		num_bits += 5;
+		if (num_bits >= 8) {
+			num_bits -= 8;
+			out[j] = (uint8_t)(bits >> num_bits);
+			j += 1;
+		}
+	}
+
+	return j;
+}
+
+// Decodes len characters ending in num_padding padding characters, with
+// every byte other than the padding character put in every position before
+// the padding, and checks the result against reference_decode.
+static void
+check_blocks(const size_t len, const size_t num_padding,
+		const uint8_t alphabet[32])
+{
+	uint8_t str[88];
+	for (size_t i = 0; i < len; i += 1) {
+		str[i] = i < len - num_padding ? alphabet[(i * 7 + 3) % 32]
+					       : 0x3d;
+	}
+
+	uint8_t expected[55];
+	uint8_t got[56];
+	for (size_t i = 0; i < len - num_padding; i += 1) {
+		for (size_t c = 0; c < 256; c += 1) {
+			if (c == 0x3d) {
+				continue;
+			}
+
+			const uint8_t old = str[i];
+			str[i]            = (uint8_t)c;
+
+			const int n = reference_decode(len, str, expected,
+					alphabet);
+			mem_set(got, 0xaa, ARRAY_SIZEOF(got));
+			const int err = base32_decode(len, str,
+					ARRAY_SIZEOF(got), got, alphabet);
+			if (n < 0) {
+				assert(err == ENCODING_INVALID_ARGUMENT);
+			} else {
+				assert(err == 0);
+				assert(mem_equal(got, expected, (size_t)n));
+
+				// Nothing past the decoded bytes is written.
+				const size_t end = ARRAY_SIZEOF(got);
+				for (size_t j = (size_t)n; j < end; j += 1) {
+					assert(got[j] == 0xaa);
+				}
+			}
+
+			str[i] = old;
+		}
+	}
+}
+
 int
 main()
 {
@@ -91,6 +170,29 @@ main()
 	assert(base32_decode(3, rfc4648_cases[0], ARRAY_SIZEOF(out), out,
 			       base32) != 0);
 
+	// The encoder only ever writes 6, 4, 3 or 1 padding characters, so
+	// the other amounts are invalid.
+	const uint8_t* bad_padding[] = {
+			(const uint8_t*)"MZX=====",
+			(const uint8_t*)"MZXW6Y==",
+			(const uint8_t*)"M=======",
+	};
+	for (size_t i = 0; i < ARRAY_SIZEOF(bad_padding); i += 1) {
+		assert(base32_decode(8, bad_padding[i], ARRAY_SIZEOF(out), out,
+				       base32) == ENCODING_INVALID_ARGUMENT);
+	}
+
+	// A padded final group only writes the bytes it decodes to.
+	for (size_t i = 1; i < 5; i += 1) {
+		mem_set(out, 0xaa, ARRAY_SIZEOF(out));
+		assert(base32_decode(lens[i], rfc4648_cases[i],
+				       ARRAY_SIZEOF(out), out, base32) == 0);
+		assert(mem_equal(key, out, i));
+		for (size_t j = i; j < ARRAY_SIZEOF(out); j += 1) {
+			assert(out[j] == 0xaa);
+		}
+	}
+
 	// Edge cases
 
 	assert(base32_decode(0, NULL, 0, NULL, base32) == 0);
@@ -98,4 +200,22 @@ main()
 			ENCODING_BUFFER_TOO_SMALL);
 	assert(base32_decode(lens[1], rfc4648_cases[1], 0, NULL, base32) ==
 			ENCODING_BUFFER_TOO_SMALL);
+
+	// The vectorized decoders take 32 and then 16 characters at a time,
+	// leaving the rest to the scalar loop 8 at a time, and a padded
+	// last group is always decoded separately. Try every byte in every
+	// position of every whole number of groups up to 88 characters, with
+	// each amount of padding, so that every way of splitting the input
+	// between them is covered.
+	const uint8_t* builtins[] = {base32, base32hex};
+	const size_t   paddings[] = {0, 1, 3, 4, 6};
+	for (size_t i = 0; i < ARRAY_SIZEOF(builtins); i += 1) {
+		const uint8_t* alphabet = builtins[i];
+
+		for (size_t j = 0; j < ARRAY_SIZEOF(paddings); j += 1) {
+			for (size_t len = 8; len <= 88; len += 8) {
+				check_blocks(len, paddings[j], alphabet);
+			}
+		}
+	}
 }
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base32/base32.h"
+#include "common.h"
+
+// ASCII 'a' to 'z' followed by '0' to '5'.
+static const uint8_t sample_alphabet[32] = {
+		0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+		0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72, 0x73, 0x74,
+		0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x30, 0x31, 0x32, 0x33,
+		0x34, 0x35,
+};
+
+static bool
+in_alphabet(const uint8_t alphabet[32], const uint8_t c)
+{
+	for (size_t i = 0; i < 32; i += 1) {
+		if (alphabet[i] == c) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int
+main()
+{
+	struct base32_alphabet compiled_base32;
+	struct base32_alphabet compiled_crockford;
+	struct base32_alphabet compiled_sample;
+	assert(base32_alphabet_compile(base32, &compiled_base32) == 0);
+	assert(base32_alphabet_compile(base32crockford, &compiled_crockford) ==
+			0);
+	assert(base32_alphabet_compile(sample_alphabet, &compiled_sample) ==
+			0);
+
+	uint8_t input[200];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	uint8_t encoded[400];
+	uint8_t decoded[200];
+	for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+		const size_t encoded_len = base32_encoded_length(len);
+
+		assert(base32_encode(len, input, ARRAY_SIZEOF(encoded),
+				       encoded, base32) == 0);
+		assert(base32_decode_compiled(encoded_len, encoded,
+				       ARRAY_SIZEOF(decoded), decoded,
+				       &compiled_base32) == 0);
+		assert(mem_equal(decoded, input, len));
+
+		assert(base32_encode(len, input, ARRAY_SIZEOF(encoded),
+				       encoded, sample_alphabet) == 0);
+		mem_set(decoded, 0, ARRAY_SIZEOF(decoded));
+		assert(base32_decode_compiled(encoded_len, encoded,
+				       ARRAY_SIZEOF(decoded), decoded,
+				       &compiled_sample) == 0);
+		assert(mem_equal(decoded, input, len));
+	}
+
+	// The first two are made of ranges of characters like the provided
+	// alphabets, the second being a single range. The third is base32
+	// moved to bytes of 0x80 and above. The last two are in no particular
+	// order, and only the fourth has just ASCII characters.
+	uint8_t custom[5][32];
+	for (size_t i = 0; i < 32; i += 1) {
+		custom[0][i] = sample_alphabet[i];
+		custom[1][i] = (uint8_t)(0x40 + i);
+		custom[2][i] = base32[i] | 0x80;
+		custom[3][i] = (uint8_t)((i * 37 + 2) & 0x7f);
+		custom[4][i] = (uint8_t)(i * 167 + 1);
+	}
+
+	for (size_t n = 0; n < ARRAY_SIZEOF(custom); n += 1) {
+		struct base32_alphabet compiled;
+		assert(base32_alphabet_compile(custom[n], &compiled) == 0);
+
+		for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+			assert(base32_encode(len, input, ARRAY_SIZEOF(encoded),
+					       encoded, custom[n]) == 0);
+			mem_set(decoded, 0, ARRAY_SIZEOF(decoded));
+			assert(base32_decode_compiled(
+					       base32_encoded_length(len),
+					       encoded, ARRAY_SIZEOF(decoded),
+					       decoded, &compiled) == 0);
+			assert(mem_equal(decoded, input, len));
+		}
+
+		// Every byte which isn't part of the alphabet or the padding
+		// is rejected, wherever it is.
+		const size_t len = ARRAY_SIZEOF(input);
+		for (size_t c = 0; c < 256; c += 1) {
+			const uint8_t byte = (uint8_t)c;
+			if (byte == 0x3d || in_alphabet(custom[n], byte)) {
+				continue;
+			}
+
+			for (size_t k = 0; k < len / 5 * 8; k += 7) {
+				assert(base32_encode(len, input,
+						       ARRAY_SIZEOF(encoded),
+						       encoded,
+						       custom[n]) == 0);
+				encoded[k] = byte;
+				assert(base32_decode_compiled(
+						       len / 5 * 8, encoded,
+						       ARRAY_SIZEOF(decoded),
+						       decoded, &compiled) ==
+						ENCODING_INVALID_ARGUMENT);
+			}
+		}
+	}
+
+	// The compiled Crockford alphabet is still case insensitive: "io"
+	const uint8_t crockford[] = {
+			0x69, 0x6f, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d};
+	assert(base32_decode_compiled(ARRAY_SIZEOF(crockford), crockford,
+			       ARRAY_SIZEOF(decoded), decoded,
+			       &compiled_crockford) == 0);
+	assert(decoded[0] == 0x08);
+
+	// "MZXW6YTB" is valid base32 but uppercase letters aren't part of
+	// sample_alphabet.
+	const uint8_t not_sample[] = {
+			0x4d, 0x5a, 0x58, 0x57, 0x36, 0x59, 0x54, 0x42};
+	assert(base32_decode_compiled(ARRAY_SIZEOF(not_sample), not_sample,
+			       ARRAY_SIZEOF(decoded), decoded,
+			       &compiled_sample) == ENCODING_INVALID_ARGUMENT);
+	assert(base32_decode_compiled(ARRAY_SIZEOF(not_sample), not_sample,
+			       ARRAY_SIZEOF(decoded), decoded,
+			       &compiled_base32) == 0);
+
+	// Edge cases
+
+	assert(base32_decode_compiled(0, NULL, 0, NULL, &compiled_sample) ==
+			0);
+	assert(base32_decode_compiled(7, not_sample, ARRAY_SIZEOF(decoded),
+			       decoded,
+			       &compiled_sample) == ENCODING_INVALID_ARGUMENT);
+	assert(base32_decode_compiled(ARRAY_SIZEOF(not_sample), not_sample, 0,
+			       NULL, &compiled_base32) ==
+			ENCODING_BUFFER_TOO_SMALL);
+}
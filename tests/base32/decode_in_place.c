@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base32/base32.h"
+#include "common.h"
+
+int
+main()
+{
+	uint8_t input[500];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	const uint8_t* alphabets[] = {base32, base32hex, base32crockford};
+
+	uint8_t buf[800];
+	for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+		const size_t encoded_len = base32_encoded_length(len);
+
+		for (size_t i = 0; i < ARRAY_SIZEOF(alphabets); i += 1) {
+			assert(base32_encode(len, input, ARRAY_SIZEOF(buf),
+					       buf, alphabets[i]) == 0);
+			size_t out_len = 1;
+			assert(base32_decode_in_place(encoded_len, buf,
+					       &out_len, alphabets[i]) == 0);
+			assert(out_len == len);
+			assert(mem_equal(buf, input, len));
+		}
+	}
+
+	// "MZXW6Y.B"
+	uint8_t invalid[] = {0x4d, 0x5a, 0x58, 0x57, 0x36, 0x59, 0x2e, 0x42};
+	assert(base32_decode_in_place(ARRAY_SIZEOF(invalid), invalid, NULL,
+			       base32) == ENCODING_INVALID_ARGUMENT);
+
+	// Edge cases
+
+	size_t out_len = 1;
+	assert(base32_decode_in_place(0, NULL, &out_len, base32) == 0);
+	assert(out_len == 0);
+	assert(base32_decode_in_place(7, invalid, &out_len, base32) ==
+			ENCODING_INVALID_ARGUMENT);
+}
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base32/base32.h"
+#include "common.h"
+
+static uint8_t input[400002];
+static uint8_t encoded[640008];
+static uint8_t got[400002];
+
+int
+main()
+{
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 131 + (i >> 9));
+	}
+
+	size_t                   num_tasks = 0;
+	struct encoding_executor executor  = {
+			thread_executor_run, &num_tasks, 7};
+
+	const size_t lens[] = {0, 1, 2, 65535, 65536, 65537, 400000, 400001,
+			400002};
+	for (size_t i = 0; i < ARRAY_SIZEOF(lens); i += 1) {
+		const size_t len         = lens[i];
+		const size_t encoded_len = base32_encoded_length(len);
+
+		assert(base32_encode(len, input, encoded_len, encoded,
+				       base32) == 0);
+		mem_set(got, 0, len);
+		assert(base32_decode_parallel(encoded_len, encoded, len, got,
+				       base32, &executor) == 0);
+		assert(mem_equal(got, input, len));
+
+		mem_set(got, 0, len);
+		assert(base32_decode_parallel(encoded_len, encoded, len, got,
+				       base32, NULL) == 0);
+		assert(mem_equal(got, input, len));
+
+		assert(base32_encode(len, input, encoded_len, encoded,
+				       base32hex) == 0);
+		mem_set(got, 0, len);
+		assert(base32_decode_parallel(encoded_len, encoded, len, got,
+				       base32hex, &executor) == 0);
+		assert(mem_equal(got, input, len));
+
+		assert(base32_encode(len, input, encoded_len, encoded,
+				       base32crockford) == 0);
+		mem_set(got, 0, len);
+		assert(base32_decode_parallel(encoded_len, encoded, len, got,
+				       base32crockford, &executor) == 0);
+		assert(mem_equal(got, input, len));
+	}
+
+	// The input was split up.
+	assert(num_tasks == 7);
+
+	const size_t encoded_len = base32_encoded_length(400000);
+	assert(base32_encode(400000, input, encoded_len, encoded, base32) ==
+			0);
+	int err = base32_decode_parallel(encoded_len, encoded, 399999, got,
+			base32, &executor);
+	assert(err == ENCODING_BUFFER_TOO_SMALL);
+
+	// Errors in a chunk in the middle are reported.
+	encoded[200003] = '.';
+	err = base32_decode_parallel(encoded_len, encoded, 400000, got,
+			base32, &executor);
+	assert(err == ENCODING_INVALID_ARGUMENT);
+
+	// So is padding anywhere other than the end.
+	encoded[200003] = '=';
+	err = base32_decode_parallel(encoded_len, encoded, 400000, got,
+			base32, &executor);
+	assert(err == ENCODING_INVALID_ARGUMENT);
+}
@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base32/base32.h"
+#include "common.h"
+
+static int
+decode_chunked(const size_t str_len, const uint8_t* str, const size_t chunk,
+		const size_t out_len, uint8_t* out, size_t* written)
+{
+	struct base32_decoder decoder;
+	base32_decoder_init(&decoder, base32);
+
+	size_t j = 0;
+	for (size_t i = 0; i < str_len; i += chunk) {
+		const size_t n = str_len - i < chunk ? str_len - i : chunk;
+
+		size_t n_written = 0;
+		int    err       = base32_decoder_update(&decoder, n, &str[i],
+					 out_len - j, &out[j], &n_written);
+		if (err != 0) {
+			return err;
+		}
+
+		j += n_written;
+	}
+
+	*written = j;
+	return base32_decoder_final(&decoder, 0, NULL, NULL);
+}
+
+int
+main()
+{
+	uint8_t input[500];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	uint8_t encoded[800];
+	uint8_t decoded[500];
+
+	// Decoding in chunks of every size gives back the original input.
+	const size_t lens[] = {0, 1, 2, 3, 4, 5, 6, 9, 31, 100, 500};
+	for (size_t i = 0; i < ARRAY_SIZEOF(lens); i += 1) {
+		const size_t len         = lens[i];
+		const size_t encoded_len = base32_encoded_length(len);
+		assert(base32_encode(len, input, ARRAY_SIZEOF(encoded),
+				       encoded, base32) == 0);
+
+		for (size_t chunk = 1; chunk <= 70; chunk += 1) {
+			size_t written = 0;
+			mem_set(decoded, 0, ARRAY_SIZEOF(decoded));
+			assert(decode_chunked(encoded_len, encoded, chunk,
+					       ARRAY_SIZEOF(decoded), decoded,
+					       &written) == 0);
+			assert(written == len);
+			assert(mem_equal(decoded, input, len));
+		}
+	}
+
+	// "MZXQ====MZXW6YTB" has data after the padding.
+	const uint8_t after_padding[] = {0x4d, 0x5a, 0x58, 0x51, 0x3d, 0x3d,
+			0x3d, 0x3d, 0x4d, 0x5a, 0x58, 0x57, 0x36, 0x59, 0x54,
+			0x42};
+	// "MZXW6YTBO" ends part way through a group.
+	const uint8_t incomplete[] = {
+			0x4d, 0x5a, 0x58, 0x57, 0x36, 0x59, 0x54, 0x42, 0x4f};
+	// "MZXW6YTB.I======" has an invalid character.
+	const uint8_t invalid[] = {0x4d, 0x5a, 0x58, 0x57, 0x36, 0x59, 0x54,
+			0x42, 0x2e, 0x49, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d};
+	for (size_t chunk = 1; chunk <= 16; chunk += 1) {
+		size_t written = 0;
+		assert(decode_chunked(ARRAY_SIZEOF(after_padding),
+				       after_padding, chunk,
+				       ARRAY_SIZEOF(decoded), decoded,
+				       &written) == ENCODING_INVALID_ARGUMENT);
+		assert(decode_chunked(ARRAY_SIZEOF(incomplete), incomplete,
+				       chunk, ARRAY_SIZEOF(decoded), decoded,
+				       &written) == ENCODING_INVALID_ARGUMENT);
+		assert(decode_chunked(ARRAY_SIZEOF(invalid), invalid, chunk,
+				       ARRAY_SIZEOF(decoded), decoded,
+				       &written) == ENCODING_INVALID_ARGUMENT);
+	}
+
+	// Small buffers
+
+	struct base32_decoder decoder;
+	base32_decoder_init(&decoder, base32);
+	assert(base32_decoder_update_length(&decoder, 7, invalid) == 0);
+	assert(base32_decoder_update(&decoder, 7, invalid, 0, NULL, NULL) ==
+			0);
+	assert(base32_decoder_update_length(&decoder, 1, &invalid[7]) == 5);
+	assert(base32_decoder_update(&decoder, 1, &invalid[7], 4, decoded,
+			       NULL) == ENCODING_BUFFER_TOO_SMALL);
+	assert(base32_decoder_update(&decoder, 1, &invalid[7], 5, decoded,
+			       NULL) == 0);
+	// "fooba"
+	const uint8_t fooba[] = {0x66, 0x6f, 0x6f, 0x62, 0x61};
+	assert(mem_equal(decoded, fooba, ARRAY_SIZEOF(fooba)));
+
+	// The padding is taken into account: "MZXQ===="
+	base32_decoder_init(&decoder, base32);
+	assert(base32_decoder_update_length(&decoder, 8, after_padding) == 2);
+	assert(base32_decoder_update(&decoder, 8, after_padding, 2, decoded,
+			       NULL) == 0);
+	assert(decoded[0] == 0x66 && decoded[1] == 0x6f);
+
+	// Edge cases
+
+	size_t written = 1;
+	assert(base32_decoder_update(&decoder, 0, NULL, 0, NULL, &written) ==
+			0);
+	assert(written == 0);
+	assert(base32_decoder_final(&decoder, 0, NULL, &written) == 0);
+	assert(written == 0);
+}
@@ -73,6 +73,41 @@ main()
 	assert(mem_equal(out, base32crockford_result,
 			ARRAY_SIZEOF(base32crockford_result)));
 
+	// Long inputs go through the vectorized encoders, so check them
+	// against encoding one bit at a time.
+	static uint8_t long_input[300];
+	static uint8_t long_out[480];
+	for (size_t i = 0; i < ARRAY_SIZEOF(long_input); i += 1) {
+		long_input[i] = (uint8_t)(i * 151 + (i >> 3));
+	}
+
+	const uint8_t* alphabets[] = {base32, base32hex, base32crockford};
+	for (size_t i = 0; i < ARRAY_SIZEOF(alphabets); i += 1) {
+		const uint8_t* alphabet = alphabets[i];
+		for (size_t len = 0; len <= ARRAY_SIZEOF(long_input);
+				len += 1) {
+			assert(base32_encode(len, long_input, sizeof(long_out),
+					       long_out, alphabet) == 0);
+
+			const size_t num_chars = (len * 8 + 4) / 5;
+			for (size_t j = 0; j < num_chars; j += 1) {
+				size_t value = 0;
+				for (size_t bit = j * 5; bit < j * 5 + 5;
+						bit += 1) {
+					size_t b = 0;
+					if (bit < len * 8) {
+						b = long_input[bit / 8] >>
+						    (7 - bit % 8);
+					}
+
+					value = value << 1 | (b & 1);
+				}
+
+				assert(long_out[j] == alphabet[value]);
+			}
+		}
+	}
+
 	// Edge cases
 
 	assert(base32_encode(lens[5] - 1, rfc4648_cases[5], 2, out, base32) ==
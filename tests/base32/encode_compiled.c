@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base32/base32.h"
+#include "common.h"
+
+// ASCII 'a' to 'z' followed by '0' to '5'.
+static const uint8_t sample_alphabet[32] = {
+		0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+		0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72, 0x73, 0x74,
+		0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x30, 0x31, 0x32, 0x33,
+		0x34, 0x35,
+};
+
+int
+main()
+{
+	struct base32_alphabet compiled_base32;
+	struct base32_alphabet compiled_sample;
+	assert(base32_alphabet_compile(base32, &compiled_base32) == 0);
+	assert(base32_alphabet_compile(sample_alphabet, &compiled_sample) ==
+			0);
+
+	uint8_t input[200];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	uint8_t expected[400];
+	uint8_t out[400];
+	for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+		const size_t out_len = base32_encoded_length(len);
+
+		assert(base32_encode(len, input, ARRAY_SIZEOF(expected),
+				       expected, base32) == 0);
+		assert(base32_encode_compiled(len, input, ARRAY_SIZEOF(out),
+				       out, &compiled_base32) == 0);
+		assert(mem_equal(out, expected, out_len));
+
+		assert(base32_encode(len, input, ARRAY_SIZEOF(expected),
+				       expected, sample_alphabet) == 0);
+		assert(base32_encode_compiled(len, input, ARRAY_SIZEOF(out),
+				       out, &compiled_sample) == 0);
+		assert(mem_equal(out, expected, out_len));
+	}
+
+	// Edge cases
+
+	assert(base32_encode_compiled(0, NULL, 0, NULL, &compiled_sample) ==
+			0);
+	assert(base32_encode_compiled(5, input, 7, out, &compiled_sample) ==
+			ENCODING_BUFFER_TOO_SMALL);
+}
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base32/base32.h"
+#include "common.h"
+
+int
+main()
+{
+	uint8_t input[500];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	uint8_t expected[800];
+	uint8_t out[800];
+
+	// Encoding in chunks of every size gives the same result as encoding
+	// all at once.
+	const uint8_t* alphabets[] = {base32, base32hex, base32crockford};
+	const size_t   lens[] = {0, 1, 2, 3, 4, 5, 6, 9, 31, 100, 500};
+	for (size_t i = 0; i < ARRAY_SIZEOF(lens); i += 1) {
+		const size_t   len         = lens[i];
+		const size_t   encoded_len = base32_encoded_length(len);
+		const uint8_t* alphabet =
+				alphabets[i % ARRAY_SIZEOF(alphabets)];
+		assert(base32_encode(len, input, ARRAY_SIZEOF(expected),
+				       expected, alphabet) == 0);
+
+		for (size_t chunk = 1; chunk <= 70; chunk += 1) {
+			struct base32_encoder encoder;
+			base32_encoder_init(&encoder, alphabet);
+
+			size_t j = 0;
+			for (size_t k = 0; k < len; k += chunk) {
+				const size_t n = len - k < chunk ? len - k
+								 : chunk;
+				size_t written = 0;
+				assert(base32_encoder_update(&encoder, n,
+						       &input[k],
+						       ARRAY_SIZEOF(out) - j,
+						       &out[j],
+						       &written) == 0);
+				j += written;
+			}
+
+			size_t written = 0;
+			assert(base32_encoder_final(&encoder, 8, &out[j],
+					       &written) == 0);
+			j += written;
+
+			assert(j == encoded_len);
+			assert(mem_equal(out, expected, encoded_len));
+		}
+	}
+
+	// Small buffers
+
+	struct base32_encoder encoder;
+	base32_encoder_init(&encoder, base32hex);
+	assert(base32_encoder_update_length(&encoder, 4) == 0);
+	assert(base32_encoder_update(&encoder, 4, input, 0, NULL, NULL) == 0);
+	assert(base32_encoder_update_length(&encoder, 1) == 8);
+	assert(base32_encoder_update(&encoder, 1, &input[4], 7, out, NULL) ==
+			ENCODING_BUFFER_TOO_SMALL);
+	assert(base32_encoder_update(&encoder, 1, &input[4], 8, out, NULL) ==
+			0);
+	assert(base32_encoder_update(&encoder, 2, &input[5], 0, NULL, NULL) ==
+			0);
+	assert(base32_encoder_final(&encoder, 7, &out[8], NULL) ==
+			ENCODING_BUFFER_TOO_SMALL);
+	assert(base32_encoder_final(&encoder, 8, &out[8], NULL) == 0);
+	assert(base32_encode(7, input, ARRAY_SIZEOF(expected), expected,
+			       base32hex) == 0);
+	assert(mem_equal(out, expected, 16));
+
+	// Edge cases
+
+	size_t written = 1;
+	assert(base32_encoder_final(&encoder, 0, NULL, &written) == 0);
+	assert(written == 0);
+	assert(base32_encoder_update(&encoder, 0, NULL, 0, NULL, &written) ==
+			0);
+	assert(written == 0);
+}
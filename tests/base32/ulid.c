@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../../base32/base32.h"
+#include "common.h"
+
+int
+main()
+{
+	const uint8_t ulid[16] = {0x01, 0x56, 0x3e, 0x3a, 0xb5, 0xd3, 0xd6,
+			0x76, 0x4c, 0x61, 0xef, 0xb9, 0x93, 0x02, 0xbd, 0x5b};
+	// "01ARZ3NDEKTSV4RRFFQ69G5FAV"
+	const uint8_t ulid_str[26] = {0x30, 0x31, 0x41, 0x52, 0x5a, 0x33,
+			0x4e, 0x44, 0x45, 0x4b, 0x54, 0x53, 0x56, 0x34, 0x52,
+			0x52, 0x46, 0x46, 0x51, 0x36, 0x39, 0x47, 0x35, 0x46,
+			0x41, 0x56};
+
+	uint8_t str[26];
+	base32crockford_ulid_encode(ulid, str);
+	assert(mem_equal(str, ulid_str, ARRAY_SIZEOF(str)));
+
+	uint8_t out[16];
+	assert(base32crockford_ulid_decode(ulid_str, out) == 0);
+	assert(mem_equal(out, ulid, ARRAY_SIZEOF(out)));
+
+	// Lowercase is accepted.
+	for (size_t i = 0; i < ARRAY_SIZEOF(str); i += 1) {
+		if (str[i] >= 0x41) {
+			str[i] |= 0x20;
+		}
+	}
+
+	mem_set(out, 0, ARRAY_SIZEOF(out));
+	assert(base32crockford_ulid_decode(str, out) == 0);
+	assert(mem_equal(out, ulid, ARRAY_SIZEOF(out)));
+
+	// Every bit of the ULID ends up in the right place.
+	for (size_t bit = 0; bit < 128; bit += 1) {
+		uint8_t single[16] = {0};
+		single[bit / 8]    = (uint8_t)(0x80 >> (bit % 8));
+		base32crockford_ulid_encode(single, str);
+
+		// Bit 0 is the highest bit of the 3 in the first character.
+		const size_t position = bit + 2;
+		for (size_t i = 0; i < ARRAY_SIZEOF(str); i += 1) {
+			uint8_t expected = 0x30; // '0'
+			if (i == position / 5) {
+				expected = base32crockford[0x10 >>
+							   (position % 5)];
+			}
+
+			assert(str[i] == expected);
+		}
+
+		assert(base32crockford_ulid_decode(str, out) == 0);
+		assert(mem_equal(out, single, ARRAY_SIZEOF(out)));
+	}
+
+	// The largest ULID is "7ZZZZZZZZZZZZZZZZZZZZZZZZZ".
+	uint8_t max[16];
+	mem_set(max, 0xff, ARRAY_SIZEOF(max));
+	base32crockford_ulid_encode(max, str);
+	assert(str[0] == 0x37); // '7'
+	for (size_t i = 1; i < ARRAY_SIZEOF(str); i += 1) {
+		assert(str[i] == 0x5a); // 'Z'
+	}
+
+	// Invalid input
+
+	// "8ZZZZZZZZZZZZZZZZZZZZZZZZZ" doesn't fit in 128 bits.
+	str[0] = 0x38;
+	assert(base32crockford_ulid_decode(str, out) ==
+			ENCODING_INVALID_ARGUMENT);
+
+	const uint8_t invalid[] = {
+			0x2d, 0x55, 0x75, 0x2a, 0x3d, 0x2e, 0x00, 0xff};
+	for (size_t i = 0; i < ARRAY_SIZEOF(invalid); i += 1) {
+		for (size_t j = 0; j < ARRAY_SIZEOF(ulid_str); j += 1) {
+			for (size_t k = 0; k < ARRAY_SIZEOF(str); k += 1) {
+				str[k] = ulid_str[k];
+			}
+
+			str[j] = invalid[i];
+			assert(base32crockford_ulid_decode(str, out) ==
+					ENCODING_INVALID_ARGUMENT);
+		}
+	}
+}
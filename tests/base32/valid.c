@@ -60,6 +60,17 @@ main()
 	// Check that incorrect padding returns false.
 	assert(!base32_valid(3, rfc4648_cases[0], base32));
 
+	// The encoder only ever writes 6, 4, 3 or 1 padding characters, so
+	// the other amounts are invalid.
+	const uint8_t* bad_padding[] = {
+			(const uint8_t*)"MZX=====",
+			(const uint8_t*)"MZXW6Y==",
+			(const uint8_t*)"M=======",
+	};
+	for (size_t i = 0; i < ARRAY_SIZEOF(bad_padding); i += 1) {
+		assert(!base32_valid(8, bad_padding[i], base32));
+	}
+
 	// Test that true is returned when str_len is 0.
 
 	assert(base32_valid(0, NULL, base32));
@@ -72,4 +83,64 @@ main()
 	assert(!base32_valid(8, all_padding, base32));
 	assert(!base32_valid(1, NULL, base32));
 	assert(!base32_valid(lens[1], rfc4648_cases[1], NULL));
+
+	// Bytes below the start of each range used to be accepted, since the
+	// checks compared promoted ints.
+	assert(!base32_valid(8, (const uint8_t*)"MZXW6YT!", base32));
+	assert(!base32_valid(8, (const uint8_t*)"MZXW6YT1", base32));
+	assert(!base32_valid(8, (const uint8_t*)"CPNMUOJ/", base32hex));
+	assert(!base32_valid(8, (const uint8_t*)"CSQPYRK!", base32crockford));
+
+	// Crockford rejects 'U' in either case, like base32_decode does.
+	assert(!base32_valid(8, (const uint8_t*)"CSQPYRKU", base32crockford));
+	assert(!base32_valid(8, (const uint8_t*)"CSQPYRKu", base32crockford));
+
+	// Only the characters before the padding are checked, so everything
+	// the encoder writes is valid Crockford, whatever its padding.
+	const uint8_t foobar[] = {0x66, 0x6f, 0x6f, 0x62, 0x61, 0x72};
+	for (size_t i = 0; i <= ARRAY_SIZEOF(foobar); i += 1) {
+		uint8_t      encoded[16];
+		const size_t encoded_len = base32_encoded_length(i);
+		assert(base32_encode(i, foobar, encoded_len, encoded,
+				       base32crockford) == 0);
+		assert(base32_valid(encoded_len, encoded, base32crockford));
+	}
+
+	// Try every byte in every position before the padding, covering both
+	// the part of the input checked 8 characters at a time and the part
+	// after it.
+	const uint8_t* alphabets[] = {base32, base32hex, base32crockford};
+	for (size_t i = 0; i < ARRAY_SIZEOF(alphabets); i += 1) {
+		const uint8_t* alphabet = alphabets[i];
+
+		uint8_t str[16];
+		for (size_t j = 0; j < 15; j += 1) {
+			str[j] = alphabet[j * 2];
+		}
+		str[15] = 0x3d;
+
+		for (size_t j = 0; j < 15; j += 1) {
+			for (size_t c = 0; c < 256; c += 1) {
+				bool expected = false;
+				for (size_t k = 0; k < 32; k += 1) {
+					expected |= alphabet[k] == c;
+				}
+
+				// Crockford also accepts lowercase letters,
+				// and 'I', 'L' and 'O'.
+				const size_t lower = c | 0x20;
+				if (alphabet == base32crockford) {
+					expected |= lower >= 0x61 &&
+						    lower <= 0x7a &&
+						    lower != 0x75;
+				}
+
+				const uint8_t old = str[j];
+				str[j]            = (uint8_t)c;
+				assert(base32_valid(ARRAY_SIZEOF(str), str,
+						       alphabet) == expected);
+				str[j] = old;
+			}
+		}
+	}
 }
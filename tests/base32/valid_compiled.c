@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base32/base32.h"
+#include "common.h"
+
+// ASCII 'a' to 'z' followed by '0' to '5'.
+static const uint8_t sample_alphabet[32] = {
+		0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+		0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72, 0x73, 0x74,
+		0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x30, 0x31, 0x32, 0x33,
+		0x34, 0x35,
+};
+
+int
+main()
+{
+	struct base32_alphabet compiled_base32;
+	struct base32_alphabet compiled_sample;
+	assert(base32_alphabet_compile(base32, &compiled_base32) == 0);
+	assert(base32_alphabet_compile(sample_alphabet, &compiled_sample) ==
+			0);
+
+	// "MZXW6==="
+	const uint8_t upper[] = {
+			0x4d, 0x5a, 0x58, 0x57, 0x36, 0x3d, 0x3d, 0x3d};
+	// "mzxw4==="
+	const uint8_t lower[] = {
+			0x6d, 0x7a, 0x78, 0x77, 0x34, 0x3d, 0x3d, 0x3d};
+
+	assert(base32_valid_compiled(
+			ARRAY_SIZEOF(upper), upper, &compiled_base32));
+	assert(!base32_valid_compiled(
+			ARRAY_SIZEOF(upper), upper, &compiled_sample));
+	assert(!base32_valid_compiled(
+			ARRAY_SIZEOF(lower), lower, &compiled_base32));
+	assert(base32_valid_compiled(
+			ARRAY_SIZEOF(lower), lower, &compiled_sample));
+
+	// Two padding characters can't be produced by the encoder.
+	const uint8_t bad_padding[] = {
+			0x6d, 0x7a, 0x78, 0x77, 0x34, 0x7a, 0x3d, 0x3d};
+	assert(!base32_valid_compiled(ARRAY_SIZEOF(bad_padding), bad_padding,
+			&compiled_sample));
+
+	// Neither in order nor ASCII, so it can't be validated using ranges.
+	uint8_t scrambled[32];
+	for (size_t i = 0; i < 32; i += 1) {
+		scrambled[i] = (uint8_t)(i * 167 + 1);
+	}
+
+	struct base32_alphabet compiled_scrambled;
+	assert(base32_alphabet_compile(scrambled, &compiled_scrambled) == 0);
+
+	uint8_t input[103];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	// 103 bytes leave 3 padding characters.
+	uint8_t encoded[168];
+	assert(base32_encode(ARRAY_SIZEOF(input), input, ARRAY_SIZEOF(encoded),
+			       encoded, scrambled) == 0);
+	assert(base32_valid_compiled(ARRAY_SIZEOF(encoded), encoded,
+			&compiled_scrambled));
+
+	// 0x00 isn't part of scrambled.
+	for (size_t i = 0; i < ARRAY_SIZEOF(encoded) - 3; i += 1) {
+		const uint8_t c = encoded[i];
+		encoded[i]      = 0x00;
+		assert(!base32_valid_compiled(ARRAY_SIZEOF(encoded), encoded,
+				&compiled_scrambled));
+		encoded[i] = c;
+	}
+
+	// Edge cases
+
+	assert(base32_valid_compiled(0, NULL, &compiled_sample));
+	assert(!base32_valid_compiled(3, lower, &compiled_sample));
+	assert(!base32_valid_compiled(ARRAY_SIZEOF(lower), NULL,
+			&compiled_sample));
+}
@@ -94,6 +94,79 @@ main()
 			       base64url) == 0);
 	assert(mem_equal(out, special_result, ARRAY_SIZEOF(special_result)));
 
+	// Long inputs go through the vectorized decoders, if the CPU has them.
+	// Decode at every length to cover each tail.
+
+	static uint8_t input[1000];
+	static uint8_t encoded[1336];
+	static uint8_t decoded[1000];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 167 + 13);
+	}
+
+	const uint8_t* alphabets[] = {base64, base64url, sample_alphabet};
+	for (size_t a = 0; a < ARRAY_SIZEOF(alphabets); a += 1) {
+		const uint8_t* alphabet = alphabets[a];
+		for (size_t n = 0; n <= ARRAY_SIZEOF(input); n += 1) {
+			const size_t encoded_len = base64_encoded_length(n);
+			assert(base64_encode(n, input,
+					       ARRAY_SIZEOF(encoded),
+					       encoded, alphabet) == 0);
+			assert(base64_decoded_length(
+					       encoded_len, encoded) == n);
+			assert(base64_decode(encoded_len, encoded, n,
+					       decoded, alphabet) == 0);
+			assert(mem_equal(input, decoded, n));
+		}
+	}
+
+	// Any invalid character must be reported, wherever it is.
+
+	const size_t corrupt_len =
+			base64_encoded_length(ARRAY_SIZEOF(input) - 1);
+	for (size_t a = 0; a < ARRAY_SIZEOF(alphabets); a += 1) {
+		const uint8_t* alphabet = alphabets[a];
+		assert(base64_encode(ARRAY_SIZEOF(input) - 1, input,
+				       ARRAY_SIZEOF(encoded), encoded,
+				       alphabet) == 0);
+		for (size_t i = 0; i < corrupt_len - 2; i += 1) {
+			const uint8_t tmp = encoded[i];
+			// ASCII '.'
+			encoded[i] = 0x2e;
+			assert(base64_decode(corrupt_len, encoded,
+					       ARRAY_SIZEOF(decoded), decoded,
+					       alphabet) ==
+					ENCODING_INVALID_ARGUMENT);
+			// Non-ASCII bytes
+			encoded[i] = 0xc1;
+			assert(base64_decode(corrupt_len, encoded,
+					       ARRAY_SIZEOF(decoded), decoded,
+					       alphabet) ==
+					ENCODING_INVALID_ARGUMENT);
+			encoded[i] = tmp;
+		}
+	}
+
+	// Characters from the other alphabet are invalid.
+	assert(base64_decode(ARRAY_SIZEOF(special_base64url),
+			       special_base64url, ARRAY_SIZEOF(out), out,
+			       base64) == ENCODING_INVALID_ARGUMENT);
+	assert(base64_decode(ARRAY_SIZEOF(special_base64), special_base64,
+			       ARRAY_SIZEOF(out), out,
+			       base64url) == ENCODING_INVALID_ARGUMENT);
+
+	// Too much padding, and padding in the middle of the input.
+	const uint8_t too_much_padding[] = {// "Zm9vY==="
+			0x5a, 0x6d, 0x39, 0x76, 0x59, 0x3d, 0x3d, 0x3d};
+	const uint8_t misplaced_padding[] = {// "Zm9v=g=="
+			0x5a, 0x6d, 0x39, 0x76, 0x3d, 0x67, 0x3d, 0x3d};
+	assert(base64_decode(ARRAY_SIZEOF(too_much_padding), too_much_padding,
+			       ARRAY_SIZEOF(out), out,
+			       base64) == ENCODING_INVALID_ARGUMENT);
+	assert(base64_decode(ARRAY_SIZEOF(misplaced_padding),
+			       misplaced_padding, ARRAY_SIZEOF(out), out,
+			       base64) == ENCODING_INVALID_ARGUMENT);
+
 	// Edge cases
 
 	assert(base64_decode(0, NULL, 0, NULL, base64) == 0);
@@ -102,4 +175,43 @@ main()
 			ENCODING_BUFFER_TOO_SMALL);
 	assert(base64_decode(lens[1], rfc4648_cases[1], 0, NULL, base64) ==
 			ENCODING_BUFFER_TOO_SMALL);
+
+	// Try every byte in every position, and check that the built-in
+	// alphabets decode the same as a copy of them, which goes through the
+	// generic decoder.
+	const uint8_t* builtins[] = {base64, base64url};
+	for (size_t i = 0; i < ARRAY_SIZEOF(builtins); i += 1) {
+		uint8_t copy[64];
+		for (size_t j = 0; j < ARRAY_SIZEOF(copy); j += 1) {
+			copy[j] = builtins[i][j];
+		}
+
+		uint8_t str[23];
+		for (size_t j = 0; j < ARRAY_SIZEOF(str); j += 1) {
+			str[j] = copy[j * 5 % 64];
+		}
+
+		uint8_t expected[17];
+		uint8_t got[17];
+		for (size_t j = 0; j < ARRAY_SIZEOF(str); j += 1) {
+			for (size_t c = 0; c < 256; c += 1) {
+				const uint8_t old = str[j];
+				str[j]            = (uint8_t)c;
+
+				const int err = base64_decode(
+						ARRAY_SIZEOF(str), str,
+						ARRAY_SIZEOF(expected),
+						expected, copy);
+				assert(base64_decode(ARRAY_SIZEOF(str), str,
+						       ARRAY_SIZEOF(got), got,
+						       builtins[i]) == err);
+				if (err == 0) {
+					assert(mem_equal(got, expected,
+							ARRAY_SIZEOF(got)));
+				}
+
+				str[j] = old;
+			}
+		}
+	}
 }
@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base64/base64.h"
+#include "common.h"
+
+// The base64 alphabet, but with the last two characters being '.' and '_'.
+static const uint8_t sample_alphabet[64] = {
+		// ASCII 'A' to 'Z'
+		0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a,
+		0x4b, 0x4c, 0x4d, 0x4e, 0x4f, 0x50, 0x51, 0x52, 0x53, 0x54,
+		0x55, 0x56, 0x57, 0x58, 0x59, 0x5a,
+		// ASCII 'a' to 'z'
+		0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+		0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72, 0x73, 0x74,
+		0x75, 0x76, 0x77, 0x78, 0x79, 0x7a,
+		// ASCII '0' to '9'
+		0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39,
+		0x2e, // '.'
+		0x5f, // '_'
+};
+
+static bool
+in_alphabet(const uint8_t alphabet[64], const uint8_t c)
+{
+	for (size_t i = 0; i < 64; i += 1) {
+		if (alphabet[i] == c) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int
+main()
+{
+	struct base64_alphabet compiled_base64;
+	struct base64_alphabet compiled_sample;
+	assert(base64_alphabet_compile(base64, &compiled_base64) == 0);
+	assert(base64_alphabet_compile(sample_alphabet, &compiled_sample) ==
+			0);
+
+	uint8_t input[300];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	uint8_t encoded[400];
+	uint8_t decoded[300];
+	for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+		const size_t encoded_len = base64_encoded_length(len);
+
+		assert(base64_encode(len, input, ARRAY_SIZEOF(encoded),
+				       encoded, base64) == 0);
+		assert(base64_decode_compiled(encoded_len, encoded,
+				       ARRAY_SIZEOF(decoded), decoded,
+				       &compiled_base64) == 0);
+		assert(mem_equal(decoded, input, len));
+
+		assert(base64_encode(len, input, ARRAY_SIZEOF(encoded),
+				       encoded, sample_alphabet) == 0);
+		mem_set(decoded, 0, ARRAY_SIZEOF(decoded));
+		assert(base64_decode_compiled(encoded_len, encoded,
+				       ARRAY_SIZEOF(decoded), decoded,
+				       &compiled_sample) == 0);
+		assert(mem_equal(decoded, input, len));
+	}
+
+	// "Pz8/" is valid base64 but '/' isn't part of sample_alphabet.
+	const uint8_t not_sample[] = {0x50, 0x7a, 0x38, 0x2f};
+	assert(base64_decode_compiled(ARRAY_SIZEOF(not_sample), not_sample,
+			       ARRAY_SIZEOF(decoded), decoded,
+			       &compiled_sample) == ENCODING_INVALID_ARGUMENT);
+	assert(base64_decode_compiled(ARRAY_SIZEOF(not_sample), not_sample,
+			       ARRAY_SIZEOF(decoded), decoded,
+			       &compiled_base64) == 0);
+
+	// The first two can be decoded using offsets like the provided
+	// alphabets, the second being base64 moved to bytes of 0x80 and above.
+	// The last two are in no particular order, and only the third has just
+	// ASCII characters.
+	uint8_t custom[4][64];
+	for (size_t i = 0; i < 64; i += 1) {
+		custom[0][i] = sample_alphabet[i];
+		custom[1][i] = base64[i] | 0x80;
+		custom[2][i] = (uint8_t)((i * 37 + 2) & 0x7f);
+		custom[3][i] = (uint8_t)(i * 167 + 1);
+	}
+
+	for (size_t n = 0; n < ARRAY_SIZEOF(custom); n += 1) {
+		struct base64_alphabet compiled;
+		assert(base64_alphabet_compile(custom[n], &compiled) == 0);
+
+		for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+			assert(base64_encode(len, input, ARRAY_SIZEOF(encoded),
+					       encoded, custom[n]) == 0);
+			mem_set(decoded, 0, ARRAY_SIZEOF(decoded));
+			assert(base64_decode_compiled(
+					       base64_encoded_length(len),
+					       encoded, ARRAY_SIZEOF(decoded),
+					       decoded, &compiled) == 0);
+			assert(mem_equal(decoded, input, len));
+		}
+
+		// Every byte which isn't part of the alphabet or the padding
+		// is rejected, wherever it is.
+		const size_t len = ARRAY_SIZEOF(input);
+		for (size_t c = 0; c < 256; c += 1) {
+			const uint8_t byte = (uint8_t)c;
+			if (byte == 0x3d || in_alphabet(custom[n], byte)) {
+				continue;
+			}
+
+			for (size_t k = 0; k < len / 3 * 4; k += 7) {
+				assert(base64_encode(len, input,
+						       ARRAY_SIZEOF(encoded),
+						       encoded,
+						       custom[n]) == 0);
+				encoded[k] = byte;
+				assert(base64_decode_compiled(
+						       len / 3 * 4, encoded,
+						       ARRAY_SIZEOF(decoded),
+						       decoded, &compiled) ==
+						ENCODING_INVALID_ARGUMENT);
+			}
+		}
+	}
+
+	// Edge cases
+
+	assert(base64_decode_compiled(0, NULL, 0, NULL, &compiled_sample) ==
+			0);
+	assert(base64_decode_compiled(3, not_sample, ARRAY_SIZEOF(decoded),
+			       decoded,
+			       &compiled_sample) == ENCODING_INVALID_ARGUMENT);
+	assert(base64_decode_compiled(ARRAY_SIZEOF(not_sample), not_sample, 0,
+			       NULL, &compiled_base64) ==
+			ENCODING_BUFFER_TOO_SMALL);
+}
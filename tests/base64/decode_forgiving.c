@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base64/base64.h"
+#include "common.h"
+
+// Copies str to out, inserting separator after every line_len characters.
+// Returns the length of out.
+static size_t
+wrap(const size_t str_len, const uint8_t* str, const size_t line_len,
+		const char* separator, uint8_t* out)
+{
+	size_t j = 0;
+	for (size_t i = 0; i < str_len; i += 1) {
+		if (i != 0 && i % line_len == 0) {
+			for (size_t k = 0; separator[k] != '\0'; k += 1) {
+				out[j] = (uint8_t)separator[k];
+				j += 1;
+			}
+		}
+
+		out[j] = str[i];
+		j += 1;
+	}
+
+	return j;
+}
+
+int
+main()
+{
+	uint8_t input[1500];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	uint8_t encoded[2100];
+	uint8_t wrapped[4200];
+	uint8_t decoded[1500];
+
+	const size_t line_lens[]  = {76, 64, 4, 1, 3000};
+	const char*  separators[] = {"\r\n", "\n", " \t", "\x0c", ""};
+	for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 7) {
+		const size_t encoded_len = base64_encoded_length(len);
+		assert(base64_encode(len, input, ARRAY_SIZEOF(encoded),
+				       encoded, base64) == 0);
+
+		for (size_t i = 0; i < ARRAY_SIZEOF(line_lens); i += 1) {
+			const size_t wrapped_len = wrap(encoded_len, encoded,
+					line_lens[i], separators[i], wrapped);
+
+			size_t written = 0;
+			mem_set(decoded, 0, ARRAY_SIZEOF(decoded));
+			assert(base64_decode_forgiving(wrapped_len, wrapped,
+					       ARRAY_SIZEOF(decoded), decoded,
+					       base64, &written) == 0);
+			assert(written == len);
+			assert(mem_equal(decoded, input, len));
+		}
+
+		// The padding is optional.
+		size_t unpadded_len = encoded_len;
+		while (unpadded_len != 0 &&
+				encoded[unpadded_len - 1] == 0x3d) {
+			unpadded_len -= 1;
+		}
+
+		const size_t wrapped_len = wrap(
+				unpadded_len, encoded, 76, "\r\n", wrapped);
+
+		size_t written = 0;
+		mem_set(decoded, 0, ARRAY_SIZEOF(decoded));
+		assert(base64_decode_forgiving(wrapped_len, wrapped, len,
+				       decoded, base64, &written) == 0);
+		assert(written == len);
+		assert(mem_equal(decoded, input, len));
+	}
+
+	// "Zm9v\r\nYg = =\n" is "foob"
+	const uint8_t spaced_padding[] = {0x5a, 0x6d, 0x39, 0x76, 0x0d, 0x0a,
+			0x59, 0x67, 0x20, 0x3d, 0x20, 0x3d, 0x0a};
+	size_t        written          = 0;
+	assert(base64_decode_forgiving(ARRAY_SIZEOF(spaced_padding),
+			       spaced_padding, ARRAY_SIZEOF(decoded), decoded,
+			       base64, &written) == 0);
+	assert(written == 4);
+	assert(decoded[3] == 0x62);
+
+	// base64url works the same: "PDw_\nPz8-Pg"
+	const uint8_t url[] = {0x50, 0x44, 0x77, 0x5f, 0x0a, 0x50, 0x7a, 0x38,
+			0x2d, 0x50, 0x67};
+	assert(base64_decode_forgiving(ARRAY_SIZEOF(url), url,
+			       ARRAY_SIZEOF(decoded), decoded, base64url,
+			       &written) == 0);
+	assert(written == 7);
+	assert(base64_decode_forgiving(ARRAY_SIZEOF(url), url,
+			       ARRAY_SIZEOF(decoded), decoded, base64,
+			       &written) == ENCODING_INVALID_ARGUMENT);
+
+	// Invalid input
+
+	const char* invalid[] = {
+			"Zm9vY",     // A lone character in the last quantum
+			"Zg=",       // Too little padding
+			"Zg===",     // Too much padding
+			"Zm9=v",     // Data after padding
+			"Zm9v=",     // Padding after a complete quantum
+			"Zm9v\x0bYg", // Vertical tab isn't whitespace
+			"Zm9v.mFy",  // Not part of the alphabet
+	};
+	for (size_t i = 0; i < ARRAY_SIZEOF(invalid); i += 1) {
+		size_t len = 0;
+		while (invalid[i][len] != '\0') {
+			len += 1;
+		}
+
+		assert(base64_decode_forgiving(len, (const uint8_t*)invalid[i],
+				       ARRAY_SIZEOF(decoded), decoded, base64,
+				       NULL) == ENCODING_INVALID_ARGUMENT);
+	}
+
+	// Small buffers
+
+	assert(base64_decode_forgiving(ARRAY_SIZEOF(spaced_padding),
+			       spaced_padding, 3, decoded, base64,
+			       NULL) == ENCODING_BUFFER_TOO_SMALL);
+	assert(base64_encode(1500, input, ARRAY_SIZEOF(encoded), encoded,
+			       base64) == 0);
+	assert(base64_decode_forgiving(2000, encoded, 1499, decoded, base64,
+			       NULL) == ENCODING_BUFFER_TOO_SMALL);
+
+	// Edge cases
+
+	assert(base64_decode_forgiving(0, NULL, 0, NULL, base64, &written) ==
+			0);
+	assert(written == 0);
+	assert(base64_decode_forgiving(2, spaced_padding + 4, 0, NULL, base64,
+			       &written) == 0);
+	assert(written == 0);
+}
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base64/base64.h"
+#include "common.h"
+
+int
+main()
+{
+	uint8_t input[1000];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	// Long enough inputs go through the vectorized decoders, which store
+	// more bytes at a time than they decode.
+	uint8_t buf[1400];
+	for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+		const size_t encoded_len = base64_encoded_length(len);
+
+		assert(base64_encode(len, input, ARRAY_SIZEOF(buf), buf,
+				       base64) == 0);
+		size_t out_len = 1;
+		assert(base64_decode_in_place(encoded_len, buf, &out_len,
+				       base64) == 0);
+		assert(out_len == len);
+		assert(mem_equal(buf, input, len));
+
+		assert(base64_encode(len, input, ARRAY_SIZEOF(buf), buf,
+				       base64url) == 0);
+		assert(base64_decode_in_place(encoded_len, buf, &out_len,
+				       base64url) == 0);
+		assert(out_len == len);
+		assert(mem_equal(buf, input, len));
+	}
+
+	// "Zm9v.mFy"
+	uint8_t invalid[] = {0x5a, 0x6d, 0x39, 0x76, 0x2e, 0x6d, 0x46, 0x79};
+	assert(base64_decode_in_place(ARRAY_SIZEOF(invalid), invalid, NULL,
+			       base64) == ENCODING_INVALID_ARGUMENT);
+
+	// Edge cases
+
+	size_t out_len = 1;
+	assert(base64_decode_in_place(0, NULL, &out_len, base64) == 0);
+	assert(out_len == 0);
+	assert(base64_decode_in_place(3, invalid, &out_len, base64) ==
+			ENCODING_INVALID_ARGUMENT);
+}
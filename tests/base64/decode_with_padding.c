@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base64/base64.h"
+#include "common.h"
+
+static size_t
+length(const char* str)
+{
+	size_t result = 0;
+	while (str[result] != '\0') {
+		result += 1;
+	}
+
+	return result;
+}
+
+int
+main()
+{
+	uint8_t input[300];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	uint8_t padded[400];
+	uint8_t decoded[300];
+	for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+		const size_t padded_len   = base64_encoded_length(len);
+		const size_t unpadded_len = base64_encoded_length_with_padding(
+				len, BASE64_PADDING_FORBIDDEN);
+		assert(base64_encode(len, input, ARRAY_SIZEOF(padded), padded,
+				       base64url) == 0);
+		assert(base64_decoded_length(padded_len, padded) == len);
+		assert(base64_decoded_length(unpadded_len, padded) == len);
+
+		// Padded input
+		mem_set(decoded, 0, ARRAY_SIZEOF(decoded));
+		assert(base64_decode_with_padding(padded_len, padded, len,
+				       decoded, base64url,
+				       BASE64_PADDING_OPTIONAL) == 0);
+		assert(mem_equal(decoded, input, len));
+
+		// Unpadded input
+		mem_set(decoded, 0, ARRAY_SIZEOF(decoded));
+		assert(base64_decode_with_padding(unpadded_len, padded, len,
+				       decoded, base64url,
+				       BASE64_PADDING_FORBIDDEN) == 0);
+		assert(mem_equal(decoded, input, len));
+
+		mem_set(decoded, 0, ARRAY_SIZEOF(decoded));
+		assert(base64_decode_with_padding(unpadded_len, padded, len,
+				       decoded, base64url,
+				       BASE64_PADDING_OPTIONAL) == 0);
+		assert(mem_equal(decoded, input, len));
+
+		if (padded_len != unpadded_len) {
+			assert(base64_decode_with_padding(padded_len, padded,
+					       len, decoded, base64url,
+					       BASE64_PADDING_FORBIDDEN) ==
+					ENCODING_INVALID_ARGUMENT);
+			assert(base64_decode_with_padding(unpadded_len,
+					       padded, len, decoded, base64url,
+					       BASE64_PADDING_REQUIRED) ==
+					ENCODING_INVALID_ARGUMENT);
+		}
+	}
+
+	// A JWT header: {"alg":"HS256","typ":"JWT"}
+	const char* jwt = "eyJhbGciOiJIUzI1NiIsInR5cCI6IkpXVCJ9";
+	const char* header = "{\"alg\":\"HS256\",\"typ\":\"JWT\"}";
+	assert(base64_decode_with_padding(length(jwt), (const uint8_t*)jwt,
+			       ARRAY_SIZEOF(decoded), decoded, base64url,
+			       BASE64_PADDING_FORBIDDEN) == 0);
+	assert(mem_equal(decoded, (const uint8_t*)header, length(header)));
+
+	// Invalid input
+
+	const char* invalid[] = {
+			"Z",       // A lone character
+			"Zm9vY",   // A lone character in the last quantum
+			"Zg=",     // Too little padding
+			"Zg===",   // Too much padding
+			"Z===",    // Too much padding
+			"Zm9v.g",  // Not part of the alphabet
+			"Zm9vY.",  // Not part of the alphabet in the tail
+			"Zm9vYm.", // Not part of the alphabet in the tail
+	};
+	for (size_t i = 0; i < ARRAY_SIZEOF(invalid); i += 1) {
+		assert(base64_decode_with_padding(length(invalid[i]),
+				       (const uint8_t*)invalid[i],
+				       ARRAY_SIZEOF(decoded), decoded, base64,
+				       BASE64_PADDING_OPTIONAL) ==
+				ENCODING_INVALID_ARGUMENT);
+	}
+
+	// Edge cases
+
+	assert(base64_decode_with_padding(0, NULL, 0, NULL, base64,
+			       BASE64_PADDING_FORBIDDEN) == 0);
+	assert(base64_decode_with_padding(3, (const uint8_t*)"Zm8", 1,
+			       decoded, base64,
+			       BASE64_PADDING_FORBIDDEN) ==
+			ENCODING_BUFFER_TOO_SMALL);
+	assert(base64_decode_with_padding(4, (const uint8_t*)"Zm9v",
+			       ARRAY_SIZEOF(decoded), decoded, base64,
+			       3) == ENCODING_INVALID_ARGUMENT);
+}
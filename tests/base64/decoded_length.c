@@ -34,6 +34,12 @@ main()
 	assert(base64_decoded_length(lens[5], rfc4648_cases[5]) == 5);
 	assert(base64_decoded_length(lens[6], rfc4648_cases[6]) == 6);
 
+	// Unpadded input has the same decoded length.
+	assert(base64_decoded_length(2, rfc4648_cases[1]) == 1);
+	assert(base64_decoded_length(3, rfc4648_cases[2]) == 2);
+	assert(base64_decoded_length(6, rfc4648_cases[4]) == 4);
+	assert(base64_decoded_length(7, rfc4648_cases[5]) == 5);
+
 	// Check that passing an empty string returns 0.
 
 	assert(base64_decoded_length(0, NULL) == 0);
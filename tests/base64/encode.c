@@ -21,6 +21,21 @@ static const uint8_t sample_alphabet[64] = {
 		0x2f, // '/'
 };
 
+static const uint8_t sample_alphabet_url[64] = {
+		// ASCII 'A' to 'Z'
+		0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a,
+		0x4b, 0x4c, 0x4d, 0x4e, 0x4f, 0x50, 0x51, 0x52, 0x53, 0x54,
+		0x55, 0x56, 0x57, 0x58, 0x59, 0x5a,
+		// ASCII 'a' to 'z'
+		0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+		0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72, 0x73, 0x74,
+		0x75, 0x76, 0x77, 0x78, 0x79, 0x7a,
+		// ASCII '0' to '9'
+		0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39,
+		0x2d, // '-'
+		0x5f, // '_'
+};
+
 int
 main()
 {
@@ -114,6 +129,62 @@ main()
 	assert(mem_equal(special_base64url, out,
 			ARRAY_SIZEOF(special_base64url)));
 
+	// Long inputs go through the vectorized encoders, if the CPU has them.
+	// Since sample_alphabet isn't one of the provided alphabets, it always
+	// uses the portable encoder, so we compare against it at every length
+	// to cover each tail.
+
+	static uint8_t long_input[1000];
+	static uint8_t long_out[1336];
+	static uint8_t long_key[1336];
+	for (size_t i = 0; i < ARRAY_SIZEOF(long_input); i += 1) {
+		long_input[i] = (uint8_t)(i * 167 + 13);
+	}
+
+	for (size_t len = 0; len <= ARRAY_SIZEOF(long_input); len += 1) {
+		const size_t encoded_len = base64_encoded_length(len);
+
+		assert(base64_encode(len, long_input, ARRAY_SIZEOF(long_key),
+				       long_key, sample_alphabet) == 0);
+		assert(base64_encode(len, long_input, encoded_len, long_out,
+				       base64) == 0);
+		assert(mem_equal(long_key, long_out, encoded_len));
+
+		assert(base64_encode(len, long_input, ARRAY_SIZEOF(long_key),
+				       long_key, sample_alphabet_url) == 0);
+		assert(base64_encode(len, long_input, encoded_len, long_out,
+				       base64url) == 0);
+		assert(mem_equal(long_key, long_out, encoded_len));
+	}
+
+	// Every 12-bit value in both halves of a group, to cover every entry
+	// of the pair tables.
+	static uint8_t groups[4096 * 3];
+	static uint8_t groups_key[4096 * 4];
+	static uint8_t groups_out[4096 * 4];
+	for (size_t i = 0; i < 4096; i += 1) {
+		const size_t x = i << 12 | (4095 - i);
+		groups[i * 3]     = (uint8_t)(x >> 16);
+		groups[i * 3 + 1] = (uint8_t)(x >> 8);
+		groups[i * 3 + 2] = (uint8_t)x;
+	}
+
+	assert(base64_encode(ARRAY_SIZEOF(groups), groups,
+			       ARRAY_SIZEOF(groups_key), groups_key,
+			       sample_alphabet) == 0);
+	assert(base64_encode(ARRAY_SIZEOF(groups), groups,
+			       ARRAY_SIZEOF(groups_out), groups_out,
+			       base64) == 0);
+	assert(mem_equal(groups_key, groups_out, ARRAY_SIZEOF(groups_key)));
+
+	assert(base64_encode(ARRAY_SIZEOF(groups), groups,
+			       ARRAY_SIZEOF(groups_key), groups_key,
+			       sample_alphabet_url) == 0);
+	assert(base64_encode(ARRAY_SIZEOF(groups), groups,
+			       ARRAY_SIZEOF(groups_out), groups_out,
+			       base64url) == 0);
+	assert(mem_equal(groups_key, groups_out, ARRAY_SIZEOF(groups_key)));
+
 	// Edge cases
 
 	assert(base64_encode(ARRAY_SIZEOF(valid6) - 1, valid6, 2, out,
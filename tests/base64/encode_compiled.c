@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base64/base64.h"
+#include "common.h"
+
+// The base64 alphabet, but with the last two characters being '.' and '_'.
+static const uint8_t sample_alphabet[64] = {
+		// ASCII 'A' to 'Z'
+		0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a,
+		0x4b, 0x4c, 0x4d, 0x4e, 0x4f, 0x50, 0x51, 0x52, 0x53, 0x54,
+		0x55, 0x56, 0x57, 0x58, 0x59, 0x5a,
+		// ASCII 'a' to 'z'
+		0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+		0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72, 0x73, 0x74,
+		0x75, 0x76, 0x77, 0x78, 0x79, 0x7a,
+		// ASCII '0' to '9'
+		0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39,
+		0x2e, // '.'
+		0x5f, // '_'
+};
+
+int
+main()
+{
+	struct base64_alphabet compiled_base64;
+	struct base64_alphabet compiled_sample;
+	assert(base64_alphabet_compile(base64, &compiled_base64) == 0);
+	assert(base64_alphabet_compile(sample_alphabet, &compiled_sample) ==
+			0);
+
+	uint8_t input[300];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	uint8_t expected[400];
+	uint8_t out[400];
+	for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+		const size_t out_len = base64_encoded_length(len);
+
+		assert(base64_encode(len, input, ARRAY_SIZEOF(expected),
+				       expected, base64) == 0);
+		assert(base64_encode_compiled(len, input, ARRAY_SIZEOF(out),
+				       out, &compiled_base64) == 0);
+		assert(mem_equal(out, expected, out_len));
+
+		assert(base64_encode(len, input, ARRAY_SIZEOF(expected),
+				       expected, sample_alphabet) == 0);
+		assert(base64_encode_compiled(len, input, ARRAY_SIZEOF(out),
+				       out, &compiled_sample) == 0);
+		assert(mem_equal(out, expected, out_len));
+	}
+
+	// Alphabets in no particular order, so the offsets used for the
+	// provided alphabets can't describe them. The first only has ASCII
+	// characters, while the second also has bytes of 0x80 and above.
+	uint8_t scrambled[2][64];
+	for (size_t i = 0; i < 64; i += 1) {
+		scrambled[0][i] = (uint8_t)((i * 37 + 2) & 0x7f);
+		scrambled[1][i] = (uint8_t)(i * 167 + 1);
+	}
+
+	for (size_t n = 0; n < ARRAY_SIZEOF(scrambled); n += 1) {
+		struct base64_alphabet compiled;
+		assert(base64_alphabet_compile(scrambled[n], &compiled) == 0);
+
+		for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+			const size_t out_len = base64_encoded_length(len);
+
+			assert(base64_encode(len, input,
+					       ARRAY_SIZEOF(expected),
+					       expected, scrambled[n]) == 0);
+			assert(base64_encode_compiled(len, input,
+					       ARRAY_SIZEOF(out), out,
+					       &compiled) == 0);
+			assert(mem_equal(out, expected, out_len));
+		}
+	}
+
+	// Edge cases
+
+	assert(base64_encode_compiled(0, NULL, 0, NULL, &compiled_sample) ==
+			0);
+	assert(base64_encode_compiled(3, input, 3, out, &compiled_sample) ==
+			ENCODING_BUFFER_TOO_SMALL);
+}
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base64/base64.h"
+#include "common.h"
+
+static uint8_t input[400002];
+static uint8_t expected[533340];
+static uint8_t got[533340];
+
+int
+main()
+{
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 131 + (i >> 9));
+	}
+
+	size_t                   num_tasks = 0;
+	struct encoding_executor executor  = {
+			thread_executor_run, &num_tasks, 7};
+
+	const size_t lens[] = {0, 1, 2, 65535, 65536, 65537, 400000, 400001,
+			400002};
+	for (size_t i = 0; i < ARRAY_SIZEOF(lens); i += 1) {
+		const size_t len         = lens[i];
+		const size_t encoded_len = base64_encoded_length(len);
+
+		assert(base64_encode(len, input, encoded_len, expected,
+				       base64) == 0);
+
+		mem_set(got, 0, encoded_len);
+		assert(base64_encode_parallel(len, input, encoded_len, got,
+				       base64, &executor) == 0);
+		assert(mem_equal(got, expected, encoded_len));
+
+		mem_set(got, 0, encoded_len);
+		assert(base64_encode_parallel(len, input, encoded_len, got,
+				       base64, NULL) == 0);
+		assert(mem_equal(got, expected, encoded_len));
+
+		assert(base64_encode(len, input, encoded_len, expected,
+				       base64url) == 0);
+		mem_set(got, 0, encoded_len);
+		assert(base64_encode_parallel(len, input, encoded_len, got,
+				       base64url, &executor) == 0);
+		assert(mem_equal(got, expected, encoded_len));
+	}
+
+	// The input was split up.
+	assert(num_tasks == 7);
+
+	assert(base64_encode_parallel(400000, input, 533332, got, base64,
+			       &executor) == ENCODING_BUFFER_TOO_SMALL);
+}
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base64/base64.h"
+#include "common.h"
+
+int
+main()
+{
+	uint8_t input[300];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	uint8_t padded[400];
+	uint8_t out[401];
+	for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+		const size_t padded_len = base64_encoded_length(len);
+		assert(base64_encode(len, input, ARRAY_SIZEOF(padded), padded,
+				       base64url) == 0);
+
+		assert(base64_encode_with_padding(len, input, padded_len, out,
+				       base64url,
+				       BASE64_PADDING_REQUIRED) == 0);
+		assert(mem_equal(out, padded, padded_len));
+
+		assert(base64_encode_with_padding(len, input, padded_len, out,
+				       base64url,
+				       BASE64_PADDING_OPTIONAL) == 0);
+		assert(mem_equal(out, padded, padded_len));
+
+		// The unpadded output is the padded output without the '='.
+		const size_t unpadded_len = base64_encoded_length_with_padding(
+				len, BASE64_PADDING_FORBIDDEN);
+		mem_set(out, 0, ARRAY_SIZEOF(out));
+		assert(base64_encode_with_padding(len, input, unpadded_len,
+				       out, base64url,
+				       BASE64_PADDING_FORBIDDEN) == 0);
+		assert(mem_equal(out, padded, unpadded_len));
+		assert(out[unpadded_len] == 0);
+		for (size_t i = unpadded_len; i < padded_len; i += 1) {
+			assert(padded[i] == 0x3d);
+		}
+	}
+
+	// Edge cases
+
+	assert(base64_encode_with_padding(0, NULL, 0, NULL, base64,
+			       BASE64_PADDING_FORBIDDEN) == 0);
+	assert(base64_encode_with_padding(4, input, 5, out, base64,
+			       BASE64_PADDING_FORBIDDEN) ==
+			ENCODING_BUFFER_TOO_SMALL);
+	assert(base64_encode_with_padding(4, input, 6, out, base64,
+			       BASE64_PADDING_REQUIRED) ==
+			ENCODING_BUFFER_TOO_SMALL);
+
+	// Unknown padding values are rejected rather than treated as padded.
+	assert(base64_encoded_length_with_padding(4, 3) == 0);
+	assert(base64_encoded_length_with_padding(4, -1) == 0);
+	assert(base64_encode_with_padding(4, input, 8, out, base64, 3) ==
+			ENCODING_INVALID_ARGUMENT);
+	assert(base64_encode_with_padding(4, input, 8, out, base64, -1) ==
+			ENCODING_INVALID_ARGUMENT);
+	assert(base64_encode_with_padding(0, NULL, 0, NULL, base64, 3) ==
+			ENCODING_INVALID_ARGUMENT);
+}
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base64/base64.h"
+#include "common.h"
+
+int
+main()
+{
+	uint8_t input[500];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	uint8_t encoded[700];
+	uint8_t wrapped[1400];
+
+	// "\r\n"
+	const uint8_t crlf[] = {0x0d, 0x0a};
+
+	const size_t line_lens[] = {4, 8, 64, 76, 1000};
+	for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+		const size_t encoded_len = base64_encoded_length(len);
+		assert(base64_encode(len, input, ARRAY_SIZEOF(encoded),
+				       encoded, base64) == 0);
+
+		for (size_t i = 0; i < ARRAY_SIZEOF(line_lens); i += 1) {
+			const size_t line_len    = line_lens[i];
+			const size_t wrapped_len =
+					base64_encoded_length_wrapped(len,
+							line_len,
+							ARRAY_SIZEOF(crlf));
+			assert(base64_encode_wrapped(len, input, wrapped_len,
+					       wrapped, base64, line_len,
+					       ARRAY_SIZEOF(crlf), crlf) == 0);
+
+			// Removing the separators gives the unwrapped output.
+			size_t j = 0;
+			for (size_t k = 0; k < encoded_len; k += 1) {
+				if (k != 0 && k % line_len == 0) {
+					assert(wrapped[j] == 0x0d);
+					assert(wrapped[j + 1] == 0x0a);
+					j += 2;
+				}
+
+				assert(wrapped[j] == encoded[k]);
+				j += 1;
+			}
+
+			assert(j == wrapped_len);
+		}
+	}
+
+	// An empty separator is the same as base64_encode.
+	assert(base64_encode_wrapped(100, input, ARRAY_SIZEOF(wrapped),
+			       wrapped, base64url, 8, 0, NULL) == 0);
+	assert(base64_encode(100, input, ARRAY_SIZEOF(encoded), encoded,
+			       base64url) == 0);
+	assert(mem_equal(wrapped, encoded, base64_encoded_length(100)));
+
+	// Edge cases
+
+	assert(base64_encode_wrapped(0, NULL, 0, NULL, base64, 76, 2, crlf) ==
+			0);
+	assert(base64_encode_wrapped(58, input, 81, wrapped, base64, 76, 2,
+			       crlf) == ENCODING_BUFFER_TOO_SMALL);
+	assert(base64_encode_wrapped(58, input, ARRAY_SIZEOF(wrapped),
+			       wrapped, base64, 75, 2,
+			       crlf) == ENCODING_INVALID_ARGUMENT);
+	assert(base64_encode_wrapped(58, input, ARRAY_SIZEOF(wrapped),
+			       wrapped, base64, 0, 2,
+			       crlf) == ENCODING_INVALID_ARGUMENT);
+}
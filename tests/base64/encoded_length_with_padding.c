@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base64/base64.h"
+#include "common.h"
+
+int
+main()
+{
+	for (size_t i = 0; i < 100; i += 1) {
+		assert(base64_encoded_length_with_padding(
+				       i, BASE64_PADDING_REQUIRED) ==
+				base64_encoded_length(i));
+		assert(base64_encoded_length_with_padding(
+				       i, BASE64_PADDING_OPTIONAL) ==
+				base64_encoded_length(i));
+	}
+
+	assert(base64_encoded_length_with_padding(
+			       0, BASE64_PADDING_FORBIDDEN) == 0);
+	assert(base64_encoded_length_with_padding(
+			       1, BASE64_PADDING_FORBIDDEN) == 2);
+	assert(base64_encoded_length_with_padding(
+			       2, BASE64_PADDING_FORBIDDEN) == 3);
+	assert(base64_encoded_length_with_padding(
+			       3, BASE64_PADDING_FORBIDDEN) == 4);
+	assert(base64_encoded_length_with_padding(
+			       4, BASE64_PADDING_FORBIDDEN) == 6);
+	assert(base64_encoded_length_with_padding(
+			       5, BASE64_PADDING_FORBIDDEN) == 7);
+	assert(base64_encoded_length_with_padding(
+			       6, BASE64_PADDING_FORBIDDEN) == 8);
+}
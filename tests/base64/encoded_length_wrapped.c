@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base64/base64.h"
+#include "common.h"
+
+int
+main()
+{
+	assert(base64_encoded_length_wrapped(0, 76, 2) == 0);
+	assert(base64_encoded_length_wrapped(1, 76, 2) == 4);
+	assert(base64_encoded_length_wrapped(57, 76, 2) == 76);
+	assert(base64_encoded_length_wrapped(58, 76, 2) == 82);
+	assert(base64_encoded_length_wrapped(114, 76, 2) == 154);
+	assert(base64_encoded_length_wrapped(115, 76, 2) == 160);
+	assert(base64_encoded_length_wrapped(48, 64, 1) == 64);
+	assert(base64_encoded_length_wrapped(49, 64, 1) == 69);
+	assert(base64_encoded_length_wrapped(6, 4, 0) == 8);
+}
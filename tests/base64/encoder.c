@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base64/base64.h"
+#include "common.h"
+
+int
+main()
+{
+	uint8_t input[500];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	uint8_t expected[700];
+	uint8_t out[700];
+
+	// Encoding in chunks of every size gives the same result as encoding
+	// all at once.
+	const size_t lens[] = {0, 1, 2, 3, 4, 5, 31, 100, 500};
+	for (size_t i = 0; i < ARRAY_SIZEOF(lens); i += 1) {
+		const size_t len         = lens[i];
+		const size_t encoded_len = base64_encoded_length(len);
+		assert(base64_encode(len, input, ARRAY_SIZEOF(expected),
+				       expected, base64) == 0);
+
+		for (size_t chunk = 1; chunk <= 70; chunk += 1) {
+			struct base64_encoder encoder;
+			base64_encoder_init(&encoder, base64);
+
+			size_t j = 0;
+			for (size_t k = 0; k < len; k += chunk) {
+				const size_t n = len - k < chunk ? len - k
+								 : chunk;
+				size_t written = 0;
+				assert(base64_encoder_update(&encoder, n,
+						       &input[k],
+						       ARRAY_SIZEOF(out) - j,
+						       &out[j],
+						       &written) == 0);
+				j += written;
+			}
+
+			size_t written = 0;
+			assert(base64_encoder_final(&encoder, 4, &out[j],
+					       &written) == 0);
+			j += written;
+
+			assert(j == encoded_len);
+			assert(mem_equal(out, expected, encoded_len));
+		}
+	}
+
+	// Small buffers
+
+	struct base64_encoder encoder;
+	base64_encoder_init(&encoder, base64url);
+	assert(base64_encoder_update_length(&encoder, 2) == 0);
+	assert(base64_encoder_update(&encoder, 2, input, 0, NULL, NULL) == 0);
+	assert(base64_encoder_update_length(&encoder, 1) == 4);
+	assert(base64_encoder_update(&encoder, 1, &input[2], 3, out, NULL) ==
+			ENCODING_BUFFER_TOO_SMALL);
+	assert(base64_encoder_update(&encoder, 1, &input[2], 4, out, NULL) ==
+			0);
+	assert(base64_encoder_update(&encoder, 1, &input[3], 0, NULL, NULL) ==
+			0);
+	assert(base64_encoder_final(&encoder, 3, &out[4], NULL) ==
+			ENCODING_BUFFER_TOO_SMALL);
+	assert(base64_encoder_final(&encoder, 4, &out[4], NULL) == 0);
+	assert(base64_encode(4, input, ARRAY_SIZEOF(expected), expected,
+			       base64url) == 0);
+	assert(mem_equal(out, expected, 8));
+
+	// Edge cases
+
+	size_t written = 1;
+	assert(base64_encoder_final(&encoder, 0, NULL, &written) == 0);
+	assert(written == 0);
+	assert(base64_encoder_update(&encoder, 0, NULL, 0, NULL, &written) ==
+			0);
+	assert(written == 0);
+}
@@ -79,4 +79,41 @@ main()
 
 	assert(!base64_valid(1, NULL, base64));
 	assert(!base64_valid(lens[1], rfc4648_cases[1], NULL));
+
+	// The last group is checked when there's no padding.
+	const uint8_t last_group[] = "Zm9vYmF!";
+	assert(!base64_valid(sizeof(last_group) - 1, last_group, base64));
+	assert(!base64_valid(sizeof(last_group) - 1, last_group, base64url));
+
+	// Try every byte in every position, covering both the part of the
+	// input checked 8 characters at a time and the part after it.
+	const uint8_t* alphabets[] = {base64, base64url};
+	for (size_t i = 0; i < ARRAY_SIZEOF(alphabets); i += 1) {
+		const uint8_t* alphabet = alphabets[i];
+
+		uint8_t str[20];
+		for (size_t j = 0; j < ARRAY_SIZEOF(str); j += 1) {
+			str[j] = alphabet[j * 3];
+		}
+
+		for (size_t j = 0; j < ARRAY_SIZEOF(str); j += 1) {
+			for (size_t c = 0; c < 256; c += 1) {
+				// '=' would be taken as padding at the end.
+				if (c == 0x3d) {
+					continue;
+				}
+
+				bool expected = false;
+				for (size_t k = 0; k < 64; k += 1) {
+					expected |= alphabet[k] == c;
+				}
+
+				const uint8_t old = str[j];
+				str[j]            = (uint8_t)c;
+				assert(base64_valid(ARRAY_SIZEOF(str), str,
+						       alphabet) == expected);
+				str[j] = old;
+			}
+		}
+	}
 }
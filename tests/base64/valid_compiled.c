@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base64/base64.h"
+#include "common.h"
+
+// The base64 alphabet, but with the last two characters being '.' and '_'.
+static const uint8_t sample_alphabet[64] = {
+		// ASCII 'A' to 'Z'
+		0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a,
+		0x4b, 0x4c, 0x4d, 0x4e, 0x4f, 0x50, 0x51, 0x52, 0x53, 0x54,
+		0x55, 0x56, 0x57, 0x58, 0x59, 0x5a,
+		// ASCII 'a' to 'z'
+		0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+		0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72, 0x73, 0x74,
+		0x75, 0x76, 0x77, 0x78, 0x79, 0x7a,
+		// ASCII '0' to '9'
+		0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39,
+		0x2e, // '.'
+		0x5f, // '_'
+};
+
+int
+main()
+{
+	struct base64_alphabet compiled_base64;
+	struct base64_alphabet compiled_sample;
+	assert(base64_alphabet_compile(base64, &compiled_base64) == 0);
+	assert(base64_alphabet_compile(sample_alphabet, &compiled_sample) ==
+			0);
+
+	// "Zm9vYmE="
+	const uint8_t foobar[] = {
+			0x5a, 0x6d, 0x39, 0x76, 0x59, 0x6d, 0x45, 0x3d};
+	assert(base64_valid_compiled(
+			ARRAY_SIZEOF(foobar), foobar, &compiled_base64));
+	assert(base64_valid_compiled(
+			ARRAY_SIZEOF(foobar), foobar, &compiled_sample));
+
+	// "Pz8/Pz8."
+	uint8_t mixed[] = {0x50, 0x7a, 0x38, 0x2f, 0x50, 0x7a, 0x38, 0x2e};
+	assert(!base64_valid_compiled(
+			ARRAY_SIZEOF(mixed), mixed, &compiled_base64));
+	assert(!base64_valid_compiled(
+			ARRAY_SIZEOF(mixed), mixed, &compiled_sample));
+
+	// "Pz8_Pz8."
+	mixed[3] = 0x5f;
+	assert(base64_valid_compiled(
+			ARRAY_SIZEOF(mixed), mixed, &compiled_sample));
+
+	// An alphabet in no particular order, which also has bytes of 0x80
+	// and above.
+	uint8_t scrambled[64];
+	for (size_t i = 0; i < 64; i += 1) {
+		scrambled[i] = (uint8_t)(i * 167 + 1);
+	}
+
+	struct base64_alphabet compiled_scrambled;
+	assert(base64_alphabet_compile(scrambled, &compiled_scrambled) == 0);
+
+	uint8_t input[100];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	uint8_t encoded[136];
+	assert(base64_encode(ARRAY_SIZEOF(input), input, ARRAY_SIZEOF(encoded),
+			       encoded, scrambled) == 0);
+	assert(base64_valid_compiled(ARRAY_SIZEOF(encoded), encoded,
+			&compiled_scrambled));
+
+	// 0x00 isn't part of scrambled.
+	for (size_t i = 0; i < ARRAY_SIZEOF(encoded) - 2; i += 1) {
+		const uint8_t c = encoded[i];
+		encoded[i]      = 0x00;
+		assert(!base64_valid_compiled(ARRAY_SIZEOF(encoded), encoded,
+				&compiled_scrambled));
+		encoded[i] = c;
+	}
+
+	// Edge cases
+
+	assert(base64_valid_compiled(0, NULL, &compiled_sample));
+	assert(!base64_valid_compiled(3, foobar, &compiled_sample));
+	assert(!base64_valid_compiled(ARRAY_SIZEOF(foobar), NULL,
+			&compiled_sample));
+}
@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../base64/base64.h"
+#include "common.h"
+
+// The base64 alphabet, but with the last two characters being '.' and '_'.
+static const uint8_t sample_alphabet[64] = {
+		// ASCII 'A' to 'Z'
+		0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a,
+		0x4b, 0x4c, 0x4d, 0x4e, 0x4f, 0x50, 0x51, 0x52, 0x53, 0x54,
+		0x55, 0x56, 0x57, 0x58, 0x59, 0x5a,
+		// ASCII 'a' to 'z'
+		0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+		0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72, 0x73, 0x74,
+		0x75, 0x76, 0x77, 0x78, 0x79, 0x7a,
+		// ASCII '0' to '9'
+		0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39,
+		0x2e, // '.'
+		0x5f, // '_'
+};
+
+int
+main()
+{
+	const uint8_t* alphabets[] = {base64, base64url, sample_alphabet};
+
+	// "Zm9vYg==", "Zm9vYg" and "Zm9vYmE"
+	const uint8_t padded[]    = {0x5a, 0x6d, 0x39, 0x76, 0x59, 0x67, 0x3d,
+			   0x3d};
+	const uint8_t unpadded2[] = {0x5a, 0x6d, 0x39, 0x76, 0x59, 0x67};
+	const uint8_t unpadded3[] = {
+			0x5a, 0x6d, 0x39, 0x76, 0x59, 0x6d, 0x45};
+	for (size_t i = 0; i < ARRAY_SIZEOF(alphabets); i += 1) {
+		const uint8_t* alphabet = alphabets[i];
+
+		assert(base64_valid_with_padding(ARRAY_SIZEOF(padded), padded,
+				alphabet, BASE64_PADDING_REQUIRED));
+		assert(base64_valid_with_padding(ARRAY_SIZEOF(padded), padded,
+				alphabet, BASE64_PADDING_OPTIONAL));
+		assert(!base64_valid_with_padding(ARRAY_SIZEOF(padded), padded,
+				alphabet, BASE64_PADDING_FORBIDDEN));
+
+		assert(!base64_valid_with_padding(ARRAY_SIZEOF(unpadded2),
+				unpadded2, alphabet, BASE64_PADDING_REQUIRED));
+		assert(base64_valid_with_padding(ARRAY_SIZEOF(unpadded2),
+				unpadded2, alphabet, BASE64_PADDING_OPTIONAL));
+		assert(base64_valid_with_padding(ARRAY_SIZEOF(unpadded3),
+				unpadded3, alphabet,
+				BASE64_PADDING_FORBIDDEN));
+
+		// A lone character in the last quantum
+		assert(!base64_valid_with_padding(5, unpadded3, alphabet,
+				BASE64_PADDING_FORBIDDEN));
+		// Too little padding
+		assert(!base64_valid_with_padding(7, padded, alphabet,
+				BASE64_PADDING_OPTIONAL));
+	}
+
+	// Characters in the tail are checked: "Zm9vY/" and "Zm9vY_"
+	uint8_t tail[] = {0x5a, 0x6d, 0x39, 0x76, 0x59, 0x2f};
+	assert(base64_valid_with_padding(ARRAY_SIZEOF(tail), tail, base64,
+			BASE64_PADDING_FORBIDDEN));
+	assert(!base64_valid_with_padding(ARRAY_SIZEOF(tail), tail, base64url,
+			BASE64_PADDING_FORBIDDEN));
+	tail[5] = 0x5f;
+	assert(!base64_valid_with_padding(ARRAY_SIZEOF(tail), tail, base64,
+			BASE64_PADDING_FORBIDDEN));
+	assert(base64_valid_with_padding(ARRAY_SIZEOF(tail), tail, base64url,
+			BASE64_PADDING_FORBIDDEN));
+
+	// Edge cases
+
+	assert(base64_valid_with_padding(
+			0, NULL, base64, BASE64_PADDING_FORBIDDEN));
+	assert(!base64_valid_with_padding(
+			ARRAY_SIZEOF(padded), padded, base64, 3));
+}
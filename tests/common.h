@@ -3,6 +3,7 @@
 
 #include <assert.h>
 #include <inttypes.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
@@ -34,4 +35,52 @@ mem_set(uint8_t* dest, const uint8_t byte, const size_t n)
 	}
 }
 
+struct thread_task {
+	void (*task)(void* context, size_t index);
+	void*  context;
+	size_t index;
+};
+
+static inline void*
+thread_task_run(void* arg)
+{
+	struct thread_task* t = (struct thread_task*)arg;
+	t->task(t->context, t->index);
+	return NULL;
+}
+
+// thread_executor_run can be used as the run function of an
+// encoding_executor. It runs every task on its own thread, starting them
+// backwards so that any task depending on an earlier one having run is
+// caught. user must point to a size_t, which is set to count.
+static inline void
+thread_executor_run(void* user, size_t count,
+		void (*task)(void* context, size_t index), void* context)
+{
+	*(size_t*)user = count;
+
+	pthread_t* threads = (pthread_t*)malloc(count * sizeof(*threads));
+	struct thread_task* tasks =
+			(struct thread_task*)malloc(count * sizeof(*tasks));
+	assert(count == 0 || (threads != NULL && tasks != NULL));
+
+	for (size_t i = count; i > 0; i -= 1) {
+		tasks[i - 1].task    = task;
+		tasks[i - 1].context = context;
+		tasks[i - 1].index   = i - 1;
+
+		const int err = pthread_create(&threads[i - 1], NULL,
+				thread_task_run, &tasks[i - 1]);
+		assert(err == 0);
+		(void)err;
+	}
+
+	for (size_t i = 0; i < count; i += 1) {
+		pthread_join(threads[i], NULL);
+	}
+
+	free(threads);
+	free(tasks);
+}
+
 #endif // TEST_COMMON_H
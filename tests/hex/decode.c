@@ -23,6 +23,54 @@ main()
 	assert(hex_decode(ARRAY_SIZEOF(bytes_cap), bytes_cap, 1, &out) == 0);
 	assert(out == 0xf5);
 
+	// Every length, in lowercase and uppercase, so that every mix of the
+	// SIMD and scalar decoders is used.
+	uint8_t input[300];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	uint8_t encoded[600];
+	uint8_t decoded[300];
+	for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+		int err = hex_encode(
+				len, input, ARRAY_SIZEOF(encoded), encoded);
+		assert(err == 0);
+		mem_set(decoded, 0, ARRAY_SIZEOF(decoded));
+		assert(hex_decode(len * 2, encoded, ARRAY_SIZEOF(decoded),
+				       decoded) == 0);
+		assert(mem_equal(decoded, input, len));
+
+		assert(hex_encode_upper(len, input, ARRAY_SIZEOF(encoded),
+				       encoded) == 0);
+		mem_set(decoded, 0, ARRAY_SIZEOF(decoded));
+		assert(hex_decode(len * 2, encoded, ARRAY_SIZEOF(decoded),
+				       decoded) == 0);
+		assert(mem_equal(decoded, input, len));
+	}
+
+	// Every byte which isn't hexadecimal is rejected in every position.
+	const size_t long_len = 130;
+	assert(hex_encode(long_len / 2, input, ARRAY_SIZEOF(encoded),
+			       encoded) == 0);
+	for (size_t c = 0; c < 256; c += 1) {
+		const bool valid = (c >= 0x30 && c <= 0x39) ||
+				   (c >= 0x41 && c <= 0x46) ||
+				   (c >= 0x61 && c <= 0x66);
+		if (valid) {
+			continue;
+		}
+
+		for (size_t i = 0; i < long_len; i += 1) {
+			const uint8_t saved = encoded[i];
+			encoded[i]          = (uint8_t)c;
+			int err = hex_decode(long_len, encoded,
+					ARRAY_SIZEOF(decoded), decoded);
+			assert(err == ENCODING_INVALID_ARGUMENT);
+			encoded[i] = saved;
+		}
+	}
+
 	// Invalid length
 	assert(hex_decode(ARRAY_SIZEOF(bytes_cap) - 1, bytes_cap, 1, &out) ==
 			ENCODING_INVALID_ARGUMENT);
@@ -33,4 +81,5 @@ main()
 
 	// Edge cases
 	assert(hex_decode(2, bytes, 0, NULL) == ENCODING_BUFFER_TOO_SMALL);
+	assert(hex_decode(0, NULL, 0, NULL) == 0);
 }
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../../hex/hex.h"
+#include "common.h"
+
+int
+main()
+{
+	uint8_t input[500];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	uint8_t buf[1000];
+	for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+		assert(hex_encode(len, input, ARRAY_SIZEOF(buf), buf) == 0);
+
+		size_t out_len = 1;
+		assert(hex_decode_in_place(hex_encoded_length(len), buf,
+				       &out_len) == 0);
+		assert(out_len == len);
+		assert(mem_equal(buf, input, len));
+	}
+
+	// Invalid length
+	uint8_t odd[] = {0x35, 0x66, 0x35};
+	assert(hex_decode_in_place(ARRAY_SIZEOF(odd), odd, NULL) ==
+			ENCODING_INVALID_ARGUMENT);
+
+	// Invalid character: "5g"
+	uint8_t invalid[] = {0x35, 0x67};
+	assert(hex_decode_in_place(ARRAY_SIZEOF(invalid), invalid, NULL) ==
+			ENCODING_INVALID_ARGUMENT);
+
+	// Edge cases
+
+	size_t out_len = 1;
+	assert(hex_decode_in_place(0, NULL, &out_len) == 0);
+	assert(out_len == 0);
+}
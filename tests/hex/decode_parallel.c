@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "../../hex/hex.h"
+#include "common.h"
+
+static uint8_t input[400001];
+static uint8_t encoded[800002];
+static uint8_t got[400001];
+
+int
+main()
+{
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 131 + (i >> 9));
+	}
+
+	size_t                   num_tasks = 0;
+	struct encoding_executor executor  = {
+			thread_executor_run, &num_tasks, 7};
+
+	const size_t lens[] = {0, 1, 65535, 65536, 65537, 400000, 400001};
+	for (size_t i = 0; i < ARRAY_SIZEOF(lens); i += 1) {
+		const size_t len         = lens[i];
+		const size_t encoded_len = hex_encoded_length(len);
+
+		assert(hex_encode(len, input, encoded_len, encoded) == 0);
+
+		mem_set(got, 0, len);
+		assert(hex_decode_parallel(encoded_len, encoded, len, got,
+				       &executor) == 0);
+		assert(mem_equal(got, input, len));
+
+		mem_set(got, 0, len);
+		assert(hex_decode_parallel(encoded_len, encoded, len, got,
+				       NULL) == 0);
+		assert(mem_equal(got, input, len));
+	}
+
+	// The input was split up.
+	assert(num_tasks == 7);
+
+	assert(hex_decode_parallel(800000, encoded, 399999, got, &executor) ==
+			ENCODING_BUFFER_TOO_SMALL);
+	assert(hex_decode_parallel(799999, encoded, 400000, got, &executor) ==
+			ENCODING_INVALID_ARGUMENT);
+}
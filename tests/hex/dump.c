@@ -8,6 +8,53 @@
 #include "../../hex/hex.h"
 #include "common.h"
 
+// Formats buf the way hex_dump is documented to, one character at a time.
+static size_t
+reference_dump(const size_t buf_len, const uint8_t* buf, uint64_t address,
+		uint8_t* out)
+{
+	size_t j = 0;
+	for (size_t i = 0; i < buf_len; i += 16, address += 16) {
+		char tmp[16];
+		const unsigned low_bits = (unsigned)(address & 0xffffffff);
+		snprintf(tmp, sizeof(tmp), "%08x  ", low_bits);
+		for (size_t k = 0; k < 10; k += 1, j += 1) {
+			out[j] = (uint8_t)tmp[k];
+		}
+
+		for (size_t k = 0; k < 16; k += 1) {
+			if (i + k < buf_len) {
+				const unsigned c = buf[i + k];
+				snprintf(tmp, sizeof(tmp), "%02x ", c);
+			} else {
+				snprintf(tmp, sizeof(tmp), "   ");
+			}
+
+			for (size_t c = 0; c < 3; c += 1, j += 1) {
+				out[j] = (uint8_t)tmp[c];
+			}
+
+			if (k == 7 || k == 15) {
+				out[j] = 0x20;
+				j += 1;
+			}
+		}
+
+		out[j] = 0x7c;
+		j += 1;
+		for (size_t k = 0; k < 16 && i + k < buf_len; k += 1, j += 1) {
+			const uint8_t c = buf[i + k];
+			out[j]          = (c >= 0x20 && c <= 0x7e) ? c : 0x2e;
+		}
+
+		out[j]     = 0x7c;
+		out[j + 1] = 0x0a;
+		j += 2;
+	}
+
+	return j;
+}
+
 int
 main()
 {
@@ -129,7 +176,9 @@ main()
 	assert(hex_dump(ARRAY_SIZEOF(bytes), bytes, ARRAY_SIZEOF(out), out,
 			       &tmp) == 0);
 	assert(mem_equal(out, result3, ARRAY_SIZEOF(result3)));
+	assert(tmp == 1000000000000 + ARRAY_SIZEOF(bytes));
 
+	tmp = 1000000000000;
 	assert(hex_dump(ARRAY_SIZEOF(bytes) - 1, bytes, ARRAY_SIZEOF(out), out,
 			       &tmp) == 0);
 	assert(mem_equal(out, result4, ARRAY_SIZEOF(result4)));
@@ -149,6 +198,44 @@ main()
 	assert(hex_dump(1, ascii, ARRAY_SIZEOF(out), out, NULL) == 0);
 	assert(mem_equal(out, asciiresult, ARRAY_SIZEOF(asciiresult)));
 
+	// Every length against the reference, checking that hex_dump_length is
+	// exact and that nothing is written past it.
+	static uint8_t input[300];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 37 + 11);
+	}
+
+	static uint8_t expected[2000];
+	for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+		const size_t dump_len = hex_dump_length(len);
+		assert(reference_dump(len, input, 0xfffffff0, expected) ==
+				dump_len);
+
+		mem_set(out, 0, dump_len + 1);
+		uint64_t address = 0xfffffff0;
+		assert(hex_dump(len, input, dump_len, out, &address) == 0);
+		assert(mem_equal(out, expected, dump_len));
+		assert(out[dump_len] == 0);
+		assert(address == 0xfffffff0 + len);
+
+		if (dump_len != 0) {
+			assert(hex_dump(len, input, dump_len - 1, out, NULL) ==
+					ENCODING_BUFFER_TOO_SMALL);
+		}
+	}
+
+	// Every byte.
+	uint8_t all[256];
+	for (size_t i = 0; i < ARRAY_SIZEOF(all); i += 1) {
+		all[i] = (uint8_t)i;
+	}
+
+	const size_t all_len = hex_dump_length(ARRAY_SIZEOF(all));
+	assert(reference_dump(ARRAY_SIZEOF(all), all, 0, expected) == all_len);
+	assert(hex_dump(ARRAY_SIZEOF(all), all, ARRAY_SIZEOF(out), out,
+			       NULL) == 0);
+	assert(mem_equal(out, expected, all_len));
+
 	// Test if ENCODING_INVALID_ARGUMENT is returned when address would
 	// overflow.
 	size_t off = SIZE_MAX;
@@ -156,6 +243,11 @@ main()
 			       &off) == ENCODING_INVALID_ARGUMENT);
 
 	// Edge cases.
+	assert(hex_dump_length(0) == 0);
+	assert(hex_dump_length(1) == 64);
+	assert(hex_dump_length(16) == 79);
+	assert(hex_dump_length(17) == 79 + 64);
+	assert(hex_dump(0, NULL, 0, NULL, NULL) == 0);
 	assert(hex_dump(1, bytes, 0, NULL, NULL) == ENCODING_BUFFER_TOO_SMALL);
 	assert(hex_dump(ARRAY_SIZEOF(bytes), bytes, 1, out, NULL) ==
 			ENCODING_BUFFER_TOO_SMALL);
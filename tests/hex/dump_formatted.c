@@ -0,0 +1,208 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../hex/hex.h"
+#include "common.h"
+
+// Appends str to out at *j.
+static void
+append(const char* str, uint8_t* out, size_t* j)
+{
+	if (str == NULL) {
+		return;
+	}
+
+	for (size_t i = 0; str[i] != '\0'; i += 1, *j += 1) {
+		out[*j] = (uint8_t)str[i];
+	}
+}
+
+// Formats buf the way hex_dump_format is documented to, one line at a time.
+static size_t
+reference_dump(const size_t buf_len, const uint8_t* buf, uint64_t address,
+		const struct hex_dump_format* format, uint8_t* out)
+{
+	const size_t row = format->bytes_per_row;
+
+	size_t j = 0;
+	for (size_t i = 0; i < buf_len; i += row, address += row) {
+		const size_t line_len = buf_len - i < row ? buf_len - i : row;
+		const size_t columns  = format->ascii ? row : line_len;
+
+		char tmp[32];
+		append(format->line_prefix, out, &j);
+		if (format->address_width != 0) {
+			snprintf(tmp, sizeof(tmp),
+					format->uppercase ? "%016" PRIX64
+							  : "%016" PRIx64,
+					address);
+			append(&tmp[16 - format->address_width], out, &j);
+			append(format->address_separator, out, &j);
+		}
+
+		for (size_t k = 0; k < columns; k += 1) {
+			if (k < line_len) {
+				const unsigned c = buf[i + k];
+				snprintf(tmp, sizeof(tmp),
+						format->uppercase ? "%02X"
+								  : "%02x",
+						c);
+				append(format->byte_prefix, out, &j);
+				append(tmp, out, &j);
+				append(format->byte_suffix, out, &j);
+			} else {
+				size_t width = 2;
+				if (format->byte_prefix != NULL) {
+					width += strlen(format->byte_prefix);
+				}
+
+				if (format->byte_suffix != NULL) {
+					width += strlen(format->byte_suffix);
+				}
+
+				for (size_t c = 0; c < width; c += 1) {
+					append(" ", out, &j);
+				}
+			}
+
+			if ((k + 1) % format->group_size == 0 ||
+					k + 1 == columns) {
+				append(format->group_separator, out, &j);
+			} else {
+				append(format->byte_separator, out, &j);
+			}
+		}
+
+		if (format->ascii) {
+			append(format->ascii_prefix, out, &j);
+			for (size_t k = 0; k < line_len; k += 1, j += 1) {
+				const uint8_t c = buf[i + k];
+				out[j] = (c >= 0x20 && c <= 0x7e) ? c : 0x2e;
+			}
+
+			append(format->ascii_suffix, out, &j);
+		}
+
+		append(format->line_suffix, out, &j);
+	}
+
+	return j;
+}
+
+static void
+check_dump(const size_t buf_len, const uint8_t* buf,
+		const struct hex_dump_format* format, const char* expected)
+{
+	static uint8_t out[1000];
+
+	const size_t expected_len = strlen(expected);
+	assert(hex_dump_formatted_length(buf_len, format) == expected_len);
+
+	mem_set(out, 0, ARRAY_SIZEOF(out));
+	assert(hex_dump_formatted(buf_len, buf, expected_len, out, NULL,
+			       format) == 0);
+	assert(mem_equal(out, (const uint8_t*)expected, expected_len));
+	assert(out[expected_len] == 0);
+}
+
+int
+main()
+{
+	// "*.obj\n*.exe\nTODO\n.build*\n.cac"
+	const uint8_t sample[] = {0x2a, 0x2e, 0x6f, 0x62, 0x6a, 0x0a, 0x2a,
+			0x2e, 0x65, 0x78, 0x65, 0x0a, 0x54, 0x4f, 0x44, 0x4f,
+			0x0a, 0x2e, 0x62, 0x75, 0x69, 0x6c, 0x64, 0x2a, 0x0a,
+			0x2e, 0x63, 0x61, 0x63};
+
+	// The output of xxd, od -An -tx1 and xxd -i for sample. Unlike xxd -i,
+	// the last byte of the C array is followed by a comma too.
+	check_dump(ARRAY_SIZEOF(sample), sample, &hex_dump_format_xxd,
+			"00000000: 2a2e 6f62 6a0a 2a2e 6578 650a 544f 444f  "
+			"*.obj.*.exe.TODO\n"
+			"00000010: 0a2e 6275 696c 642a 0a2e 6361 63         "
+			"..build*..cac\n");
+	check_dump(ARRAY_SIZEOF(sample), sample, &hex_dump_format_od,
+			" 2a 2e 6f 62 6a 0a 2a 2e 65 78 65 0a 54 4f 44 4f\n"
+			" 0a 2e 62 75 69 6c 64 2a 0a 2e 63 61 63\n");
+	check_dump(ARRAY_SIZEOF(sample), sample, &hex_dump_format_c_array,
+			"  0x2a, 0x2e, 0x6f, 0x62, 0x6a, 0x0a, 0x2a, 0x2e, "
+			"0x65, 0x78, 0x65, 0x0a,\n"
+			"  0x54, 0x4f, 0x44, 0x4f, 0x0a, 0x2e, 0x62, 0x75, "
+			"0x69, 0x6c, 0x64, 0x2a,\n"
+			"  0x0a, 0x2e, 0x63, 0x61, 0x63,\n");
+	check_dump(ARRAY_SIZEOF(sample), sample, &hex_dump_format_canonical,
+			"00000000  2a 2e 6f 62 6a 0a 2a 2e  65 78 65 0a 54 4f "
+			"44 4f  |*.obj.*.exe.TODO|\n"
+			"00000010  0a 2e 62 75 69 6c 64 2a  0a 2e 63 61 63    "
+			"       |..build*..cac|\n");
+
+	// Every preset and some custom formats against the reference, for
+	// every length.
+	const struct hex_dump_format wide = {32, 4, 16, true, true, "> ",
+			NULL, NULL, NULL, " ", " | ", "[", "]", "\r\n"};
+	const struct hex_dump_format single = {1, 1, 4, false, false, NULL,
+			":", "\\x", NULL, NULL, NULL, NULL, NULL, ";"};
+	const struct hex_dump_format widest = {HEX_DUMP_MAX_BYTES_PER_ROW, 3,
+			1, true, false, "", " ", "", "", "", "", "", "", "\n"};
+	const struct hex_dump_format* formats[] = {&hex_dump_format_canonical,
+			&hex_dump_format_xxd, &hex_dump_format_od,
+			&hex_dump_format_c_array, &wide, &single, &widest};
+
+	static uint8_t input[300];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 37 + 11);
+	}
+
+	static uint8_t expected[10000];
+	static uint8_t out[10000];
+	for (size_t f = 0; f < ARRAY_SIZEOF(formats); f += 1) {
+		for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+			const size_t dump_len = hex_dump_formatted_length(
+					len, formats[f]);
+			assert(reference_dump(len, input, 0x123456789abcdef0,
+					       formats[f],
+					       expected) == dump_len);
+
+			mem_set(out, 0, dump_len + 1);
+			uint64_t address = 0x123456789abcdef0;
+			int      err     = hex_dump_formatted(len, input,
+					     dump_len, out, &address,
+					     formats[f]);
+			assert(err == 0);
+			assert(mem_equal(out, expected, dump_len));
+			assert(out[dump_len] == 0);
+			assert(address == 0x123456789abcdef0 + len);
+		}
+	}
+
+	// Invalid formats
+
+	struct hex_dump_format invalid = hex_dump_format_canonical;
+	invalid.bytes_per_row          = 0;
+	assert(hex_dump_formatted(1, input, ARRAY_SIZEOF(out), out, NULL,
+			       &invalid) == ENCODING_INVALID_ARGUMENT);
+	invalid.bytes_per_row = HEX_DUMP_MAX_BYTES_PER_ROW + 1;
+	assert(hex_dump_formatted(1, input, ARRAY_SIZEOF(out), out, NULL,
+			       &invalid) == ENCODING_INVALID_ARGUMENT);
+	invalid.bytes_per_row = 16;
+	invalid.group_size    = 0;
+	assert(hex_dump_formatted(1, input, ARRAY_SIZEOF(out), out, NULL,
+			       &invalid) == ENCODING_INVALID_ARGUMENT);
+	invalid.group_size    = 8;
+	invalid.address_width = 17;
+	assert(hex_dump_formatted(1, input, ARRAY_SIZEOF(out), out, NULL,
+			       &invalid) == ENCODING_INVALID_ARGUMENT);
+
+	// Edge cases
+
+	assert(hex_dump_formatted(0, NULL, 0, NULL, NULL,
+			       &hex_dump_format_xxd) == 0);
+	assert(hex_dump_formatted(1, input, 0, NULL, NULL,
+			       &hex_dump_format_od) ==
+			ENCODING_BUFFER_TOO_SMALL);
+}
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../../hex/hex.h"
+#include "common.h"
+
+int
+main()
+{
+	uint8_t input[200];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 37 + 11);
+	}
+
+	static uint8_t expected[2000];
+	static uint8_t out[2000];
+
+	// Dumping in chunks of every size gives the same result as dumping
+	// all at once.
+	const size_t lens[] = {0, 1, 15, 16, 17, 31, 32, 33, 100, 200};
+	for (size_t i = 0; i < ARRAY_SIZEOF(lens); i += 1) {
+		const size_t len      = lens[i];
+		const size_t dump_len = hex_dump_length(len);
+		uint64_t     address  = 0x1234;
+		assert(hex_dump(len, input, ARRAY_SIZEOF(expected), expected,
+				       &address) == 0);
+
+		for (size_t chunk = 1; chunk <= 40; chunk += 1) {
+			struct hex_dumper dumper;
+			hex_dumper_init(&dumper, 0x1234);
+
+			size_t j = 0;
+			for (size_t k = 0; k < len; k += chunk) {
+				const size_t n = len - k < chunk ? len - k
+								 : chunk;
+				const size_t update_len =
+						hex_dumper_update_length(
+								&dumper, n);
+				size_t written = 1;
+				assert(hex_dumper_update(&dumper, n,
+						       &input[k], update_len,
+						       &out[j],
+						       &written) == 0);
+				assert(written == update_len);
+				j += written;
+			}
+
+			size_t written = 0;
+			assert(hex_dumper_final(&dumper, 79, &out[j],
+					       &written) == 0);
+			j += written;
+
+			assert(j == dump_len);
+			assert(mem_equal(out, expected, dump_len));
+		}
+	}
+
+	// The same with every other format.
+	const struct hex_dump_format* formats[] = {&hex_dump_format_xxd,
+			&hex_dump_format_od, &hex_dump_format_c_array};
+	for (size_t f = 0; f < ARRAY_SIZEOF(formats); f += 1) {
+		const size_t len      = ARRAY_SIZEOF(input);
+		const size_t dump_len =
+				hex_dump_formatted_length(len, formats[f]);
+		assert(hex_dump_formatted(len, input, ARRAY_SIZEOF(expected),
+				       expected, NULL, formats[f]) == 0);
+
+		for (size_t chunk = 1; chunk <= 40; chunk += 1) {
+			struct hex_dumper dumper;
+			assert(hex_dumper_init_formatted(
+					       &dumper, 0, formats[f]) == 0);
+
+			size_t j = 0;
+			for (size_t k = 0; k < len; k += chunk) {
+				const size_t n = len - k < chunk ? len - k
+								 : chunk;
+				size_t written = 0;
+				assert(hex_dumper_update(&dumper, n,
+						       &input[k],
+						       ARRAY_SIZEOF(out) - j,
+						       &out[j],
+						       &written) == 0);
+				j += written;
+			}
+
+			size_t written = 0;
+			assert(hex_dumper_final(&dumper, ARRAY_SIZEOF(out) - j,
+					       &out[j], &written) == 0);
+			j += written;
+
+			assert(j == dump_len);
+			assert(mem_equal(out, expected, dump_len));
+		}
+	}
+
+	// Small buffers
+
+	struct hex_dumper dumper;
+	hex_dumper_init(&dumper, 0);
+	assert(hex_dumper_update_length(&dumper, 15) == 0);
+	assert(hex_dumper_update(&dumper, 15, input, 0, NULL, NULL) == 0);
+	assert(hex_dumper_update_length(&dumper, 2) == 79);
+	assert(hex_dumper_update(&dumper, 2, &input[15], 78, out, NULL) ==
+			ENCODING_BUFFER_TOO_SMALL);
+	assert(hex_dumper_update(&dumper, 2, &input[15], 79, out, NULL) == 0);
+	assert(hex_dumper_final(&dumper, 63, &out[79], NULL) ==
+			ENCODING_BUFFER_TOO_SMALL);
+	assert(hex_dumper_final(&dumper, 64, &out[79], NULL) == 0);
+	assert(hex_dump(17, input, ARRAY_SIZEOF(expected), expected, NULL) ==
+			0);
+	assert(mem_equal(out, expected, 79 + 64));
+
+	// The address continues after hex_dumper_final.
+	size_t written = 0;
+	assert(hex_dumper_update(&dumper, 1, input, 0, NULL, NULL) == 0);
+	assert(hex_dumper_final(&dumper, ARRAY_SIZEOF(out), out, &written) ==
+			0);
+	uint64_t address = 17;
+	assert(hex_dump(1, input, ARRAY_SIZEOF(expected), expected,
+			       &address) == 0);
+	assert(written == 64);
+	assert(mem_equal(out, expected, written));
+
+	// The address can't overflow.
+	hex_dumper_init(&dumper, UINT64_MAX - 4);
+	assert(hex_dumper_update(&dumper, 4, input, 0, NULL, NULL) == 0);
+	assert(hex_dumper_update(&dumper, 2, input, 0, NULL, NULL) ==
+			ENCODING_INVALID_ARGUMENT);
+
+	struct hex_dump_format invalid = hex_dump_format_canonical;
+	invalid.group_size             = 0;
+	assert(hex_dumper_init_formatted(&dumper, 0, &invalid) ==
+			ENCODING_INVALID_ARGUMENT);
+
+	// Edge cases
+
+	written = 1;
+	assert(hex_dumper_update(&dumper, 0, NULL, 0, NULL, &written) == 0);
+	assert(written == 0);
+	hex_dumper_init(&dumper, 0);
+	written = 1;
+	assert(hex_dumper_final(&dumper, 0, NULL, &written) == 0);
+	assert(written == 0);
+}
@@ -23,6 +23,33 @@ main()
 	assert(hex_encode(16, bytes, 99, out) == 0);
 	assert(out[2] == '5' && out[3] == 'f');
 
+	// Every byte.
+	uint8_t all[256];
+	for (size_t i = 0; i < ARRAY_SIZEOF(all); i += 1) {
+		all[i] = (uint8_t)i;
+	}
+
+	const uint8_t digits[] = "0123456789abcdef";
+	assert(hex_encode(ARRAY_SIZEOF(all), all, ARRAY_SIZEOF(out), out) ==
+			0);
+	for (size_t i = 0; i < ARRAY_SIZEOF(all); i += 1) {
+		assert(out[i * 2] == digits[i >> 4]);
+		assert(out[i * 2 + 1] == digits[i & 0x0f]);
+	}
+
+	// Every length, so that every mix of the SIMD and scalar encoders is
+	// used.
+	for (size_t len = 0; len <= ARRAY_SIZEOF(all); len += 1) {
+		mem_set(out, 0, len * 2 + 2);
+		assert(hex_encode(len, all, ARRAY_SIZEOF(out), out) == 0);
+		for (size_t i = 0; i < len; i += 1) {
+			assert(out[i * 2] == digits[i >> 4]);
+			assert(out[i * 2 + 1] == digits[i & 0x0f]);
+		}
+
+		assert(out[len * 2] == 0 && out[len * 2 + 1] == 0);
+	}
+
 	// Edge cases
 	assert(hex_encode(0, bytes, ARRAY_SIZEOF(out), out) == 0);
 	assert(hex_encode(1, bytes, 0, NULL) == ENCODING_BUFFER_TOO_SMALL);
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../../hex/hex.h"
+#include "common.h"
+
+int
+main()
+{
+	uint8_t input[300];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	// Every length, so that every mix of the SIMD and scalar encoders is
+	// used, gives the same result as hex_encode with the letters in
+	// uppercase.
+	uint8_t lower[600];
+	uint8_t upper[600];
+	for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+		assert(hex_encode(len, input, ARRAY_SIZEOF(lower), lower) ==
+				0);
+		mem_set(upper, 0, ARRAY_SIZEOF(upper));
+		assert(hex_encode_upper(len, input, ARRAY_SIZEOF(upper),
+				       upper) == 0);
+		for (size_t i = 0; i < len * 2; i += 1) {
+			if (lower[i] >= 0x61) {
+				assert(upper[i] == lower[i] - 0x20);
+			} else {
+				assert(upper[i] == lower[i]);
+			}
+		}
+
+		for (size_t i = len * 2; i < ARRAY_SIZEOF(upper); i += 1) {
+			assert(upper[i] == 0);
+		}
+	}
+
+	// Every byte.
+	uint8_t all[256];
+	for (size_t i = 0; i < ARRAY_SIZEOF(all); i += 1) {
+		all[i] = (uint8_t)i;
+	}
+
+	const uint8_t digits[] = "0123456789ABCDEF";
+	assert(hex_encode_upper(ARRAY_SIZEOF(all), all, ARRAY_SIZEOF(lower),
+			       lower) == 0);
+	for (size_t i = 0; i < ARRAY_SIZEOF(all); i += 1) {
+		assert(lower[i * 2] == digits[i >> 4]);
+		assert(lower[i * 2 + 1] == digits[i & 0x0f]);
+	}
+
+	// Edge cases
+	assert(hex_encode_upper(0, NULL, 0, NULL) == 0);
+	assert(hex_encode_upper(1, input, 0, NULL) ==
+			ENCODING_BUFFER_TOO_SMALL);
+	assert(hex_encode_upper(16, input, 31, upper) ==
+			ENCODING_BUFFER_TOO_SMALL);
+}
@@ -0,0 +1,291 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "../../hex/hex.h"
+#include "common.h"
+
+// Parses expected_len bytes out of str using format, checking the result
+// against expected.
+static void
+check_undump(const char* str, const struct hex_dump_format* format,
+		const size_t expected_len, const uint8_t* expected)
+{
+	static uint8_t out[1000];
+
+	const size_t str_len = strlen(str);
+	assert(hex_undump_formatted_length(str_len, (const uint8_t*)str, 0,
+			       format) == expected_len);
+
+	size_t written = 0;
+	mem_set(out, 0xaa, ARRAY_SIZEOF(out));
+	assert(hex_undump_formatted(str_len, (const uint8_t*)str,
+			       expected_len, out, NULL, format,
+			       &written) == 0);
+	assert(written == expected_len);
+	assert(mem_equal(out, expected, expected_len));
+	assert(out[expected_len] == 0xaa);
+}
+
+int
+main()
+{
+	// "*.obj\n*.exe\nTODO\n.build*\n.cac"
+	const uint8_t sample[] = {0x2a, 0x2e, 0x6f, 0x62, 0x6a, 0x0a, 0x2a,
+			0x2e, 0x65, 0x78, 0x65, 0x0a, 0x54, 0x4f, 0x44, 0x4f,
+			0x0a, 0x2e, 0x62, 0x75, 0x69, 0x6c, 0x64, 0x2a, 0x0a,
+			0x2e, 0x63, 0x61, 0x63};
+
+	// The output of xxd, od -An -tx1, xxd -i and hexdump -C for sample.
+	check_undump("00000000: 2a2e 6f62 6a0a 2a2e 6578 650a 544f 444f  "
+		     "*.obj.*.exe.TODO\n"
+		     "00000010: 0a2e 6275 696c 642a 0a2e 6361 63         "
+		     "..build*..cac\n",
+			&hex_dump_format_xxd, ARRAY_SIZEOF(sample), sample);
+	check_undump(" 2a 2e 6f 62 6a 0a 2a 2e 65 78 65 0a 54 4f 44 4f\n"
+		     " 0a 2e 62 75 69 6c 64 2a 0a 2e 63 61 63\n",
+			&hex_dump_format_od, ARRAY_SIZEOF(sample), sample);
+	check_undump("  0x2a, 0x2e, 0x6f, 0x62, 0x6a, 0x0a, 0x2a, 0x2e, "
+		     "0x65, 0x78, 0x65, 0x0a,\n"
+		     "  0x54, 0x4f, 0x44, 0x4f, 0x0a, 0x2e, 0x62, 0x75, "
+		     "0x69, 0x6c, 0x64, 0x2a,\n"
+		     "  0x0a, 0x2e, 0x63, 0x61, 0x63,\n",
+			&hex_dump_format_c_array, ARRAY_SIZEOF(sample),
+			sample);
+	check_undump("00000000  2a 2e 6f 62 6a 0a 2a 2e  65 78 65 0a 54 4f "
+		     "44 4F  |*.obj.*.exe.TODO|\n"
+		     "00000010  0a 2e 62 75 69 6c 64 2a  0a 2e 63 61 63    "
+		     "       |..build*..cac|\n"
+		     "0000001d\n",
+			&hex_dump_format_canonical, ARRAY_SIZEOF(sample),
+			sample);
+
+	// The last line suffix can be left out.
+	check_undump(" 2a 2e 6f", &hex_dump_format_od, 3, sample);
+
+	// Repeated lines are left out by hexdump -C, and the last line holds
+	// the address following the data.
+	uint8_t squeezed[0x45];
+	mem_set(squeezed, 0, 0x30);
+	for (size_t i = 0; i < 5; i += 1) {
+		squeezed[0x30 + i] = (uint8_t)(0x41 + i);
+	}
+
+	check_undump("00000000  00 00 00 00 00 00 00 00  00 00 00 00 00 00 "
+		     "00 00  |................|\n"
+		     "*\n"
+		     "00000030  41 42 43 44 45                              "
+		     "      |ABCDE|\n"
+		     "00000035\n",
+			&hex_dump_format_canonical, 0x35, squeezed);
+
+	for (size_t i = 0x30; i < 0x40; i += 1) {
+		squeezed[i] = (uint8_t)i;
+	}
+
+	mem_set(&squeezed[0x40], 0, 5);
+	check_undump("00000000  00 00 00 00 00 00 00 00  00 00 00 00 00 00 "
+		     "00 00  |................|\n"
+		     "*\n"
+		     "00000030  30 31 32 33 34 35 36 37  38 39 3a 3b 3c 3d "
+		     "3e 3f  |0123456789:;<=>?|\n"
+		     "00000045\n",
+			&hex_dump_format_canonical, 0x45, squeezed);
+
+	// Sparse and seeked dumps are filled with zeroes.
+	uint8_t sparse[0x23];
+	mem_set(sparse, 0, ARRAY_SIZEOF(sparse));
+	sparse[0x10] = 0xff;
+	sparse[0x20] = 0x01;
+	sparse[0x21] = 0x02;
+	sparse[0x22] = 0x03;
+	check_undump("00000020: 0102 03                                  "
+		     "...\n"
+		     "00000010: ff                                       "
+		     ".\n",
+			&hex_dump_format_xxd, ARRAY_SIZEOF(sparse), sparse);
+
+	// Every preset and some custom formats, for every length, starting at
+	// every address and dumped in pieces.
+	const struct hex_dump_format wide = {32, 4, 16, true, true, "> ",
+			NULL, NULL, NULL, " ", " | ", "[", "]", "\r\n"};
+	const struct hex_dump_format single = {1, 1, 4, false, false, NULL,
+			":", "\\x", NULL, NULL, NULL, NULL, NULL, ";"};
+	const struct hex_dump_format widest = {HEX_DUMP_MAX_BYTES_PER_ROW, 3,
+			0, true, false, "", " ", "", "", "", "", "", "", "\n"};
+	// Without an ASCII column, a short line ends in the group separator,
+	// which follows an empty byte separator.
+	const struct hex_dump_format grouped = {16, 4, 0, false, false, "",
+			"", "", "", "", " ", "", "", "\n"};
+	const struct hex_dump_format grouped_address = {16, 4, 8, false,
+			false, "", ": ", "", "", "", " ", "", "", "\n"};
+	const struct hex_dump_format* formats[] = {&hex_dump_format_canonical,
+			&hex_dump_format_xxd, &hex_dump_format_od,
+			&hex_dump_format_c_array, &wide, &single, &widest,
+			&grouped, &grouped_address};
+
+	static uint8_t input[300];
+	for (size_t i = 0; i < ARRAY_SIZEOF(input); i += 1) {
+		input[i] = (uint8_t)(i * 37 + 11);
+	}
+
+	static uint8_t dump[100000];
+	static uint8_t out[1000];
+	for (size_t f = 0; f < ARRAY_SIZEOF(formats); f += 1) {
+		const struct hex_dump_format* format = formats[f];
+		for (size_t len = 0; len <= ARRAY_SIZEOF(input); len += 1) {
+			// Pieces of up to 37 bytes, to get shorter lines in
+			// the middle of the dump.
+			const size_t piece   = len % 37 + 1;
+			size_t       j       = 0;
+			uint64_t     address = 0x1000;
+			for (size_t i = 0; i < len; i += piece) {
+				const size_t n = len - i < piece ? len - i
+								 : piece;
+				const size_t n_len = hex_dump_formatted_length(
+						n, format);
+				assert(hex_dump_formatted(n, &input[i], n_len,
+						       &dump[j], &address,
+						       format) == 0);
+				j += n_len;
+			}
+
+			uint64_t offset = 0x1000;
+			assert(hex_undump_formatted_length(j, dump, offset,
+					       format) == len);
+
+			size_t written = 0;
+			mem_set(out, 0xaa, len + 1);
+			int err = hex_undump_formatted(j, dump, len, out,
+					&offset, format, &written);
+			assert(err == 0);
+			assert(written == len);
+			assert(mem_equal(out, input, len));
+			assert(out[len] == 0xaa);
+			assert(offset == 0x1000 + len);
+
+			if (format->address_width == 0 || len == 0) {
+				continue;
+			}
+
+			// Seeked, so the start is padded.
+			offset = 0x1000 - 7;
+			assert(hex_undump_formatted_length(j, dump, offset,
+					       format) == len + 7);
+			err = hex_undump_formatted(j, dump, len + 7, out,
+					&offset, format, &written);
+			assert(err == 0);
+			assert(written == len + 7);
+			for (size_t i = 0; i < 7; i += 1) {
+				assert(out[i] == 0);
+			}
+
+			assert(mem_equal(&out[7], input, len));
+			assert(offset == 0x1000 + len);
+
+			offset = 0x1000 - 7;
+			err    = hex_undump_formatted(j, dump, len + 6, out,
+					   &offset, format, &written);
+			assert(err == ENCODING_BUFFER_TOO_SMALL);
+
+			// Addresses before the start of out can't be written.
+			offset = 0x1001;
+			err    = hex_undump_formatted(j, dump, len, out,
+					   &offset, format, &written);
+			assert(err == ENCODING_INVALID_ARGUMENT);
+			assert(offset == 0x1001);
+		}
+	}
+
+	// Changing any character of a dump other than in the ASCII column
+	// makes it invalid.
+	static uint8_t large[4096];
+	for (size_t i = 0; i < ARRAY_SIZEOF(large); i += 1) {
+		large[i] = (uint8_t)(i * 7 + i / 256);
+	}
+
+	const size_t large_len = hex_dump_length(ARRAY_SIZEOF(large));
+	assert(large_len <= ARRAY_SIZEOF(dump));
+	assert(hex_dump(ARRAY_SIZEOF(large), large, large_len, dump, NULL) ==
+			0);
+
+	static uint8_t large_out[ARRAY_SIZEOF(large)];
+	size_t         written = 0;
+	assert(hex_undump_length(large_len, dump, 0) == ARRAY_SIZEOF(large));
+	assert(hex_undump(large_len, dump, ARRAY_SIZEOF(large_out), large_out,
+			       NULL, &written) == 0);
+	assert(written == ARRAY_SIZEOF(large));
+	assert(mem_equal(large_out, large, ARRAY_SIZEOF(large)));
+
+	for (size_t i = 0; i < 79 * 20; i += 1) {
+		const uint8_t c = dump[i];
+		dump[i]         = 0x78; // 'x'
+
+		const size_t column = i % 79;
+		const int    err    = hex_undump(large_len, dump,
+				       ARRAY_SIZEOF(large_out), large_out,
+				       NULL, &written);
+		if (column > 60 && column < 77) {
+			assert(err == 0);
+		} else {
+			assert(err == ENCODING_INVALID_ARGUMENT);
+		}
+
+		dump[i] = c;
+	}
+
+	// Invalid dumps
+
+	const char* invalid[] = {
+			// '*' without a line before it to repeat.
+			"*\n00000010\n",
+			// '*' without the address following it.
+			"00000000  00 00 00 00 00 00 00 00  00 00 00 00 00 00 "
+			"00 00  |................|\n*\n",
+			"00000000  00 00\n",
+			"0000000  00 |.|\n",
+			"00000000  00                                         "
+			"      |.|\n",
+			"00000000  0g                                         "
+			"     |.|\n",
+			"\n",
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZEOF(invalid); i += 1) {
+		const size_t len = strlen(invalid[i]);
+		assert(hex_undump(len, (const uint8_t*)invalid[i],
+				       ARRAY_SIZEOF(out), out, NULL,
+				       NULL) == ENCODING_INVALID_ARGUMENT);
+	}
+
+	struct hex_dump_format invalid_format = hex_dump_format_canonical;
+	invalid_format.group_size             = 0;
+	assert(hex_undump_formatted(1, dump, ARRAY_SIZEOF(out), out, NULL,
+			       &invalid_format,
+			       NULL) == ENCODING_INVALID_ARGUMENT);
+
+	// Edge cases
+
+	written = 1;
+	assert(hex_undump(0, NULL, 0, NULL, NULL, &written) == 0);
+	assert(written == 0);
+	assert(hex_undump_length(0, NULL, 0) == 0);
+
+	// The address following the data has to fit.
+	const struct hex_dump_format full = {1, 1, 16, false, false, NULL,
+			" ", NULL, NULL, NULL, NULL, NULL, NULL, "\n"};
+	const char* end = "fffffffffffffffe 00\nffffffffffffffff 00\n";
+
+	uint64_t offset = UINT64_MAX - 1;
+	assert(hex_undump_formatted(20, (const uint8_t*)end,
+			       ARRAY_SIZEOF(out), out, &offset, &full,
+			       NULL) == 0);
+	assert(offset == UINT64_MAX);
+	offset = UINT64_MAX - 1;
+	assert(hex_undump_formatted(strlen(end), (const uint8_t*)end,
+			       ARRAY_SIZEOF(out), out, &offset, &full,
+			       NULL) == ENCODING_INVALID_ARGUMENT);
+}
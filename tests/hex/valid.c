@@ -27,4 +27,20 @@ main()
 	// Edge cases.
 	assert(hex_valid(0, bytes));
 	assert(!hex_valid(1, NULL));
+
+	// Try every byte in every position, covering both the part of the
+	// input checked 8 characters at a time and the part after it.
+	for (size_t i = 0; i < ARRAY_SIZEOF(bytes); i += 1) {
+		for (size_t c = 0; c < 256; c += 1) {
+			const bool expected = (c >= 0x30 && c <= 0x39) ||
+					      (c >= 0x41 && c <= 0x46) ||
+					      (c >= 0x61 && c <= 0x66);
+
+			const uint8_t old = bytes[i];
+			bytes[i]          = (uint8_t)c;
+			assert(hex_valid(ARRAY_SIZEOF(bytes), bytes) ==
+					expected);
+			bytes[i] = old;
+		}
+	}
 }
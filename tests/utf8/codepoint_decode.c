@@ -127,4 +127,62 @@ main()
 	assert(utf8_codepoint_decode(1, NULL, &size) ==
 			ENCODING_CODEPOINT_ERROR);
 	assert(size == 3);
+
+	// Test that the last ASCII character decodes, and that surrogates and
+	// overlong encodings don't.
+
+	const uint8_t del[] = "\x7f";
+	assert(utf8_codepoint_decode(ARRAY_SIZEOF(del) - 1, del, &size) ==
+			0x7f);
+	assert(size == 1);
+
+	const uint8_t surrogate[] = "\xed\xa0\x80";
+	assert(utf8_codepoint_decode(ARRAY_SIZEOF(surrogate) - 1, surrogate,
+			       &size) == ENCODING_CODEPOINT_ERROR);
+	assert(size == 3);
+
+	const uint8_t overlong[] = "\xe0\x80\xaf";
+	assert(utf8_codepoint_decode(ARRAY_SIZEOF(overlong) - 1, overlong,
+			       &size) == ENCODING_CODEPOINT_ERROR);
+	assert(size == 3);
+
+	const uint8_t too_large[] = "\xf4\x90\x80\x80";
+	assert(utf8_codepoint_decode(ARRAY_SIZEOF(too_large) - 1, too_large,
+			       &size) == ENCODING_CODEPOINT_ERROR);
+	assert(size == 3);
+
+	// The edges of each range in Table 3-7 are decoded, and the
+	// codepoints just past them are rejected.
+	const uint8_t* accepted[] = {
+			(const uint8_t*)"\xc2\x80",         // U+0080
+			(const uint8_t*)"\xed\x9f\xbf",     // U+D7FF
+			(const uint8_t*)"\xee\x80\x80",     // U+E000
+			(const uint8_t*)"\xf4\x8f\xbf\xbf", // U+10FFFF
+	};
+	const size_t   accepted_lens[] = {2, 3, 3, 4};
+	const uint32_t accepted_cps[]  = {0x80, 0xd7ff, 0xe000, 0x10ffff};
+	for (size_t i = 0; i < ARRAY_SIZEOF(accepted); i += 1) {
+		assert(utf8_codepoint_decode(accepted_lens[i], accepted[i],
+				       &size) == accepted_cps[i]);
+		assert(size == accepted_lens[i]);
+	}
+
+	const uint8_t* rejected[] = {
+			(const uint8_t*)"\xc1\xbf",         // Overlong U+007F
+			(const uint8_t*)"\xe0\x9f\xbf",     // Overlong U+07FF
+			(const uint8_t*)"\xed\xbf\xbf",     // U+DFFF
+			(const uint8_t*)"\xf0\x8f\xbf\xbf", // Overlong U+FFFF
+	};
+	const size_t rejected_lens[] = {2, 3, 3, 4};
+	for (size_t i = 0; i < ARRAY_SIZEOF(rejected); i += 1) {
+		assert(utf8_codepoint_decode(rejected_lens[i], rejected[i],
+				       &size) == ENCODING_CODEPOINT_ERROR);
+		assert(size == 3);
+	}
+
+	// Only the first character is decoded.
+	const uint8_t pair[] = "\xc2\xb6\xc2\xb6";
+	assert(utf8_codepoint_decode(ARRAY_SIZEOF(pair) - 1, pair, &size) ==
+			pilcrow_cp);
+	assert(size == 2);
 }
@@ -7,6 +7,173 @@
 #include "../../utf8/utf8.h"
 #include "common.h"
 
+// Returns the length of the character at the start of str according to
+// Table 3-7, 0 if the first byte isn't part of one, or str_len + 1 if str is
+// the start of a character which was truncated.
+static size_t
+reference_char_len(const size_t str_len, const uint8_t* str)
+{
+	const uint8_t b = str[0];
+
+	size_t  len = 0;
+	uint8_t lo  = 0x80;
+	uint8_t hi  = 0xbf;
+	if (b <= 0x7f) {
+		return 1;
+	} else if (b >= 0xc2 && b <= 0xdf) {
+		len = 2;
+	} else if (b >= 0xe0 && b <= 0xef) {
+		len = 3;
+		lo  = b == 0xe0 ? 0xa0 : lo;
+		hi  = b == 0xed ? 0x9f : hi;
+	} else if (b >= 0xf0 && b <= 0xf4) {
+		len = 4;
+		lo  = b == 0xf0 ? 0x90 : lo;
+		hi  = b == 0xf4 ? 0x8f : hi;
+	} else {
+		return 0;
+	}
+
+	for (size_t k = 1; k < len; k += 1) {
+		if (k >= str_len) {
+			return str_len + 1;
+		}
+
+		if (str[k] < lo || str[k] > hi) {
+			return 0;
+		}
+
+		lo = 0x80;
+		hi = 0xbf;
+	}
+
+	return len;
+}
+
+// Decodes str into out one character at a time, as a reference. Returns the
+// number of codepoints written. If the last character was truncated,
+// *truncated is set to true and each of its bytes is counted as a codepoint.
+static int
+reference_decode(const size_t str_len, const uint8_t* str, uint32_t* out,
+		bool* truncated)
+{
+	*truncated = false;
+
+	int    j = 0;
+	size_t i = 0;
+	while (i < str_len) {
+		const size_t len = reference_char_len(str_len - i, &str[i]);
+		if (len > str_len - i) {
+			*truncated = true;
+			return j + (int)(str_len - i);
+		}
+
+		if (len == 0) {
+			out[j] = ENCODING_CODEPOINT_ERROR;
+			j += 1;
+			i += 1;
+			continue;
+		}
+
+		uint32_t cp = len == 1 ? str[i] : str[i] & (0x7f >> len);
+		for (size_t k = 1; k < len; k += 1) {
+			cp = cp << 6 | (str[i + k] & 0x3f);
+		}
+
+		out[j] = cp;
+		j += 1;
+		i += len;
+	}
+
+	return j;
+}
+
+// Decodes seq surrounded by text, starting at different offsets so that it
+// falls at different places in the 8 byte chunks utf8_decode reads, and on
+// its own so that it may be truncated. Compares the results with
+// reference_decode.
+static void
+check_decode(const size_t seq_len, const uint8_t* seq)
+{
+	uint8_t  buf[32];
+	uint32_t expected[32];
+	uint32_t out[32];
+
+	// "abcdefg", seq, then "é" and "abcdefgh".
+	size_t len = 0;
+	for (size_t k = 0; k < 7; k += 1) {
+		buf[len] = (uint8_t)(0x61 + k);
+		len += 1;
+	}
+
+	for (size_t k = 0; k < seq_len; k += 1) {
+		buf[len] = seq[k];
+		len += 1;
+	}
+
+	buf[len]     = 0xc3;
+	buf[len + 1] = 0xa9;
+	len += 2;
+	for (size_t k = 0; k < 8; k += 1) {
+		buf[len] = (uint8_t)(0x61 + k);
+		len += 1;
+	}
+
+	const uint8_t* strs[]     = {buf, &buf[3], &buf[6], &buf[7]};
+	const size_t   str_lens[] = {len, len - 3, len - 6, seq_len};
+	for (size_t k = 0; k < ARRAY_SIZEOF(strs); k += 1) {
+		bool      truncated;
+		const int n = reference_decode(
+				str_lens[k], strs[k], expected, &truncated);
+		const int result = utf8_decode(
+				str_lens[k], strs[k], ARRAY_SIZEOF(out), out);
+		assert(utf8_decoded_length(str_lens[k], strs[k]) == (size_t)n);
+		if (truncated) {
+			assert(result == ENCODING_INVALID_ARGUMENT);
+			assert(out[0] == 0);
+			continue;
+		}
+
+		assert(result == 0);
+		for (int m = 0; m < n; m += 1) {
+			assert(out[m] == expected[m]);
+		}
+
+		// One codepoint too few.
+		assert(utf8_decode(str_lens[k], strs[k], (size_t)n - 1, out) ==
+				ENCODING_BUFFER_TOO_SMALL);
+	}
+}
+
+// Decodes a long str, so that the SIMD implementations are used, and
+// compares the results with reference_decode, as well as checking that one
+// codepoint too few is an error.
+static void
+check_long_decode(const size_t str_len, const uint8_t* str)
+{
+	static uint32_t expected[12000];
+	static uint32_t out[12000];
+
+	bool      truncated;
+	const int n = reference_decode(str_len, str, expected, &truncated);
+	const int result = utf8_decode(str_len, str, ARRAY_SIZEOF(out), out);
+	assert(utf8_decoded_length(str_len, str) == (size_t)n);
+	if (truncated) {
+		assert(result == ENCODING_INVALID_ARGUMENT);
+		assert(out[0] == 0);
+		return;
+	}
+
+	assert(result == 0);
+	for (int m = 0; m < n; m += 1) {
+		assert(out[m] == expected[m]);
+	}
+
+	assert(utf8_decode(str_len, str, (size_t)n - 1, out) ==
+			ENCODING_BUFFER_TOO_SMALL);
+	assert(n == 1 || out[0] == 0);
+}
+
 int
 main()
 {
@@ -69,4 +236,143 @@ main()
 	assert(utf8_decode(ARRAY_SIZEOF(valid) - 2, valid, ARRAY_SIZEOF(buf),
 			       buf) == ENCODING_INVALID_ARGUMENT);
 	assert(buf[0] == 0);
+
+	// Test that each byte which isn't part of a character is decoded as
+	// its own U+FFFD, and that utf8_decoded_length agrees with the number
+	// of codepoints written.
+
+	const uint8_t  mixed[] = "\xe2\x80\x61\xed\xa0\x80\xc0\xaf\x7f";
+	const uint32_t mixed_decoded[] = {
+			// Truncated 3 byte character.
+			ENCODING_CODEPOINT_ERROR,
+			ENCODING_CODEPOINT_ERROR,
+			0x0061,
+			// Surrogate (U+D800).
+			ENCODING_CODEPOINT_ERROR,
+			ENCODING_CODEPOINT_ERROR,
+			ENCODING_CODEPOINT_ERROR,
+			// Overlong '/'.
+			ENCODING_CODEPOINT_ERROR,
+			ENCODING_CODEPOINT_ERROR,
+			0x007f,
+	};
+
+	uint32_t mixed_buf[ARRAY_SIZEOF(mixed_decoded)];
+	assert(utf8_decoded_length(sizeof(mixed) - 1, mixed) ==
+			ARRAY_SIZEOF(mixed_decoded));
+	assert(utf8_decode(sizeof(mixed) - 1, mixed, ARRAY_SIZEOF(mixed_buf),
+			       mixed_buf) == 0);
+	for (size_t i = 0; i < ARRAY_SIZEOF(mixed_decoded); i += 1) {
+		assert(mixed_buf[i] == mixed_decoded[i]);
+	}
+
+	// An invalid or truncated character doesn't swallow the bytes after
+	// it. Each of its bytes is replaced on its own, and decoding carries
+	// on from the next byte.
+
+	const uint8_t  swallowed[] = "\xe2\x28\xa1\xf0\x9f\x98\x41";
+	const uint32_t swallowed_decoded[] = {
+			// 3 byte lead byte followed by '('.
+			ENCODING_CODEPOINT_ERROR,
+			0x0028,
+			// Continuation byte on its own.
+			ENCODING_CODEPOINT_ERROR,
+			// Truncated 4 byte character followed by 'A'.
+			ENCODING_CODEPOINT_ERROR,
+			ENCODING_CODEPOINT_ERROR,
+			ENCODING_CODEPOINT_ERROR,
+			0x0041,
+	};
+
+	uint32_t swallowed_buf[ARRAY_SIZEOF(swallowed_decoded)];
+	assert(utf8_decoded_length(sizeof(swallowed) - 1, swallowed) ==
+			ARRAY_SIZEOF(swallowed_decoded));
+	assert(utf8_decode(sizeof(swallowed) - 1, swallowed,
+			       ARRAY_SIZEOF(swallowed_buf),
+			       swallowed_buf) == 0);
+	for (size_t i = 0; i < ARRAY_SIZEOF(swallowed_decoded); i += 1) {
+		assert(swallowed_buf[i] == swallowed_decoded[i]);
+	}
+
+	// Compare every 1 and 2 byte sequence, and 3 and 4 byte sequences
+	// of bytes at the edges of the ranges in Table 3-7, with the
+	// reference.
+	static const uint8_t bytes[] = {0x00, 0x7f, 0x80, 0x8f, 0x90, 0x9f,
+			0xa0, 0xbf, 0xc0, 0xc2, 0xdf, 0xe0, 0xe1, 0xed, 0xef,
+			0xf0, 0xf3, 0xf4, 0xf5, 0xff};
+
+	uint8_t seq[4];
+	for (size_t a = 0; a < 256; a += 1) {
+		seq[0] = (uint8_t)a;
+		check_decode(1, seq);
+		for (size_t b = 0; b < 256; b += 1) {
+			seq[1] = (uint8_t)b;
+			check_decode(2, seq);
+		}
+	}
+
+	for (size_t a = 0; a < ARRAY_SIZEOF(bytes); a += 1) {
+		for (size_t b = 0; b < ARRAY_SIZEOF(bytes); b += 1) {
+			for (size_t c = 0; c < ARRAY_SIZEOF(bytes); c += 1) {
+				seq[0] = bytes[a];
+				seq[1] = bytes[b];
+				seq[2] = bytes[c];
+				check_decode(3, seq);
+				for (size_t d = 0; d < ARRAY_SIZEOF(bytes);
+						d += 1) {
+					seq[3] = bytes[d];
+					check_decode(4, seq);
+				}
+			}
+		}
+	}
+
+	// Test long strings, going back and forth between runs of each size
+	// of character, then ASCII with the occasional "é".
+
+	static const char* const chars[] = {"a", "\xc2\xb6", "\xe2\x80\xb1",
+			"\xf0\x9f\x98\x80", "b", "\xe4\xb8\xad", "\xd0\xaf"};
+
+	static uint8_t long_buf[12000];
+	size_t         len = 0;
+	for (size_t i = 0; len + 4 <= ARRAY_SIZEOF(long_buf) / 2; i += 1) {
+		// Runs of 5 of each character.
+		const char* c = chars[(i / 5) % ARRAY_SIZEOF(chars)];
+		for (; *c != '\0'; c += 1) {
+			long_buf[len] = (uint8_t)*c;
+			len += 1;
+		}
+	}
+
+	for (size_t i = 0; len + 2 <= ARRAY_SIZEOF(long_buf); i += 1) {
+		if (i % 40 == 0) {
+			long_buf[len]     = 0xc3;
+			long_buf[len + 1] = 0xa9;
+			len += 2;
+			continue;
+		}
+
+		long_buf[len] = (uint8_t)(0x20 + len % 90);
+		len += 1;
+	}
+
+	check_long_decode(len, long_buf);
+
+	// Cut off at every length around the ends of blocks, and around the
+	// ends of the chunks which are validated at a time.
+	for (size_t i = 1; i < 100; i += 1) {
+		check_long_decode(i, long_buf);
+		check_long_decode(4096 - 50 + i, long_buf);
+		check_long_decode(len - i, long_buf);
+	}
+
+	// Break the string in different places.
+	static const uint8_t bad[] = {
+			0x80, 0xbf, 0xc0, 0xe0, 0xed, 0xf4, 0xff};
+	for (size_t i = 0; i < len; i += 97) {
+		const uint8_t b = long_buf[i];
+		long_buf[i]     = bad[i % ARRAY_SIZEOF(bad)];
+		check_long_decode(len, long_buf);
+		long_buf[i] = b;
+	}
 }
@@ -7,6 +7,52 @@
 #include "../../utf8/utf8.h"
 #include "common.h"
 
+// Counts the codepoints utf8_decode writes for str one character at a time
+// according to Table 3-7, as a reference. Each byte which isn't part of a
+// character counts as a codepoint.
+static size_t
+reference_length(const size_t str_len, const uint8_t* str)
+{
+	size_t result = 0;
+	size_t i      = 0;
+	while (i < str_len) {
+		const uint8_t b = str[i];
+
+		size_t  len = 1;
+		uint8_t lo  = 0x80;
+		uint8_t hi  = 0xbf;
+		if (b >= 0xc2 && b <= 0xdf) {
+			len = 2;
+		} else if (b >= 0xe0 && b <= 0xef) {
+			len = 3;
+			lo  = b == 0xe0 ? 0xa0 : lo;
+			hi  = b == 0xed ? 0x9f : hi;
+		} else if (b >= 0xf0 && b <= 0xf4) {
+			len = 4;
+			lo  = b == 0xf0 ? 0x90 : lo;
+			hi  = b == 0xf4 ? 0x8f : hi;
+		}
+
+		size_t k = 1;
+		for (; k < len && i + k < str_len; k += 1) {
+			if (str[i + k] < lo || str[i + k] > hi) {
+				break;
+			}
+
+			lo = 0x80;
+			hi = 0xbf;
+		}
+
+		// Invalid bytes and truncated characters count one codepoint
+		// for each byte.
+		const bool invalid = b >= 0x80 && (len == 1 || k < len);
+		result += 1;
+		i += invalid ? 1 : len;
+	}
+
+	return result;
+}
+
 int
 main()
 {
@@ -29,4 +75,66 @@ main()
 	//              'to castrate a fowl, a capon' (U+2070E)
 	const uint8_t test2[] = "\x0a\xc2\xb6\xff\xff\xff\xff\xf0\xa0\x9c\x8e";
 	assert(utf8_decoded_length(ARRAY_SIZEOF(test2) - 1, test2) == 7);
+
+	// Test long strings, so that the SIMD implementations are used, and
+	// their counts of characters overflow a byte many times over.
+
+	static const char* const chars[] = {"a", "\xc2\xb6", "\xe2\x80\xb1",
+			"\xf0\xa0\x9c\x8e", "b", "\xe4\xb8\xad"};
+
+	static uint8_t buf[40000];
+	size_t         len   = 0;
+	size_t         count = 0;
+	for (size_t i = 0; len + 4 <= ARRAY_SIZEOF(buf) / 2; i += 1) {
+		// Runs of 7 of each character.
+		const char* c = chars[(i / 7) % ARRAY_SIZEOF(chars)];
+		for (; *c != '\0'; c += 1) {
+			buf[len] = (uint8_t)*c;
+			len += 1;
+		}
+
+		count += 1;
+	}
+
+	// Then ASCII with the occasional "é", which counts as many
+	// characters as possible in each block which isn't ASCII.
+	for (; len + 2 <= ARRAY_SIZEOF(buf); count += 1) {
+		if (count % 40 == 0) {
+			buf[len]     = 0xc3;
+			buf[len + 1] = 0xa9;
+			len += 2;
+			continue;
+		}
+
+		buf[len] = (uint8_t)(0x20 + len % 90);
+		len += 1;
+	}
+
+	assert(utf8_decoded_length(len, buf) == count);
+	assert(reference_length(len, buf) == count);
+
+	// Cut off at every length around the ends of blocks.
+	for (size_t i = 1000; i < 1200; i += 1) {
+		assert(utf8_decoded_length(i, buf) ==
+				reference_length(i, buf));
+	}
+
+	// Break the string in different places.
+	static const uint8_t bad[] = {
+			0x80, 0xbf, 0xc0, 0xe0, 0xed, 0xf4, 0xff};
+	for (size_t i = 0; i < len; i += 331) {
+		const uint8_t b = buf[i];
+		buf[i]          = bad[i % ARRAY_SIZEOF(bad)];
+		assert(utf8_decoded_length(len, buf) ==
+				reference_length(len, buf));
+		buf[i] = b;
+	}
+
+	// Break it in many places at once, so that counting has to go back to
+	// the faster paths after each of them.
+	for (size_t i = 0; i < len; i += 997) {
+		buf[i] = bad[i % ARRAY_SIZEOF(bad)];
+	}
+
+	assert(utf8_decoded_length(len, buf) == reference_length(len, buf));
 }
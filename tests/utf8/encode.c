@@ -7,6 +7,51 @@
 #include "../../utf8/utf8.h"
 #include "common.h"
 
+// Encodes str one codepoint at a time with utf8_codepoint_encode, as a
+// reference. Returns the number of bytes written.
+static size_t
+reference_encode(const size_t str_len, const uint32_t* str, uint8_t* out)
+{
+	size_t j = 0;
+	for (size_t i = 0; i < str_len; i += 1) {
+		j += (size_t)utf8_codepoint_encode(str[i], 4, &out[j]);
+	}
+
+	return j;
+}
+
+// Encodes str with out exactly as large as needed, one byte smaller, and
+// larger, and compares the results with reference_encode.
+static void
+check_encode(const size_t str_len, const uint32_t* str)
+{
+	static uint8_t expected[4 * 6000];
+	static uint8_t out[4 * 6000];
+
+	const size_t n = reference_encode(str_len, str, expected);
+	assert(utf8_encoded_length(str_len, str) == n);
+
+	// Exactly as large as needed, so that writing past the end of out
+	// would be caught by the sanitizers.
+	uint8_t* exact = (uint8_t*)malloc(n);
+	assert(exact != NULL);
+	assert(utf8_encode(str_len, str, n, exact) == (int)n);
+	assert(mem_equal(exact, expected, n));
+	free(exact);
+
+	// Too small, which leaves the whole of out zeroed.
+	mem_set(out, 0xaa, n - 1);
+	assert(utf8_encode(str_len, str, n - 1, out) ==
+			ENCODING_BUFFER_TOO_SMALL);
+	for (size_t i = 0; i < n - 1; i += 1) {
+		assert(out[i] == 0);
+	}
+
+	// With more room than needed.
+	assert(utf8_encode(str_len, str, ARRAY_SIZEOF(out), out) == (int)n);
+	assert(mem_equal(out, expected, n));
+}
+
 int
 main()
 {
@@ -55,4 +100,41 @@ main()
 	assert(utf8_encode(ARRAY_SIZEOF(valid), valid, 1, buf) ==
 			ENCODING_BUFFER_TOO_SMALL);
 	assert(buf[0] == 0);
+
+	// Test long strings, so that the SIMD implementations are used, going
+	// back and forth between runs of codepoints of each size, including
+	// invalid ones.
+
+	static const uint32_t cps[] = {0x61, 0xe9, 0x4e2d, 0x1f600, 0x00,
+			0x7f, 0x80, 0x7ff, 0x800, 0xffff, 0x10000, 0x10ffff,
+			0x110000, 0xd800, 0xffffffff, 0x0a};
+	static const size_t runs[] = {40, 1, 5, 3, 70, 2, 9};
+
+	static uint32_t str[6000];
+	size_t          len = 0;
+	for (size_t i = 0; len < ARRAY_SIZEOF(str); i += 1) {
+		const uint32_t cp  = cps[i % ARRAY_SIZEOF(cps)];
+		const size_t   run = runs[i % ARRAY_SIZEOF(runs)];
+		for (size_t k = 0; k < run && len < ARRAY_SIZEOF(str);
+				k += 1) {
+			str[len] = cp;
+			len += 1;
+		}
+	}
+
+	check_encode(len, str);
+
+	// Cut off at every length around the ends of blocks, and at every
+	// offset.
+	for (size_t i = 1; i < 100; i += 1) {
+		check_encode(i, str);
+		check_encode(len - i, &str[i]);
+	}
+
+	// Only 4 byte characters, which take up as much room as possible.
+	for (size_t i = 0; i < 1000; i += 1) {
+		str[i] = 0x10000 + (uint32_t)i * 97;
+	}
+
+	check_encode(1000, str);
 }
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "../../utf8/utf8.h"
+#include "common.h"
+
+// Encodes str one codepoint at a time with utf8_codepoint_encode, as a
+// reference. Returns the number of bytes written.
+static size_t
+reference_encode(const size_t str_len, const uint32_t* str, uint8_t* out)
+{
+	size_t j = 0;
+	for (size_t i = 0; i < str_len; i += 1) {
+		j += (size_t)utf8_codepoint_encode(str[i], 4, &out[j]);
+	}
+
+	return j;
+}
+
+int
+main()
+{
+	uint8_t buf[16] = {0};
+
+	// Test if we can correctly encode various sized codepoints.
+
+	const uint32_t valid[] = {
+			// \n NEWLINE (U+000A) 1 byte
+			0x000a,
+			// ¶ PILCROW SIGN (U+00B6) 2 bytes
+			0x00b6,
+			// ‱ PER TEN THOUSAND SIGN (U+2031) 3 bytes
+			0x2031,
+			// 𠜎 'to castrate a fowl, a capon' (U+2070E) 4 bytes
+			0x2070e,
+	};
+	const uint8_t valid_encoded[] =
+			"\x0a\xc2\xb6\xe2\x80\xb1\xf0\xa0\x9c\x8e";
+
+	assert(utf8_encode_unchecked(ARRAY_SIZEOF(valid), valid, buf) == 10);
+	assert(mem_equal(buf, valid_encoded, sizeof(valid_encoded) - 1));
+
+	mem_set(buf, 0, sizeof(buf));
+
+	// Test if an invalid codepoint is correctly encoded as the Unicode
+	// Replacement Character (U+FFFD).
+
+	const uint32_t invalid[]         = {0xffffffff};
+	const uint8_t  invalid_encoded[] = "\xef\xbf\xbd";
+
+	assert(utf8_encode_unchecked(1, invalid, buf) == 3);
+	assert(mem_equal(buf, invalid_encoded, sizeof(invalid_encoded) - 1));
+
+	// Test if passing an empty string returns 0 and doesn't write to out
+	// at all.
+
+	assert(utf8_encode_unchecked(0, NULL, NULL) == 0);
+
+	// Test long strings, so that the SIMD implementations are used, and
+	// compare them with reference_encode. out is exactly 4 bytes for each
+	// codepoint, so writing past that would be caught by the sanitizers.
+
+	static const uint32_t cps[] = {0x61, 0x4e2d, 0xe9, 0x7f, 0x1f600,
+			0x800, 0x7ff, 0x110000, 0xffff, 0x80};
+	static const size_t runs[] = {33, 1, 6, 2, 17, 4};
+
+	static uint32_t str[5000];
+	size_t          len = 0;
+	for (size_t i = 0; len < ARRAY_SIZEOF(str); i += 1) {
+		const uint32_t cp  = cps[i % ARRAY_SIZEOF(cps)];
+		const size_t   run = runs[i % ARRAY_SIZEOF(runs)];
+		for (size_t k = 0; k < run && len < ARRAY_SIZEOF(str);
+				k += 1) {
+			str[len] = cp;
+			len += 1;
+		}
+	}
+
+	static uint8_t expected[4 * ARRAY_SIZEOF(str)];
+	for (size_t i = 0; i < 200; i += 1) {
+		const size_t n   = len - i;
+		uint8_t*     out = (uint8_t*)malloc(4 * n);
+		assert(out != NULL);
+
+		const size_t size = reference_encode(n, &str[i], expected);
+		assert(utf8_encode_unchecked(n, &str[i], out) == size);
+		assert(mem_equal(out, expected, size));
+		free(out);
+	}
+
+	// All 4 byte characters, the most out can need.
+	for (size_t i = 0; i < 100; i += 1) {
+		str[i] = 0x10000 + (uint32_t)i;
+	}
+
+	uint8_t* out = (uint8_t*)malloc(4 * 100);
+	assert(out != NULL);
+	assert(utf8_encode_unchecked(100, str, out) == 400);
+	assert(reference_encode(100, str, expected) == 400);
+	assert(mem_equal(out, expected, 400));
+	free(out);
+}
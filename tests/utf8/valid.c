@@ -7,6 +7,90 @@
 #include "../../utf8/utf8.h"
 #include "common.h"
 
+// Checks str against Table 3-7 one character at a time, as a reference.
+static bool
+reference_valid(const size_t str_len, const uint8_t* str)
+{
+	size_t i = 0;
+	while (i < str_len) {
+		const uint8_t b = str[i];
+
+		size_t   len = 0;
+		uint32_t min = 0;
+		uint32_t cp  = 0;
+		if (b <= 0x7f) {
+			i += 1;
+			continue;
+		} else if (b >= 0xc0 && b <= 0xdf) {
+			len = 2;
+			min = 0x80;
+			cp  = b & 0x1f;
+		} else if (b >= 0xe0 && b <= 0xef) {
+			len = 3;
+			min = 0x800;
+			cp  = b & 0x0f;
+		} else if (b >= 0xf0 && b <= 0xf7) {
+			len = 4;
+			min = 0x10000;
+			cp  = b & 0x07;
+		} else {
+			return false;
+		}
+
+		if (str_len - i < len) {
+			return false;
+		}
+
+		for (size_t k = 1; k < len; k += 1) {
+			if ((str[i + k] & 0xc0) != 0x80) {
+				return false;
+			}
+
+			cp = cp << 6 | (str[i + k] & 0x3f);
+		}
+
+		const bool surrogate = cp >= 0xd800 && cp <= 0xdfff;
+		if (cp < min || cp > 0x10ffff || surrogate) {
+			return false;
+		}
+
+		i += len;
+	}
+
+	return true;
+}
+
+// Places seq in the middle of ASCII and multibyte text at offsets around the
+// edges of the 32 and 64 byte blocks the SIMD validators check, comparing
+// the result with reference_valid.
+static void
+check_everywhere(const size_t seq_len, const uint8_t* seq)
+{
+	static const size_t offsets[] = {0, 1, 13, 29, 30, 31, 32, 33, 61, 62,
+			63, 64, 65, 95, 127, 128, 160};
+
+	uint8_t buf[256];
+	for (size_t i = 0; i < ARRAY_SIZEOF(offsets); i += 1) {
+		// "é" followed by ASCII, so that not every block is ASCII.
+		mem_set(buf, 0x61, ARRAY_SIZEOF(buf));
+		buf[0] = 0xc3;
+		buf[1] = 0xa9;
+
+		const size_t offset = offsets[i];
+		for (size_t k = 0; k < seq_len; k += 1) {
+			buf[offset + k] = seq[k];
+		}
+
+		// Both with the sequence at the very end, and followed by
+		// more text.
+		const size_t lens[] = {offset + seq_len, ARRAY_SIZEOF(buf)};
+		for (size_t k = 0; k < ARRAY_SIZEOF(lens); k += 1) {
+			assert(utf8_valid(lens[k], buf) ==
+					reference_valid(lens[k], buf));
+		}
+	}
+}
+
 // Used as a reference for different things that can be encountered in
 // invalid UTF-8:
 // https://www.cl.cam.ac.uk/~mgk25/ucs/examples/UTF-8-test.txt
@@ -192,4 +276,76 @@ main()
 	// Test if utf8_valid returns false when str is NULL.
 
 	assert(!utf8_valid(0, NULL));
+
+	// Every sequence of 2 bytes, and every sequence of 3 or 4 bytes
+	// starting with a lead byte, around the edges of the SIMD blocks.
+	for (size_t a = 0; a < 256; a += 1) {
+		for (size_t b = 0; b < 256; b += 1) {
+			const uint8_t seq[] = {(uint8_t)a, (uint8_t)b};
+			check_everywhere(ARRAY_SIZEOF(seq), seq);
+		}
+	}
+
+	const uint8_t bytes[] = {0x00, 0x7f, 0x80, 0x8f, 0x90, 0x9f, 0xa0,
+			0xbf, 0xc0, 0xc2, 0xdf, 0xe0, 0xed, 0xef, 0xf0, 0xf4,
+			0xf5, 0xff};
+	for (size_t a = 0xe0; a < 256; a += 1) {
+		for (size_t b = 0; b < ARRAY_SIZEOF(bytes); b += 1) {
+			for (size_t c = 0; c < ARRAY_SIZEOF(bytes); c += 1) {
+				const uint8_t seq[] = {
+						(uint8_t)a, bytes[b], bytes[c],
+				};
+				check_everywhere(ARRAY_SIZEOF(seq), seq);
+			}
+		}
+	}
+
+	for (size_t a = 0xf0; a < 256; a += 1) {
+		for (size_t b = 0; b < ARRAY_SIZEOF(bytes); b += 1) {
+			for (size_t c = 0; c < ARRAY_SIZEOF(bytes); c += 1) {
+				const uint8_t seq[] = {(uint8_t)a, bytes[b],
+						bytes[c], 0x80};
+				check_everywhere(ARRAY_SIZEOF(seq), seq);
+			}
+		}
+	}
+
+	// Long strings of every length, which are valid and then have one
+	// byte changed.
+	static const uint8_t characters[] = {0x61, 0xc3, 0xa9, 0xe2, 0x82,
+			0xac, 0xf0, 0x9f, 0x98, 0x80, 0xed, 0x9f, 0xbf, 0xf4,
+			0x8f, 0xbf, 0xbf};
+	static const size_t starts[] = {0, 1, 3, 6, 10, 13};
+	static const size_t widths[] = {1, 2, 3, 4, 3, 4};
+
+	uint8_t text[600];
+	size_t  text_len = 0;
+	for (size_t i = 0; text_len + 4 <= ARRAY_SIZEOF(text); i += 1) {
+		// Mostly ASCII, with runs long enough to skip whole blocks.
+		size_t c = i * 7 % 11;
+		if (c >= ARRAY_SIZEOF(starts) || (i / 40) % 2 == 1) {
+			c = 0;
+		}
+
+		for (size_t k = 0; k < widths[c]; k += 1) {
+			text[text_len] = characters[starts[c] + k];
+			text_len += 1;
+		}
+	}
+
+	for (size_t len = 0; len <= text_len; len += 1) {
+		assert(utf8_valid(len, text) == reference_valid(len, text));
+	}
+
+	assert(utf8_valid(text_len, text));
+	for (size_t i = 0; i < text_len; i += 1) {
+		const uint8_t c = text[i];
+		for (size_t b = 0; b < ARRAY_SIZEOF(bytes); b += 1) {
+			text[i] = bytes[b];
+			assert(utf8_valid(text_len, text) ==
+					reference_valid(text_len, text));
+		}
+
+		text[i] = c;
+	}
 }
@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <stdio.h>
+
+// Prints the shuffle table used to compact 8 bytes, removing the bytes whose
+// bit is set in the index. Unused entries are 0x80, which pshufb turns into
+// zero.
+
+int
+main()
+{
+	for (int mask = 0; mask < 256; mask += 1) {
+		int n = 0;
+
+		printf("{");
+		for (int i = 0; i < 8; i += 1) {
+			if ((mask & (1 << i)) == 0) {
+				printf("%s0x%02x", n == 0 ? "" : ", ", i);
+				n += 1;
+			}
+		}
+
+		for (; n < 8; n += 1) {
+			printf("%s0x80", n == 0 ? "" : ", ");
+		}
+
+		printf("},\n");
+	}
+
+	return 0;
+}
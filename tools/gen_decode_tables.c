@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <stdio.h>
+#include <string.h>
+
+// Prints the decode tables for the base64, base64url, base32 and base32hex
+// alphabets. Bytes which aren't part of the alphabet map to 0xff.
+//
+// The base32crockford table also maps lowercase letters, and 'I', 'L' and 'O'
+// to the values of '1', '1' and '0'. The characters which are only used as
+// check symbols map to their values from 32 to 36, and '-' maps to 0xfe.
+//
+// Also prints the pre-shifted tables used by the scalar base64 decoder, where
+// entry i of table n holds the bits character n of a quantum contributes to
+// the 3 decoded bytes, stored little endian. Bytes which aren't part of the
+// alphabet map to 0x01ffffff.
+
+static const char base64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+			     "abcdefghijklmnopqrstuvwxyz"
+			     "0123456789+/";
+
+static const char base64url[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+				"abcdefghijklmnopqrstuvwxyz"
+				"0123456789-_";
+
+static const char base32[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+
+static const char base32hex[] = "0123456789ABCDEFGHIJKLMNOPQRSTUV";
+
+static const char base32crockford[] = "0123456789ABCDEFGHJKMNPQRSTVWXYZ"
+				      "*~$=U";
+
+static void
+print_table(const char* name, const char* alphabet)
+{
+	int table[256];
+	for (int i = 0; i < 256; i += 1) {
+		table[i] = 0xff;
+	}
+
+	for (int i = 0; i < (int)strlen(alphabet); i += 1) {
+		table[(unsigned char)alphabet[i]] = i;
+	}
+
+	printf("%s:\n", name);
+	for (int i = 0; i < 256; i += 1) {
+		printf("0x%02x,\n", table[i]);
+	}
+}
+
+static void
+print_crockford_table(void)
+{
+	int table[256];
+	for (int i = 0; i < 256; i += 1) {
+		table[i] = 0xff;
+	}
+
+	for (int i = 0; i < (int)strlen(base32crockford); i += 1) {
+		const unsigned char c = (unsigned char)base32crockford[i];
+		table[c]              = i;
+		if (c >= 'A' && c <= 'Z') {
+			table[c - 'A' + 'a'] = i;
+		}
+	}
+
+	table['I'] = 1;
+	table['i'] = 1;
+	table['L'] = 1;
+	table['l'] = 1;
+	table['O'] = 0;
+	table['o'] = 0;
+	table['-'] = 0xfe;
+
+	printf("base32crockford:\n");
+	for (int i = 0; i < 256; i += 1) {
+		printf("0x%02x,\n", table[i]);
+	}
+}
+
+static void
+print_shifted_tables(const char* name, const char* alphabet)
+{
+	unsigned long table[4][256];
+	for (int i = 0; i < 256; i += 1) {
+		for (int n = 0; n < 4; n += 1) {
+			table[n][i] = 0x01ffffff;
+		}
+	}
+
+	for (int i = 0; i < (int)strlen(alphabet); i += 1) {
+		const unsigned char c = (unsigned char)alphabet[i];
+		const unsigned long x = (unsigned long)i;
+		table[0][c]           = x << 2;
+		table[1][c]           = x >> 4 | (x & 0x0f) << 12;
+		table[2][c]           = x >> 2 << 8 | (x & 0x03) << 22;
+		table[3][c]           = x << 16;
+	}
+
+	for (int n = 0; n < 4; n += 1) {
+		printf("%s shifted %d:\n", name, n);
+		for (int i = 0; i < 256; i += 1) {
+			printf("0x%08lx,\n", table[n][i]);
+		}
+	}
+}
+
+int
+main()
+{
+	print_table("base64", base64);
+	print_table("base64url", base64url);
+	print_table("base32", base32);
+	print_table("base32hex", base32hex);
+	print_crockford_table();
+	print_shifted_tables("base64", base64);
+	print_shifted_tables("base64url", base64url);
+	return 0;
+}
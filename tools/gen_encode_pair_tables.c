@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <stdio.h>
+
+// Prints the pair tables used by the scalar base64 and hex encoders.
+//
+// Entry i of a base64 pair table holds the two characters which the 12 bits
+// i encode to, and entry i of a hex pair table holds the two characters
+// which the byte i encodes to. Both are stored with the first character in
+// the low byte.
+
+static const char base64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+			     "abcdefghijklmnopqrstuvwxyz"
+			     "0123456789+/";
+
+static const char base64url[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+				"abcdefghijklmnopqrstuvwxyz"
+				"0123456789-_";
+
+static const char hex[] = "0123456789abcdef";
+
+static const char hex_upper[] = "0123456789ABCDEF";
+
+static void
+print_base64_pairs(const char* name, const char* alphabet)
+{
+	printf("%s:\n", name);
+	for (int i = 0; i < 4096; i += 1) {
+		const unsigned char first  = (unsigned char)alphabet[i >> 6];
+		const unsigned char second = (unsigned char)alphabet[i & 0x3f];
+		printf("0x%02x%02x,\n", second, first);
+	}
+}
+
+static void
+print_hex_pairs(const char* name, const char* digits)
+{
+	printf("%s:\n", name);
+	for (int i = 0; i < 256; i += 1) {
+		const unsigned char first  = (unsigned char)digits[i >> 4];
+		const unsigned char second = (unsigned char)digits[i & 0x0f];
+		printf("0x%02x%02x,\n", second, first);
+	}
+}
+
+int
+main()
+{
+	print_base64_pairs("base64", base64);
+	print_base64_pairs("base64url", base64url);
+	print_hex_pairs("hex", hex);
+	print_hex_pairs("hex_upper", hex_upper);
+	return 0;
+}
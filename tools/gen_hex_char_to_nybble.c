@@ -2,10 +2,13 @@
 // Copyright (C) 2022 Ayman El Didi
 #include <stdio.h>
 
+// Prints the table used by the scalar hex decoder. Entry c holds the value of
+// the hexadecimal character c, or 0xff if c isn't one.
+
 int
 main()
 {
-	for (int i = 0; i < 0x67; i += 1) {
+	for (int i = 0; i < 256; i += 1) {
 		if (i >= 0x30 && i <= 0x39) {
 			printf("%d,\n", i - 0x30);
 			continue;
@@ -21,7 +24,7 @@ main()
 			continue;
 		}
 
-		printf("0,\n");
+		printf("0xff,\n");
 	}
 
 	return 0;
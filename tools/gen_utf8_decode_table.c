@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <stdio.h>
+
+// Prints the shuffle table used by the SIMD UTF-8 decoder. Each index holds
+// the lengths of 4 characters minus one, 2 bits each with the first
+// character's in the lowest bits. Each entry holds the pshufb indices which
+// move the bytes of each character into its own 32-bit lane, last byte
+// first. Unused entries are 0x80, which pshufb turns into zero.
+
+int
+main()
+{
+	for (int index = 0; index < 256; index += 1) {
+		int shuffle[16];
+		int start = 0;
+		for (int lane = 0; lane < 4; lane += 1) {
+			const int len = ((index >> (2 * lane)) & 3) + 1;
+			for (int k = 0; k < 4; k += 1) {
+				shuffle[4 * lane + k] =
+						k < len ? start + len - 1 - k
+							: 0x80;
+			}
+
+			start += len;
+		}
+
+		printf("{");
+		for (int k = 0; k < 16; k += 1) {
+			const char* sep = k == 0 ? "" : ", ";
+			if (k == 10) {
+				sep = ",\n\t\t";
+			}
+
+			printf("%s0x%02x", sep, shuffle[k]);
+		}
+
+		printf("},\n");
+	}
+
+	return 0;
+}
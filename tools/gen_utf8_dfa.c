@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <inttypes.h>
+#include <stdio.h>
+
+// Prints the tables used by the UTF-8 decoder in utf8/utf8.c.
+//
+// The first maps each byte to its character class, and the second maps each
+// byte to the bits it contributes to a codepoint.
+//
+// The third holds one word per class. The decoder's states are multiples
+// of 6, and bits state to state + 5 of a class's word hold the state to move
+// to after reading a byte of that class in that state. Transitions which
+// aren't listed lead to the error state, which is 0 and so never leaves
+// itself.
+
+enum {
+	ERROR  = 0,
+	ACCEPT = 6,
+	TAIL_1 = 12, // One more continuation byte.
+	TAIL_2 = 18, // Two more continuation bytes.
+	TAIL_3 = 24, // Three more continuation bytes.
+	E0     = 30, // After E0: A0..BF, then one more.
+	ED     = 36, // After ED: 80..9F, then one more.
+	F0     = 42, // After F0: 90..BF, then two more.
+	F4     = 48, // After F4: 80..8F, then two more.
+};
+
+static int
+byte_class(const int b)
+{
+	if (b <= 0x7f) {
+		return 0;
+	} else if (b <= 0x8f) {
+		return 1;
+	} else if (b <= 0x9f) {
+		return 9;
+	} else if (b <= 0xbf) {
+		return 7;
+	} else if (b <= 0xc1) {
+		return 8;
+	} else if (b <= 0xdf) {
+		return 2;
+	} else if (b == 0xe0) {
+		return 10;
+	} else if (b == 0xed) {
+		return 4;
+	} else if (b <= 0xef) {
+		return 3;
+	} else if (b == 0xf0) {
+		return 11;
+	} else if (b <= 0xf3) {
+		return 6;
+	} else if (b == 0xf4) {
+		return 5;
+	}
+
+	return 8;
+}
+
+static int
+payload(const int b)
+{
+	if (b <= 0x7f) {
+		return b;
+	} else if (b <= 0xbf) {
+		return b & 0x3f;
+	} else if (b <= 0xdf) {
+		return b & 0x1f;
+	} else if (b <= 0xef) {
+		return b & 0x0f;
+	}
+
+	return b & 0x07;
+}
+
+static uint64_t
+edge(const int from, const int to)
+{
+	return (uint64_t)to << from;
+}
+
+int
+main()
+{
+	for (int i = 0; i < 256; i += 1) {
+		printf("%d,\n", byte_class(i));
+	}
+
+	for (int i = 0; i < 256; i += 1) {
+		printf("%d,\n", payload(i));
+	}
+
+	// Every continuation byte finishes a character or counts down the
+	// continuation bytes left.
+	const uint64_t continuation = edge(TAIL_1, ACCEPT) |
+				      edge(TAIL_2, TAIL_1) |
+				      edge(TAIL_3, TAIL_2);
+
+	const uint64_t transitions[12] = {
+			// 00..7F
+			edge(ACCEPT, ACCEPT),
+			// 80..8F
+			continuation | edge(ED, TAIL_1) | edge(F4, TAIL_2),
+			// C2..DF
+			edge(ACCEPT, TAIL_1),
+			// E1..EC, EE..EF
+			edge(ACCEPT, TAIL_2),
+			// ED
+			edge(ACCEPT, ED),
+			// F4
+			edge(ACCEPT, F4),
+			// F1..F3
+			edge(ACCEPT, TAIL_3),
+			// A0..BF
+			continuation | edge(E0, TAIL_1) | edge(F0, TAIL_2),
+			// C0..C1, F5..FF
+			0,
+			// 90..9F
+			continuation | edge(ED, TAIL_1) | edge(F0, TAIL_2),
+			// E0
+			edge(ACCEPT, E0),
+			// F0
+			edge(ACCEPT, F0),
+	};
+
+	for (int i = 0; i < 12; i += 1) {
+		printf("UINT64_C(0x%016" PRIx64 "),\n", transitions[i]);
+	}
+
+	return 0;
+}
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: 0BSD
+// Copyright (C) 2022 Ayman El Didi
+#include <stdio.h>
+
+// Prints the tables used by the SIMD UTF-8 encoder in utf8/utf8.c.
+//
+// The encoder puts each of 4 codepoints below U+10000 into its own 32-bit
+// lane, with the last byte of its encoding in the lowest byte, the one
+// before it next, and the lead byte of a 3 byte character after that. Bit k
+// of an index is set if codepoint k takes more than 1 byte, and bit k + 4 if
+// it takes more than 2.
+//
+// The first table holds the pshufb indices which move those bytes next to
+// each other in order. Unused entries are 0x80, which pshufb turns into zero.
+// The second holds the number of bytes the 4 codepoints take up.
+
+int
+main()
+{
+	for (int index = 0; index < 256; index += 1) {
+		int shuffle[16];
+		int len = 0;
+		for (int lane = 0; lane < 4; lane += 1) {
+			const int size = 1 + ((index >> lane) & 1) +
+					 ((index >> (lane + 4)) & 1);
+			for (int k = size - 1; k >= 0; k -= 1) {
+				shuffle[len] = 4 * lane + k;
+				len += 1;
+			}
+		}
+
+		for (int k = len; k < 16; k += 1) {
+			shuffle[k] = 0x80;
+		}
+
+		printf("{");
+		for (int k = 0; k < 16; k += 1) {
+			const char* sep = k == 0 ? "" : ", ";
+			if (k == 10) {
+				sep = ",\n\t\t";
+			}
+
+			printf("%s0x%02x", sep, shuffle[k]);
+		}
+
+		printf("},\n");
+	}
+
+	for (int index = 0; index < 256; index += 1) {
+		int len = 4;
+		for (int k = 0; k < 8; k += 1) {
+			len += (index >> k) & 1;
+		}
+
+		printf("%d,\n", len);
+	}
+
+	return 0;
+}
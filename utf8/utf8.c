@@ -16,26 +16,142 @@ extern "C" {
 // characters are encountered.
 static const uint8_t utf8_replacement[] = {0xef, 0xbf, 0xbd};
 
-// The encoded sizes in bytes of UTF-8 codepoints based on their first byte.
-// Generated using tools/gen_utf8_sizes.c
-static const size_t encoded_size_table[] = {
+// The decoder is a shift-based DFA in the style of Bjoern Hoehrmann's and
+// Per Vognsen's. Each byte is first mapped to one of 12 classes, and the
+// state after reading it is (utf8_dfa_transitions[class] >> state) & 63.
+// All of the tables are small enough to stay in the L1 cache.
+//
+// The states are multiples of 6. DFA_ERROR is 0, so any transition missing
+// from a word leads to it and it never leads anywhere else. DFA_ACCEPT is the
+// state between characters, and the states above it are in the middle of
+// one.
+//
+// Generated using tools/gen_utf8_dfa.c
+#define DFA_ERROR  0
+#define DFA_ACCEPT 6
+
+static const uint8_t utf8_dfa_classes[256] = {
 		//
-		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-		1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-		1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-		2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3,
-		3, 3, 3, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 1, 1, 1, 1, 1, 1, 1,
-		1, 1, 1, 1,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 9, 9, 9,
+		9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 7, 7, 7, 7, 7, 7, 7, 7,
+		7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+		7, 7, 7, 8, 8, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+		2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 10, 3, 3, 3, 3, 3, 3,
+		3, 3, 3, 3, 3, 3, 4, 3, 3, 11, 6, 6, 6, 5, 8, 8, 8, 8, 8, 8, 8,
+		8, 8, 8, 8,
 		//
 };
 
+// The bits each byte contributes to the codepoint it's part of.
+static const uint8_t utf8_dfa_payloads[256] = {
+		//
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17,
+		18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33,
+		34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49,
+		50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65,
+		66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81,
+		82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97,
+		98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110,
+		111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122,
+		123, 124, 125, 126, 127, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+		12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27,
+		28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43,
+		44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59,
+		60, 61, 62, 63, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13,
+		14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29,
+		30, 31, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7,
+		//
+};
+
+static const uint64_t utf8_dfa_transitions[12] = {
+		UINT64_C(0x0000000000000180),
+		UINT64_C(0x001200c012306000),
+		UINT64_C(0x0000000000000300),
+		UINT64_C(0x0000000000000480),
+		UINT64_C(0x0000000000000900),
+		UINT64_C(0x0000000000000c00),
+		UINT64_C(0x0000000000000600),
+		UINT64_C(0x0000480312306000),
+		UINT64_C(0x0000000000000000),
+		UINT64_C(0x000048c012306000),
+		UINT64_C(0x0000000000000780),
+		UINT64_C(0x0000000000000a80),
+};
+
+// Returns the state after reading b in state.
+static uint32_t
+dfa_step(const uint32_t state, const uint8_t b)
+{
+	const uint64_t transitions = utf8_dfa_transitions[utf8_dfa_classes[b]];
+	return (uint32_t)(transitions >> state) & 63;
+}
+
+// Like dfa_step, but also accumulates the codepoint being read in *cp.
+static uint32_t
+dfa_decode_step(const uint32_t state, const uint8_t b, uint32_t* cp)
+{
+	// The codepoint is cleared when b starts a character. Which bytes do
+	// is unpredictable in mixed text, so we use a mask rather than a
+	// branch.
+	const uint32_t keep = 0u - (uint32_t)(state != DFA_ACCEPT);
+	*cp                 = ((*cp << 6) & keep) | utf8_dfa_payloads[b];
+
+	return dfa_step(state, b);
+}
+
+// The high bit of each byte of a word.
+static const uint64_t high_bits_64 = UINT64_C(0x8080808080808080);
+
+// Returns the 8 bytes starting at str as a little endian word.
+static inline uint64_t
+load_64(const uint8_t* str)
+{
+	// Compilers turn this into a single load.
+	return (uint64_t)str[0] | ((uint64_t)str[1] << 8) |
+	       ((uint64_t)str[2] << 16) | ((uint64_t)str[3] << 24) |
+	       ((uint64_t)str[4] << 32) | ((uint64_t)str[5] << 40) |
+	       ((uint64_t)str[6] << 48) | ((uint64_t)str[7] << 56);
+}
+
+// Returns true if the 8 bytes starting at str are all ASCII.
+static bool
+ascii_8(const uint8_t* str)
+{
+	return (load_64(str) & high_bits_64) == 0;
+}
+
+// Returns the number of bytes in word which aren't continuation bytes, which
+// is the number of characters which start in it if it's valid UTF-8.
+static size_t
+characters_8(const uint64_t word)
+{
+	// Continuation bytes are the ones whose top two bits are 10.
+	const uint64_t continuations = word & ~(word << 1) & high_bits_64;
+
+	// Multiplying adds up the bytes into the top one.
+	const uint64_t ones = continuations >> 7;
+	return 8 - (size_t)((ones * UINT64_C(0x0101010101010101)) >> 56);
+}
+
+// Moves i back to the first byte of the character the DFA was in the middle
+// of reading when it reached str[i].
+static size_t
+dfa_character_start(const uint8_t* str, size_t i)
+{
+	do {
+		i -= 1;
+	} while ((str[i] & 0xc0) == 0x80);
+
+	return i;
+}
+
 static size_t
 utf8_codepoint_size(const uint32_t cp)
 {
@@ -56,163 +172,2008 @@ utf8_codepoint_size(const uint32_t cp)
 	return 0;
 }
 
-static bool
-is_continuation(const uint8_t b)
+// Writes the UTF-8 encoding of cp to out, or that of U+FFFD if cp isn't a
+// valid codepoint, without checking that out has room for it. Returns the
+// number of bytes written.
+static inline size_t
+codepoint_encode_unchecked(const uint32_t cp, uint8_t* out)
 {
-	return b >= 0x80 && b <= 0xbf;
+	if (cp <= 0x7f) {
+		out[0] = (uint8_t)cp;
+		return 1;
+	} else if (cp <= 0x07ff) {
+		out[0] = (uint8_t)(((cp >> 6) & 0x1f) | 0xc0);
+		out[1] = (uint8_t)(((cp >> 0) & 0x3f) | 0x80);
+		return 2;
+	} else if (cp <= 0xffff) {
+		out[0] = (uint8_t)(((cp >> 12) & 0x0f) | 0xe0);
+		out[1] = (uint8_t)(((cp >> 6) & 0x3f) | 0x80);
+		out[2] = (uint8_t)(((cp >> 0) & 0x3f) | 0x80);
+		return 3;
+	} else if (cp <= 0x10ffff) {
+		out[0] = (uint8_t)(((cp >> 18) & 0x07) | 0xf0);
+		out[1] = (uint8_t)(((cp >> 12) & 0x3f) | 0x80);
+		out[2] = (uint8_t)(((cp >> 6) & 0x3f) | 0x80);
+		out[3] = (uint8_t)(((cp >> 0) & 0x3f) | 0x80);
+		return 4;
+	}
+
+	out[0] = utf8_replacement[0];
+	out[1] = utf8_replacement[1];
+	out[2] = utf8_replacement[2];
+	return 3;
 }
 
-ENCODING_PUBLIC
-bool
-utf8_valid(const size_t str_len, const uint8_t* str)
+#if ENCODING_X86_SIMD
+// Returns where the character containing str[i - 1] starts if it could still
+// be missing continuation bytes at i, or i otherwise. The bytes before i must
+// have been checked already, so that the result is always the start of a
+// character.
+static size_t
+character_start(const uint8_t* str, const size_t i)
 {
-	if (UNLIKELY(str == NULL)) {
-		return false;
+	for (size_t k = 1; k <= 3 && k <= i; k += 1) {
+		const uint8_t b = str[i - k];
+		if (b >= 0xc0) {
+			return i - k;
+		}
+
+		if (b <= 0x7f) {
+			break;
+		}
 	}
 
-	// Unicode Standard Version 14, Table 3-7. Well-Formed UTF-8 Byte
-	// Sequences:
-	//
-	// +--------------------+--------+--------+--------+--------+
-	// |   Code Points      | First  | Second | Third  | Fourth |
-	// +--------------------+--------+--------+--------+--------+
-	// | U+0000..U+007F     | 00..7F |        |        |        |
-	// | U+0080..U+07FF     | C2..DF | 80..BF |        |        |
-	// | U+0800..U+0FFF     | E0     | A0..BF | 80..BF |        |
-	// | U+1000..U+CFFF     | E1..EC | 80..BF | 80..BF |        |
-	// | U+D000..U+D7FF     | ED     | 80..9F | 80..BF |        |
-	// | U+E000..U+FFFF     | EE..EF | 80..BF | 80..BF |        |
-	// | U+10000..U+3FFFF   | F0     | 90..BF | 80..BF | 80..BF |
-	// | U+40000..U+FFFFF   | F1..F3 | 80..BF | 80..BF | 80..BF |
-	// | U+100000..U+10FFFF | F4     | 80..8F | 80..BF | 80..BF |
-	// +--------------------+--------+--------+--------+--------+
-	for (size_t i = 0; i < str_len; i += 1) {
-		const uint8_t b = str[i];
-		// As a consequence of the well-formedness conditions specified
-		// in Table 3-7, the following byte values are disallowed in
-		// UTF-8: C0–C1, F5–FF.
-		if (b == 0xc0 || b == 0xc1 || b >= 0xf5) {
-			return false;
+	return i;
+}
+
+// The SIMD validators use the lookup algorithm from "Validating UTF-8 In Less
+// Than One Instruction Per Byte" by John Keiser and Daniel Lemire. Each error
+// which can be seen in a pair of bytes has a bit below, which is set in each
+// of three tables indexed by the high and low nybbles of the first byte and
+// the high nybble of the second byte. A pair of bytes is invalid if the
+// values found in all three tables share a bit.
+//
+// The third and fourth bytes of a character are only checked against the byte
+// before them, so on top of that, each byte must be a continuation byte
+// following another continuation byte exactly when it is the third or fourth
+// byte of a character. TWO_CONTS marks such pairs, and is flipped for the
+// bytes 2 after E0..FF and 3 after F0..FF, so that it only remains set for
+// the pairs which are wrong.
+//
+// Blocks of ASCII are skipped after checking that the block before them
+// didn't end in the middle of a character.
+
+#define UTF8_TOO_SHORT      (1 << 0) // C0..FF followed by 00..7F or C0..FF
+#define UTF8_TOO_LONG       (1 << 1) // 00..7F followed by 80..BF
+#define UTF8_OVERLONG_3     (1 << 2) // E0 80..9F
+#define UTF8_TOO_LARGE      (1 << 3) // F4..FF 90..BF
+#define UTF8_SURROGATE      (1 << 4) // ED A0..BF
+#define UTF8_OVERLONG_2     (1 << 5) // C0..C1 80..BF
+#define UTF8_TOO_LARGE_1000 (1 << 6) // F5..FF 80..8F
+#define UTF8_OVERLONG_4     (1 << 6) // F0 80..8F
+#define UTF8_TWO_CONTS      (1 << 7) // 80..BF 80..BF
+
+// The errors which only depend on the high nybble of the first byte.
+#define UTF8_CARRY (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+// Indexed by the high nybble of the first byte.
+static const uint8_t byte_1_high_table[16] = {
+		// 00..7F
+		UTF8_TOO_LONG,
+		UTF8_TOO_LONG,
+		UTF8_TOO_LONG,
+		UTF8_TOO_LONG,
+		UTF8_TOO_LONG,
+		UTF8_TOO_LONG,
+		UTF8_TOO_LONG,
+		UTF8_TOO_LONG,
+		// 80..BF
+		UTF8_TWO_CONTS,
+		UTF8_TWO_CONTS,
+		UTF8_TWO_CONTS,
+		UTF8_TWO_CONTS,
+		// C0..CF
+		UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+		// D0..DF
+		UTF8_TOO_SHORT,
+		// E0..EF
+		UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+		// F0..FF
+		UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 |
+				UTF8_OVERLONG_4,
+};
+
+// Indexed by the low nybble of the first byte.
+static const uint8_t byte_1_low_table[16] = {
+		// C0, E0, F0
+		UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 |
+				UTF8_OVERLONG_4,
+		// C1
+		UTF8_CARRY | UTF8_OVERLONG_2,
+		UTF8_CARRY,
+		UTF8_CARRY,
+		// F4
+		UTF8_CARRY | UTF8_TOO_LARGE,
+		// F5..FF
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		// ED, FD
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 |
+				UTF8_SURROGATE,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+		UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,
+};
+
+// Indexed by the high nybble of the second byte.
+static const uint8_t byte_2_high_table[16] = {
+		// 00..7F
+		UTF8_TOO_SHORT,
+		UTF8_TOO_SHORT,
+		UTF8_TOO_SHORT,
+		UTF8_TOO_SHORT,
+		UTF8_TOO_SHORT,
+		UTF8_TOO_SHORT,
+		UTF8_TOO_SHORT,
+		UTF8_TOO_SHORT,
+		// 80..8F
+		UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS |
+				UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 |
+				UTF8_OVERLONG_4,
+		// 90..9F
+		UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS |
+				UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+		// A0..BF
+		UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS |
+				UTF8_SURROGATE | UTF8_TOO_LARGE,
+		UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS |
+				UTF8_SURROGATE | UTF8_TOO_LARGE,
+		// C0..FF
+		UTF8_TOO_SHORT,
+		UTF8_TOO_SHORT,
+		UTF8_TOO_SHORT,
+		UTF8_TOO_SHORT,
+};
+
+// Bytes which are greater than these at the end of a block start a character
+// which continues into the next block.
+static const uint8_t incomplete_table[16] = {
+		0xff,
+		0xff,
+		0xff,
+		0xff,
+		0xff,
+		0xff,
+		0xff,
+		0xff,
+		0xff,
+		0xff,
+		0xff,
+		0xff,
+		0xff,
+		0xef, // Lead bytes of 4 byte characters
+		0xdf, // Lead bytes of 3 or more byte characters
+		0xbf, // Lead bytes
+};
+
+// Returns a vector which is non-zero if the 16 bytes in input, which follow
+// the 16 bytes in prev, contain an error.
+ENCODING_TARGET("ssse3")
+static __m128i
+check_ssse3(const __m128i input, const __m128i prev)
+{
+	const __m128i nybble = _mm_set1_epi8(0x0f);
+	const __m128i prev1  = _mm_alignr_epi8(input, prev, 15);
+	const __m128i prev2  = _mm_alignr_epi8(input, prev, 14);
+	const __m128i prev3  = _mm_alignr_epi8(input, prev, 13);
+
+	const __m128i byte_1_high = _mm_shuffle_epi8(
+			_mm_loadu_si128((const __m128i*)byte_1_high_table),
+			_mm_and_si128(_mm_srli_epi16(prev1, 4), nybble));
+	const __m128i byte_1_low = _mm_shuffle_epi8(
+			_mm_loadu_si128((const __m128i*)byte_1_low_table),
+			_mm_and_si128(prev1, nybble));
+	const __m128i byte_2_high = _mm_shuffle_epi8(
+			_mm_loadu_si128((const __m128i*)byte_2_high_table),
+			_mm_and_si128(_mm_srli_epi16(input, 4), nybble));
+	const __m128i errors = _mm_and_si128(
+			_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+	// Only the bytes 2 after E0..FF or 3 after F0..FF keep their high
+	// bit.
+	const __m128i third  = _mm_subs_epu8(prev2, _mm_set1_epi8(0x60));
+	const __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(0x70));
+	const __m128i must_continue = _mm_and_si128(
+			_mm_or_si128(third, fourth),
+			_mm_set1_epi8((char)0x80));
+
+	return _mm_xor_si128(errors, must_continue);
+}
+
+// Returns the sum of the 16 bytes in v.
+static size_t
+sum_bytes(const __m128i v)
+{
+	const __m128i sums = _mm_sad_epu8(v, _mm_setzero_si128());
+	return (size_t)_mm_cvtsi128_si64(sums) +
+	       (size_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums));
+}
+
+// Validates 32 bytes at a time, returning how many bytes of str were checked.
+// This is always the start of a character, and stops early before the first
+// block containing an error.
+//
+// If count isn't NULL, the number of characters in the checked bytes is added
+// to *count. Since they are valid, this is the number of bytes which aren't
+// continuation bytes.
+ENCODING_TARGET("ssse3")
+static size_t
+valid_ssse3(const size_t str_len, const uint8_t* str, size_t* count)
+{
+	const __m128i incomplete_max =
+			_mm_loadu_si128((const __m128i*)incomplete_table);
+	const __m128i continuation_max = _mm_set1_epi8((char)0xbf);
+
+	__m128i prev       = _mm_setzero_si128();
+	__m128i incomplete = _mm_setzero_si128();
+
+	// Each byte of counts holds the number of characters seen in its
+	// position in up to 127 blocks before it's added to result.
+	__m128i counts = _mm_setzero_si128();
+	size_t  blocks = 0;
+	size_t  result = 0;
+
+	size_t i = 0;
+	for (; i + 32 <= str_len; i += 32) {
+		const __m128i* in = (const __m128i*)&str[i];
+		const __m128i  a  = _mm_loadu_si128(in);
+		const __m128i  b  = _mm_loadu_si128(in + 1);
+
+		const bool ascii = _mm_movemask_epi8(_mm_or_si128(a, b)) == 0;
+
+		__m128i errors = incomplete;
+		if (!ascii) {
+			errors = _mm_or_si128(check_ssse3(a, prev),
+					check_ssse3(b, a));
+			incomplete = _mm_subs_epu8(b, incomplete_max);
+		} else {
+			incomplete = _mm_setzero_si128();
 		}
 
-		if (b <= 0x7f) {
-			continue;
+		const __m128i zero = _mm_setzero_si128();
+		if (UNLIKELY(_mm_movemask_epi8(_mm_cmpeq_epi8(errors, zero)) !=
+				0xffff)) {
+			break;
 		}
 
-		if (b >= 0xc2 && b <= 0xdf) {
-			if (i + 1 >= str_len || !is_continuation(str[i + 1])) {
-				return false;
-			}
+		prev = b;
+		if (count == NULL) {
+			continue;
+		}
 
-			i += 1;
+		if (ascii) {
+			result += 32;
 			continue;
 		}
 
-		if (b == 0xe0) {
-			if (i + 2 >= str_len) {
-				return false;
-			}
+		// As signed bytes, continuation bytes are the smallest.
+		counts = _mm_sub_epi8(
+				counts, _mm_cmpgt_epi8(a, continuation_max));
+		counts = _mm_sub_epi8(
+				counts, _mm_cmpgt_epi8(b, continuation_max));
+		blocks += 1;
+		if (blocks == 127) {
+			result += sum_bytes(counts);
+			counts = _mm_setzero_si128();
+			blocks = 0;
+		}
+	}
 
-			if (!(str[i + 1] >= 0xa0 && str[i + 1] <= 0xbf) ||
-					!is_continuation(str[i + 2])) {
-				return false;
-			}
+	const size_t end = character_start(str, i);
+	if (count != NULL) {
+		// The first byte of a character which isn't finished was
+		// counted, but isn't part of the checked bytes.
+		*count += result + sum_bytes(counts) - (end < i);
+	}
 
-			i += 2;
-			continue;
+	return end;
+}
+
+// Returns a vector which is non-zero if the 32 bytes in input, which follow
+// the 32 bytes in prev, contain an error.
+ENCODING_TARGET("avx2")
+static __m256i
+check_avx2(const __m256i input, const __m256i prev)
+{
+	const __m256i nybble = _mm256_set1_epi8(0x0f);
+
+	// The 16 bytes before each lane of input.
+	const __m256i before = _mm256_permute2x128_si256(prev, input, 0x21);
+	const __m256i prev1  = _mm256_alignr_epi8(input, before, 15);
+	const __m256i prev2  = _mm256_alignr_epi8(input, before, 14);
+	const __m256i prev3  = _mm256_alignr_epi8(input, before, 13);
+
+	const __m256i byte_1_high = _mm256_shuffle_epi8(
+			_mm256_broadcastsi128_si256(_mm_loadu_si128(
+					(const __m128i*)byte_1_high_table)),
+			_mm256_and_si256(_mm256_srli_epi16(prev1, 4), nybble));
+	const __m256i byte_1_low = _mm256_shuffle_epi8(
+			_mm256_broadcastsi128_si256(_mm_loadu_si128(
+					(const __m128i*)byte_1_low_table)),
+			_mm256_and_si256(prev1, nybble));
+	const __m256i byte_2_high = _mm256_shuffle_epi8(
+			_mm256_broadcastsi128_si256(_mm_loadu_si128(
+					(const __m128i*)byte_2_high_table)),
+			_mm256_and_si256(_mm256_srli_epi16(input, 4), nybble));
+	const __m256i errors = _mm256_and_si256(
+			_mm256_and_si256(byte_1_high, byte_1_low),
+			byte_2_high);
+
+	const __m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(0x60));
+	const __m256i fourth =
+			_mm256_subs_epu8(prev3, _mm256_set1_epi8(0x70));
+	const __m256i must_continue = _mm256_and_si256(
+			_mm256_or_si256(third, fourth),
+			_mm256_set1_epi8((char)0x80));
+
+	return _mm256_xor_si256(errors, must_continue);
+}
+
+// Returns the sum of the 32 bytes in v.
+ENCODING_TARGET("avx2")
+static size_t
+sum_bytes_avx2(const __m256i v)
+{
+	const __m256i sums = _mm256_sad_epu8(v, _mm256_setzero_si256());
+	const __m128i half = _mm_add_epi64(_mm256_castsi256_si128(sums),
+			_mm256_extracti128_si256(sums, 1));
+	return (size_t)_mm_cvtsi128_si64(half) +
+	       (size_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(half, half));
+}
+
+// Same as valid_ssse3, but 64 bytes at a time.
+ENCODING_TARGET("avx2")
+static size_t
+valid_avx2(const size_t str_len, const uint8_t* str, size_t* count)
+{
+	// Only the last lane of a block can end in the middle of a character.
+	const __m256i incomplete_max = _mm256_inserti128_si256(
+			_mm256_set1_epi8((char)0xff),
+			_mm_loadu_si128((const __m128i*)incomplete_table), 1);
+	const __m256i continuation_max = _mm256_set1_epi8((char)0xbf);
+
+	__m256i prev       = _mm256_setzero_si256();
+	__m256i incomplete = _mm256_setzero_si256();
+
+	__m256i counts = _mm256_setzero_si256();
+	size_t  blocks = 0;
+	size_t  result = 0;
+
+	size_t i = 0;
+	for (; i + 64 <= str_len; i += 64) {
+		const __m256i* in = (const __m256i*)&str[i];
+		const __m256i  a  = _mm256_loadu_si256(in);
+		const __m256i  b  = _mm256_loadu_si256(in + 1);
+
+		const __m256i either = _mm256_or_si256(a, b);
+		const bool    ascii  = _mm256_movemask_epi8(either) == 0;
+
+		__m256i errors = incomplete;
+		if (!ascii) {
+			errors = _mm256_or_si256(check_avx2(a, prev),
+					check_avx2(b, a));
+			incomplete = _mm256_subs_epu8(b, incomplete_max);
+		} else {
+			incomplete = _mm256_setzero_si256();
 		}
 
-		if (b >= 0xe1 && b <= 0xec) {
-			if (i + 2 >= str_len) {
-				return false;
-			}
+		if (UNLIKELY(!_mm256_testz_si256(errors, errors))) {
+			break;
+		}
 
-			if (!is_continuation(str[i + 1]) ||
-					!is_continuation(str[i + 2])) {
-				return false;
-			}
+		prev = b;
+		if (count == NULL) {
+			continue;
+		}
 
-			i += 2;
+		if (ascii) {
+			result += 64;
 			continue;
 		}
 
-		if (b == 0xed) {
-			if (i + 2 >= str_len) {
-				return false;
-			}
+		counts = _mm256_sub_epi8(counts,
+				_mm256_cmpgt_epi8(a, continuation_max));
+		counts = _mm256_sub_epi8(counts,
+				_mm256_cmpgt_epi8(b, continuation_max));
+		blocks += 1;
+		if (blocks == 127) {
+			result += sum_bytes_avx2(counts);
+			counts = _mm256_setzero_si256();
+			blocks = 0;
+		}
+	}
+
+	const size_t end = character_start(str, i);
+	if (count != NULL) {
+		*count += result + sum_bytes_avx2(counts) - (end < i);
+	}
 
-			if (!(str[i + 1] >= 0x80 && str[i + 1] <= 0x9f) ||
-					!is_continuation(str[i + 2])) {
-				return false;
+	return end;
+}
+
+// Validates as much of str as possible using the best kernel the CPU
+// supports, returning how many bytes of str were checked. This is always the
+// start of a character. If count isn't NULL, the number of characters in the
+// checked bytes is added to *count.
+static size_t
+valid_simd(const size_t str_len, const uint8_t* str, size_t* count)
+{
+	const int features = encoding_cpu_features();
+
+	size_t i = 0;
+	if (features & ENCODING_CPU_AVX2) {
+		i = valid_avx2(str_len, str, count);
+	}
+
+	if (features & ENCODING_CPU_SSSE3) {
+		i += valid_ssse3(str_len - i, str + i, count);
+	}
+
+	return i;
+}
+
+// For each combination of the lengths of 4 characters, the pshufb indices
+// which move the bytes of each character into its own 32-bit lane, last byte
+// first. Each length minus one takes 2 bits of the index, the first
+// character's the lowest.
+//
+// Generated using tools/gen_utf8_decode_table.c
+static const uint8_t decode_table[256][16] = {
+		{0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x80,
+				0x80, 0x80, 0x03, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x80,
+				0x80, 0x80, 0x04, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x80,
+				0x80, 0x80, 0x05, 0x80, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x04, 0x80, 0x80, 0x80, 0x05, 0x80,
+				0x80, 0x80, 0x06, 0x80, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x02, 0x01, 0x80, 0x80, 0x03, 0x80,
+				0x80, 0x80, 0x04, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x03, 0x02, 0x80, 0x80, 0x04, 0x80,
+				0x80, 0x80, 0x05, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x04, 0x03, 0x80, 0x80, 0x05, 0x80,
+				0x80, 0x80, 0x06, 0x80, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x05, 0x04, 0x80, 0x80, 0x06, 0x80,
+				0x80, 0x80, 0x07, 0x80, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x03, 0x02, 0x01, 0x80, 0x04, 0x80,
+				0x80, 0x80, 0x05, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x04, 0x03, 0x02, 0x80, 0x05, 0x80,
+				0x80, 0x80, 0x06, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x05, 0x04, 0x03, 0x80, 0x06, 0x80,
+				0x80, 0x80, 0x07, 0x80, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x80, 0x07, 0x80,
+				0x80, 0x80, 0x08, 0x80, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x04, 0x03, 0x02, 0x01, 0x05, 0x80,
+				0x80, 0x80, 0x06, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x05, 0x04, 0x03, 0x02, 0x06, 0x80,
+				0x80, 0x80, 0x07, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x06, 0x05, 0x04, 0x03, 0x07, 0x80,
+				0x80, 0x80, 0x08, 0x80, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04, 0x08, 0x80,
+				0x80, 0x80, 0x09, 0x80, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x03, 0x02,
+				0x80, 0x80, 0x04, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x04, 0x03,
+				0x80, 0x80, 0x05, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x03, 0x80, 0x80, 0x80, 0x05, 0x04,
+				0x80, 0x80, 0x06, 0x80, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x04, 0x80, 0x80, 0x80, 0x06, 0x05,
+				0x80, 0x80, 0x07, 0x80, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x02, 0x01, 0x80, 0x80, 0x04, 0x03,
+				0x80, 0x80, 0x05, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x03, 0x02, 0x80, 0x80, 0x05, 0x04,
+				0x80, 0x80, 0x06, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x04, 0x03, 0x80, 0x80, 0x06, 0x05,
+				0x80, 0x80, 0x07, 0x80, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x05, 0x04, 0x80, 0x80, 0x07, 0x06,
+				0x80, 0x80, 0x08, 0x80, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x03, 0x02, 0x01, 0x80, 0x05, 0x04,
+				0x80, 0x80, 0x06, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x04, 0x03, 0x02, 0x80, 0x06, 0x05,
+				0x80, 0x80, 0x07, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x05, 0x04, 0x03, 0x80, 0x07, 0x06,
+				0x80, 0x80, 0x08, 0x80, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x80, 0x08, 0x07,
+				0x80, 0x80, 0x09, 0x80, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x04, 0x03, 0x02, 0x01, 0x06, 0x05,
+				0x80, 0x80, 0x07, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x05, 0x04, 0x03, 0x02, 0x07, 0x06,
+				0x80, 0x80, 0x08, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x06, 0x05, 0x04, 0x03, 0x08, 0x07,
+				0x80, 0x80, 0x09, 0x80, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04, 0x09, 0x08,
+				0x80, 0x80, 0x0a, 0x80, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x04, 0x03,
+				0x02, 0x80, 0x05, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x05, 0x04,
+				0x03, 0x80, 0x06, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x03, 0x80, 0x80, 0x80, 0x06, 0x05,
+				0x04, 0x80, 0x07, 0x80, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x04, 0x80, 0x80, 0x80, 0x07, 0x06,
+				0x05, 0x80, 0x08, 0x80, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x02, 0x01, 0x80, 0x80, 0x05, 0x04,
+				0x03, 0x80, 0x06, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x03, 0x02, 0x80, 0x80, 0x06, 0x05,
+				0x04, 0x80, 0x07, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x04, 0x03, 0x80, 0x80, 0x07, 0x06,
+				0x05, 0x80, 0x08, 0x80, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x05, 0x04, 0x80, 0x80, 0x08, 0x07,
+				0x06, 0x80, 0x09, 0x80, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x03, 0x02, 0x01, 0x80, 0x06, 0x05,
+				0x04, 0x80, 0x07, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x04, 0x03, 0x02, 0x80, 0x07, 0x06,
+				0x05, 0x80, 0x08, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x05, 0x04, 0x03, 0x80, 0x08, 0x07,
+				0x06, 0x80, 0x09, 0x80, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x80, 0x09, 0x08,
+				0x07, 0x80, 0x0a, 0x80, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x04, 0x03, 0x02, 0x01, 0x07, 0x06,
+				0x05, 0x80, 0x08, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x05, 0x04, 0x03, 0x02, 0x08, 0x07,
+				0x06, 0x80, 0x09, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x06, 0x05, 0x04, 0x03, 0x09, 0x08,
+				0x07, 0x80, 0x0a, 0x80, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04, 0x0a, 0x09,
+				0x08, 0x80, 0x0b, 0x80, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x05, 0x04,
+				0x03, 0x02, 0x06, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x06, 0x05,
+				0x04, 0x03, 0x07, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x03, 0x80, 0x80, 0x80, 0x07, 0x06,
+				0x05, 0x04, 0x08, 0x80, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x04, 0x80, 0x80, 0x80, 0x08, 0x07,
+				0x06, 0x05, 0x09, 0x80, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x02, 0x01, 0x80, 0x80, 0x06, 0x05,
+				0x04, 0x03, 0x07, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x03, 0x02, 0x80, 0x80, 0x07, 0x06,
+				0x05, 0x04, 0x08, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x04, 0x03, 0x80, 0x80, 0x08, 0x07,
+				0x06, 0x05, 0x09, 0x80, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x05, 0x04, 0x80, 0x80, 0x09, 0x08,
+				0x07, 0x06, 0x0a, 0x80, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x03, 0x02, 0x01, 0x80, 0x07, 0x06,
+				0x05, 0x04, 0x08, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x04, 0x03, 0x02, 0x80, 0x08, 0x07,
+				0x06, 0x05, 0x09, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x05, 0x04, 0x03, 0x80, 0x09, 0x08,
+				0x07, 0x06, 0x0a, 0x80, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x80, 0x0a, 0x09,
+				0x08, 0x07, 0x0b, 0x80, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x04, 0x03, 0x02, 0x01, 0x08, 0x07,
+				0x06, 0x05, 0x09, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x05, 0x04, 0x03, 0x02, 0x09, 0x08,
+				0x07, 0x06, 0x0a, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x06, 0x05, 0x04, 0x03, 0x0a, 0x09,
+				0x08, 0x07, 0x0b, 0x80, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04, 0x0b, 0x0a,
+				0x09, 0x08, 0x0c, 0x80, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x80,
+				0x80, 0x80, 0x04, 0x03, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x80,
+				0x80, 0x80, 0x05, 0x04, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x80,
+				0x80, 0x80, 0x06, 0x05, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x04, 0x80, 0x80, 0x80, 0x05, 0x80,
+				0x80, 0x80, 0x07, 0x06, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x02, 0x01, 0x80, 0x80, 0x03, 0x80,
+				0x80, 0x80, 0x05, 0x04, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x03, 0x02, 0x80, 0x80, 0x04, 0x80,
+				0x80, 0x80, 0x06, 0x05, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x04, 0x03, 0x80, 0x80, 0x05, 0x80,
+				0x80, 0x80, 0x07, 0x06, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x05, 0x04, 0x80, 0x80, 0x06, 0x80,
+				0x80, 0x80, 0x08, 0x07, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x03, 0x02, 0x01, 0x80, 0x04, 0x80,
+				0x80, 0x80, 0x06, 0x05, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x04, 0x03, 0x02, 0x80, 0x05, 0x80,
+				0x80, 0x80, 0x07, 0x06, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x05, 0x04, 0x03, 0x80, 0x06, 0x80,
+				0x80, 0x80, 0x08, 0x07, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x80, 0x07, 0x80,
+				0x80, 0x80, 0x09, 0x08, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x04, 0x03, 0x02, 0x01, 0x05, 0x80,
+				0x80, 0x80, 0x07, 0x06, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x05, 0x04, 0x03, 0x02, 0x06, 0x80,
+				0x80, 0x80, 0x08, 0x07, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x06, 0x05, 0x04, 0x03, 0x07, 0x80,
+				0x80, 0x80, 0x09, 0x08, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04, 0x08, 0x80,
+				0x80, 0x80, 0x0a, 0x09, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x03, 0x02,
+				0x80, 0x80, 0x05, 0x04, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x04, 0x03,
+				0x80, 0x80, 0x06, 0x05, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x03, 0x80, 0x80, 0x80, 0x05, 0x04,
+				0x80, 0x80, 0x07, 0x06, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x04, 0x80, 0x80, 0x80, 0x06, 0x05,
+				0x80, 0x80, 0x08, 0x07, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x02, 0x01, 0x80, 0x80, 0x04, 0x03,
+				0x80, 0x80, 0x06, 0x05, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x03, 0x02, 0x80, 0x80, 0x05, 0x04,
+				0x80, 0x80, 0x07, 0x06, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x04, 0x03, 0x80, 0x80, 0x06, 0x05,
+				0x80, 0x80, 0x08, 0x07, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x05, 0x04, 0x80, 0x80, 0x07, 0x06,
+				0x80, 0x80, 0x09, 0x08, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x03, 0x02, 0x01, 0x80, 0x05, 0x04,
+				0x80, 0x80, 0x07, 0x06, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x04, 0x03, 0x02, 0x80, 0x06, 0x05,
+				0x80, 0x80, 0x08, 0x07, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x05, 0x04, 0x03, 0x80, 0x07, 0x06,
+				0x80, 0x80, 0x09, 0x08, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x80, 0x08, 0x07,
+				0x80, 0x80, 0x0a, 0x09, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x04, 0x03, 0x02, 0x01, 0x06, 0x05,
+				0x80, 0x80, 0x08, 0x07, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x05, 0x04, 0x03, 0x02, 0x07, 0x06,
+				0x80, 0x80, 0x09, 0x08, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x06, 0x05, 0x04, 0x03, 0x08, 0x07,
+				0x80, 0x80, 0x0a, 0x09, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04, 0x09, 0x08,
+				0x80, 0x80, 0x0b, 0x0a, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x04, 0x03,
+				0x02, 0x80, 0x06, 0x05, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x05, 0x04,
+				0x03, 0x80, 0x07, 0x06, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x03, 0x80, 0x80, 0x80, 0x06, 0x05,
+				0x04, 0x80, 0x08, 0x07, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x04, 0x80, 0x80, 0x80, 0x07, 0x06,
+				0x05, 0x80, 0x09, 0x08, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x02, 0x01, 0x80, 0x80, 0x05, 0x04,
+				0x03, 0x80, 0x07, 0x06, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x03, 0x02, 0x80, 0x80, 0x06, 0x05,
+				0x04, 0x80, 0x08, 0x07, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x04, 0x03, 0x80, 0x80, 0x07, 0x06,
+				0x05, 0x80, 0x09, 0x08, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x05, 0x04, 0x80, 0x80, 0x08, 0x07,
+				0x06, 0x80, 0x0a, 0x09, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x03, 0x02, 0x01, 0x80, 0x06, 0x05,
+				0x04, 0x80, 0x08, 0x07, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x04, 0x03, 0x02, 0x80, 0x07, 0x06,
+				0x05, 0x80, 0x09, 0x08, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x05, 0x04, 0x03, 0x80, 0x08, 0x07,
+				0x06, 0x80, 0x0a, 0x09, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x80, 0x09, 0x08,
+				0x07, 0x80, 0x0b, 0x0a, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x04, 0x03, 0x02, 0x01, 0x07, 0x06,
+				0x05, 0x80, 0x09, 0x08, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x05, 0x04, 0x03, 0x02, 0x08, 0x07,
+				0x06, 0x80, 0x0a, 0x09, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x06, 0x05, 0x04, 0x03, 0x09, 0x08,
+				0x07, 0x80, 0x0b, 0x0a, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04, 0x0a, 0x09,
+				0x08, 0x80, 0x0c, 0x0b, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x05, 0x04,
+				0x03, 0x02, 0x07, 0x06, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x06, 0x05,
+				0x04, 0x03, 0x08, 0x07, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x03, 0x80, 0x80, 0x80, 0x07, 0x06,
+				0x05, 0x04, 0x09, 0x08, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x04, 0x80, 0x80, 0x80, 0x08, 0x07,
+				0x06, 0x05, 0x0a, 0x09, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x02, 0x01, 0x80, 0x80, 0x06, 0x05,
+				0x04, 0x03, 0x08, 0x07, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x03, 0x02, 0x80, 0x80, 0x07, 0x06,
+				0x05, 0x04, 0x09, 0x08, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x04, 0x03, 0x80, 0x80, 0x08, 0x07,
+				0x06, 0x05, 0x0a, 0x09, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x05, 0x04, 0x80, 0x80, 0x09, 0x08,
+				0x07, 0x06, 0x0b, 0x0a, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x03, 0x02, 0x01, 0x80, 0x07, 0x06,
+				0x05, 0x04, 0x09, 0x08, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x04, 0x03, 0x02, 0x80, 0x08, 0x07,
+				0x06, 0x05, 0x0a, 0x09, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x05, 0x04, 0x03, 0x80, 0x09, 0x08,
+				0x07, 0x06, 0x0b, 0x0a, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x80, 0x0a, 0x09,
+				0x08, 0x07, 0x0c, 0x0b, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x04, 0x03, 0x02, 0x01, 0x08, 0x07,
+				0x06, 0x05, 0x0a, 0x09, 0x80, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x05, 0x04, 0x03, 0x02, 0x09, 0x08,
+				0x07, 0x06, 0x0b, 0x0a, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x06, 0x05, 0x04, 0x03, 0x0a, 0x09,
+				0x08, 0x07, 0x0c, 0x0b, 0x80, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04, 0x0b, 0x0a,
+				0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x80,
+				0x80, 0x80, 0x05, 0x04, 0x03, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x80,
+				0x80, 0x80, 0x06, 0x05, 0x04, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x80,
+				0x80, 0x80, 0x07, 0x06, 0x05, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x04, 0x80, 0x80, 0x80, 0x05, 0x80,
+				0x80, 0x80, 0x08, 0x07, 0x06, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x02, 0x01, 0x80, 0x80, 0x03, 0x80,
+				0x80, 0x80, 0x06, 0x05, 0x04, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x03, 0x02, 0x80, 0x80, 0x04, 0x80,
+				0x80, 0x80, 0x07, 0x06, 0x05, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x04, 0x03, 0x80, 0x80, 0x05, 0x80,
+				0x80, 0x80, 0x08, 0x07, 0x06, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x05, 0x04, 0x80, 0x80, 0x06, 0x80,
+				0x80, 0x80, 0x09, 0x08, 0x07, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x03, 0x02, 0x01, 0x80, 0x04, 0x80,
+				0x80, 0x80, 0x07, 0x06, 0x05, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x04, 0x03, 0x02, 0x80, 0x05, 0x80,
+				0x80, 0x80, 0x08, 0x07, 0x06, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x05, 0x04, 0x03, 0x80, 0x06, 0x80,
+				0x80, 0x80, 0x09, 0x08, 0x07, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x80, 0x07, 0x80,
+				0x80, 0x80, 0x0a, 0x09, 0x08, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x04, 0x03, 0x02, 0x01, 0x05, 0x80,
+				0x80, 0x80, 0x08, 0x07, 0x06, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x05, 0x04, 0x03, 0x02, 0x06, 0x80,
+				0x80, 0x80, 0x09, 0x08, 0x07, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x06, 0x05, 0x04, 0x03, 0x07, 0x80,
+				0x80, 0x80, 0x0a, 0x09, 0x08, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04, 0x08, 0x80,
+				0x80, 0x80, 0x0b, 0x0a, 0x09, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x03, 0x02,
+				0x80, 0x80, 0x06, 0x05, 0x04, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x04, 0x03,
+				0x80, 0x80, 0x07, 0x06, 0x05, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x03, 0x80, 0x80, 0x80, 0x05, 0x04,
+				0x80, 0x80, 0x08, 0x07, 0x06, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x04, 0x80, 0x80, 0x80, 0x06, 0x05,
+				0x80, 0x80, 0x09, 0x08, 0x07, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x02, 0x01, 0x80, 0x80, 0x04, 0x03,
+				0x80, 0x80, 0x07, 0x06, 0x05, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x03, 0x02, 0x80, 0x80, 0x05, 0x04,
+				0x80, 0x80, 0x08, 0x07, 0x06, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x04, 0x03, 0x80, 0x80, 0x06, 0x05,
+				0x80, 0x80, 0x09, 0x08, 0x07, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x05, 0x04, 0x80, 0x80, 0x07, 0x06,
+				0x80, 0x80, 0x0a, 0x09, 0x08, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x03, 0x02, 0x01, 0x80, 0x05, 0x04,
+				0x80, 0x80, 0x08, 0x07, 0x06, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x04, 0x03, 0x02, 0x80, 0x06, 0x05,
+				0x80, 0x80, 0x09, 0x08, 0x07, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x05, 0x04, 0x03, 0x80, 0x07, 0x06,
+				0x80, 0x80, 0x0a, 0x09, 0x08, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x80, 0x08, 0x07,
+				0x80, 0x80, 0x0b, 0x0a, 0x09, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x04, 0x03, 0x02, 0x01, 0x06, 0x05,
+				0x80, 0x80, 0x09, 0x08, 0x07, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x05, 0x04, 0x03, 0x02, 0x07, 0x06,
+				0x80, 0x80, 0x0a, 0x09, 0x08, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x06, 0x05, 0x04, 0x03, 0x08, 0x07,
+				0x80, 0x80, 0x0b, 0x0a, 0x09, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04, 0x09, 0x08,
+				0x80, 0x80, 0x0c, 0x0b, 0x0a, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x04, 0x03,
+				0x02, 0x80, 0x07, 0x06, 0x05, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x05, 0x04,
+				0x03, 0x80, 0x08, 0x07, 0x06, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x03, 0x80, 0x80, 0x80, 0x06, 0x05,
+				0x04, 0x80, 0x09, 0x08, 0x07, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x04, 0x80, 0x80, 0x80, 0x07, 0x06,
+				0x05, 0x80, 0x0a, 0x09, 0x08, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x02, 0x01, 0x80, 0x80, 0x05, 0x04,
+				0x03, 0x80, 0x08, 0x07, 0x06, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x03, 0x02, 0x80, 0x80, 0x06, 0x05,
+				0x04, 0x80, 0x09, 0x08, 0x07, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x04, 0x03, 0x80, 0x80, 0x07, 0x06,
+				0x05, 0x80, 0x0a, 0x09, 0x08, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x05, 0x04, 0x80, 0x80, 0x08, 0x07,
+				0x06, 0x80, 0x0b, 0x0a, 0x09, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x03, 0x02, 0x01, 0x80, 0x06, 0x05,
+				0x04, 0x80, 0x09, 0x08, 0x07, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x04, 0x03, 0x02, 0x80, 0x07, 0x06,
+				0x05, 0x80, 0x0a, 0x09, 0x08, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x05, 0x04, 0x03, 0x80, 0x08, 0x07,
+				0x06, 0x80, 0x0b, 0x0a, 0x09, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x80, 0x09, 0x08,
+				0x07, 0x80, 0x0c, 0x0b, 0x0a, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x04, 0x03, 0x02, 0x01, 0x07, 0x06,
+				0x05, 0x80, 0x0a, 0x09, 0x08, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x05, 0x04, 0x03, 0x02, 0x08, 0x07,
+				0x06, 0x80, 0x0b, 0x0a, 0x09, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x06, 0x05, 0x04, 0x03, 0x09, 0x08,
+				0x07, 0x80, 0x0c, 0x0b, 0x0a, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04, 0x0a, 0x09,
+				0x08, 0x80, 0x0d, 0x0c, 0x0b, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x05, 0x04,
+				0x03, 0x02, 0x08, 0x07, 0x06, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x06, 0x05,
+				0x04, 0x03, 0x09, 0x08, 0x07, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x03, 0x80, 0x80, 0x80, 0x07, 0x06,
+				0x05, 0x04, 0x0a, 0x09, 0x08, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x04, 0x80, 0x80, 0x80, 0x08, 0x07,
+				0x06, 0x05, 0x0b, 0x0a, 0x09, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x02, 0x01, 0x80, 0x80, 0x06, 0x05,
+				0x04, 0x03, 0x09, 0x08, 0x07, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x03, 0x02, 0x80, 0x80, 0x07, 0x06,
+				0x05, 0x04, 0x0a, 0x09, 0x08, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x04, 0x03, 0x80, 0x80, 0x08, 0x07,
+				0x06, 0x05, 0x0b, 0x0a, 0x09, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x05, 0x04, 0x80, 0x80, 0x09, 0x08,
+				0x07, 0x06, 0x0c, 0x0b, 0x0a, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x03, 0x02, 0x01, 0x80, 0x07, 0x06,
+				0x05, 0x04, 0x0a, 0x09, 0x08, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x04, 0x03, 0x02, 0x80, 0x08, 0x07,
+				0x06, 0x05, 0x0b, 0x0a, 0x09, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x05, 0x04, 0x03, 0x80, 0x09, 0x08,
+				0x07, 0x06, 0x0c, 0x0b, 0x0a, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x80, 0x0a, 0x09,
+				0x08, 0x07, 0x0d, 0x0c, 0x0b, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x04, 0x03, 0x02, 0x01, 0x08, 0x07,
+				0x06, 0x05, 0x0b, 0x0a, 0x09, 0x80},
+		{0x01, 0x00, 0x80, 0x80, 0x05, 0x04, 0x03, 0x02, 0x09, 0x08,
+				0x07, 0x06, 0x0c, 0x0b, 0x0a, 0x80},
+		{0x02, 0x01, 0x00, 0x80, 0x06, 0x05, 0x04, 0x03, 0x0a, 0x09,
+				0x08, 0x07, 0x0d, 0x0c, 0x0b, 0x80},
+		{0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04, 0x0b, 0x0a,
+				0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80},
+		{0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x02, 0x80,
+				0x80, 0x80, 0x06, 0x05, 0x04, 0x03},
+		{0x01, 0x00, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x03, 0x80,
+				0x80, 0x80, 0x07, 0x06, 0x05, 0x04},
+		{0x02, 0x01, 0x00, 0x80, 0x03, 0x80, 0x80, 0x80, 0x04, 0x80,
+				0x80, 0x80, 0x08, 0x07, 0x06, 0x05},
+		{0x03, 0x02, 0x01, 0x00, 0x04, 0x80, 0x80, 0x80, 0x05, 0x80,
+				0x80, 0x80, 0x09, 0x08, 0x07, 0x06},
+		{0x00, 0x80, 0x80, 0x80, 0x02, 0x01, 0x80, 0x80, 0x03, 0x80,
+				0x80, 0x80, 0x07, 0x06, 0x05, 0x04},
+		{0x01, 0x00, 0x80, 0x80, 0x03, 0x02, 0x80, 0x80, 0x04, 0x80,
+				0x80, 0x80, 0x08, 0x07, 0x06, 0x05},
+		{0x02, 0x01, 0x00, 0x80, 0x04, 0x03, 0x80, 0x80, 0x05, 0x80,
+				0x80, 0x80, 0x09, 0x08, 0x07, 0x06},
+		{0x03, 0x02, 0x01, 0x00, 0x05, 0x04, 0x80, 0x80, 0x06, 0x80,
+				0x80, 0x80, 0x0a, 0x09, 0x08, 0x07},
+		{0x00, 0x80, 0x80, 0x80, 0x03, 0x02, 0x01, 0x80, 0x04, 0x80,
+				0x80, 0x80, 0x08, 0x07, 0x06, 0x05},
+		{0x01, 0x00, 0x80, 0x80, 0x04, 0x03, 0x02, 0x80, 0x05, 0x80,
+				0x80, 0x80, 0x09, 0x08, 0x07, 0x06},
+		{0x02, 0x01, 0x00, 0x80, 0x05, 0x04, 0x03, 0x80, 0x06, 0x80,
+				0x80, 0x80, 0x0a, 0x09, 0x08, 0x07},
+		{0x03, 0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x80, 0x07, 0x80,
+				0x80, 0x80, 0x0b, 0x0a, 0x09, 0x08},
+		{0x00, 0x80, 0x80, 0x80, 0x04, 0x03, 0x02, 0x01, 0x05, 0x80,
+				0x80, 0x80, 0x09, 0x08, 0x07, 0x06},
+		{0x01, 0x00, 0x80, 0x80, 0x05, 0x04, 0x03, 0x02, 0x06, 0x80,
+				0x80, 0x80, 0x0a, 0x09, 0x08, 0x07},
+		{0x02, 0x01, 0x00, 0x80, 0x06, 0x05, 0x04, 0x03, 0x07, 0x80,
+				0x80, 0x80, 0x0b, 0x0a, 0x09, 0x08},
+		{0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04, 0x08, 0x80,
+				0x80, 0x80, 0x0c, 0x0b, 0x0a, 0x09},
+		{0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x03, 0x02,
+				0x80, 0x80, 0x07, 0x06, 0x05, 0x04},
+		{0x01, 0x00, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x04, 0x03,
+				0x80, 0x80, 0x08, 0x07, 0x06, 0x05},
+		{0x02, 0x01, 0x00, 0x80, 0x03, 0x80, 0x80, 0x80, 0x05, 0x04,
+				0x80, 0x80, 0x09, 0x08, 0x07, 0x06},
+		{0x03, 0x02, 0x01, 0x00, 0x04, 0x80, 0x80, 0x80, 0x06, 0x05,
+				0x80, 0x80, 0x0a, 0x09, 0x08, 0x07},
+		{0x00, 0x80, 0x80, 0x80, 0x02, 0x01, 0x80, 0x80, 0x04, 0x03,
+				0x80, 0x80, 0x08, 0x07, 0x06, 0x05},
+		{0x01, 0x00, 0x80, 0x80, 0x03, 0x02, 0x80, 0x80, 0x05, 0x04,
+				0x80, 0x80, 0x09, 0x08, 0x07, 0x06},
+		{0x02, 0x01, 0x00, 0x80, 0x04, 0x03, 0x80, 0x80, 0x06, 0x05,
+				0x80, 0x80, 0x0a, 0x09, 0x08, 0x07},
+		{0x03, 0x02, 0x01, 0x00, 0x05, 0x04, 0x80, 0x80, 0x07, 0x06,
+				0x80, 0x80, 0x0b, 0x0a, 0x09, 0x08},
+		{0x00, 0x80, 0x80, 0x80, 0x03, 0x02, 0x01, 0x80, 0x05, 0x04,
+				0x80, 0x80, 0x09, 0x08, 0x07, 0x06},
+		{0x01, 0x00, 0x80, 0x80, 0x04, 0x03, 0x02, 0x80, 0x06, 0x05,
+				0x80, 0x80, 0x0a, 0x09, 0x08, 0x07},
+		{0x02, 0x01, 0x00, 0x80, 0x05, 0x04, 0x03, 0x80, 0x07, 0x06,
+				0x80, 0x80, 0x0b, 0x0a, 0x09, 0x08},
+		{0x03, 0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x80, 0x08, 0x07,
+				0x80, 0x80, 0x0c, 0x0b, 0x0a, 0x09},
+		{0x00, 0x80, 0x80, 0x80, 0x04, 0x03, 0x02, 0x01, 0x06, 0x05,
+				0x80, 0x80, 0x0a, 0x09, 0x08, 0x07},
+		{0x01, 0x00, 0x80, 0x80, 0x05, 0x04, 0x03, 0x02, 0x07, 0x06,
+				0x80, 0x80, 0x0b, 0x0a, 0x09, 0x08},
+		{0x02, 0x01, 0x00, 0x80, 0x06, 0x05, 0x04, 0x03, 0x08, 0x07,
+				0x80, 0x80, 0x0c, 0x0b, 0x0a, 0x09},
+		{0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04, 0x09, 0x08,
+				0x80, 0x80, 0x0d, 0x0c, 0x0b, 0x0a},
+		{0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x04, 0x03,
+				0x02, 0x80, 0x08, 0x07, 0x06, 0x05},
+		{0x01, 0x00, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x05, 0x04,
+				0x03, 0x80, 0x09, 0x08, 0x07, 0x06},
+		{0x02, 0x01, 0x00, 0x80, 0x03, 0x80, 0x80, 0x80, 0x06, 0x05,
+				0x04, 0x80, 0x0a, 0x09, 0x08, 0x07},
+		{0x03, 0x02, 0x01, 0x00, 0x04, 0x80, 0x80, 0x80, 0x07, 0x06,
+				0x05, 0x80, 0x0b, 0x0a, 0x09, 0x08},
+		{0x00, 0x80, 0x80, 0x80, 0x02, 0x01, 0x80, 0x80, 0x05, 0x04,
+				0x03, 0x80, 0x09, 0x08, 0x07, 0x06},
+		{0x01, 0x00, 0x80, 0x80, 0x03, 0x02, 0x80, 0x80, 0x06, 0x05,
+				0x04, 0x80, 0x0a, 0x09, 0x08, 0x07},
+		{0x02, 0x01, 0x00, 0x80, 0x04, 0x03, 0x80, 0x80, 0x07, 0x06,
+				0x05, 0x80, 0x0b, 0x0a, 0x09, 0x08},
+		{0x03, 0x02, 0x01, 0x00, 0x05, 0x04, 0x80, 0x80, 0x08, 0x07,
+				0x06, 0x80, 0x0c, 0x0b, 0x0a, 0x09},
+		{0x00, 0x80, 0x80, 0x80, 0x03, 0x02, 0x01, 0x80, 0x06, 0x05,
+				0x04, 0x80, 0x0a, 0x09, 0x08, 0x07},
+		{0x01, 0x00, 0x80, 0x80, 0x04, 0x03, 0x02, 0x80, 0x07, 0x06,
+				0x05, 0x80, 0x0b, 0x0a, 0x09, 0x08},
+		{0x02, 0x01, 0x00, 0x80, 0x05, 0x04, 0x03, 0x80, 0x08, 0x07,
+				0x06, 0x80, 0x0c, 0x0b, 0x0a, 0x09},
+		{0x03, 0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x80, 0x09, 0x08,
+				0x07, 0x80, 0x0d, 0x0c, 0x0b, 0x0a},
+		{0x00, 0x80, 0x80, 0x80, 0x04, 0x03, 0x02, 0x01, 0x07, 0x06,
+				0x05, 0x80, 0x0b, 0x0a, 0x09, 0x08},
+		{0x01, 0x00, 0x80, 0x80, 0x05, 0x04, 0x03, 0x02, 0x08, 0x07,
+				0x06, 0x80, 0x0c, 0x0b, 0x0a, 0x09},
+		{0x02, 0x01, 0x00, 0x80, 0x06, 0x05, 0x04, 0x03, 0x09, 0x08,
+				0x07, 0x80, 0x0d, 0x0c, 0x0b, 0x0a},
+		{0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04, 0x0a, 0x09,
+				0x08, 0x80, 0x0e, 0x0d, 0x0c, 0x0b},
+		{0x00, 0x80, 0x80, 0x80, 0x01, 0x80, 0x80, 0x80, 0x05, 0x04,
+				0x03, 0x02, 0x09, 0x08, 0x07, 0x06},
+		{0x01, 0x00, 0x80, 0x80, 0x02, 0x80, 0x80, 0x80, 0x06, 0x05,
+				0x04, 0x03, 0x0a, 0x09, 0x08, 0x07},
+		{0x02, 0x01, 0x00, 0x80, 0x03, 0x80, 0x80, 0x80, 0x07, 0x06,
+				0x05, 0x04, 0x0b, 0x0a, 0x09, 0x08},
+		{0x03, 0x02, 0x01, 0x00, 0x04, 0x80, 0x80, 0x80, 0x08, 0x07,
+				0x06, 0x05, 0x0c, 0x0b, 0x0a, 0x09},
+		{0x00, 0x80, 0x80, 0x80, 0x02, 0x01, 0x80, 0x80, 0x06, 0x05,
+				0x04, 0x03, 0x0a, 0x09, 0x08, 0x07},
+		{0x01, 0x00, 0x80, 0x80, 0x03, 0x02, 0x80, 0x80, 0x07, 0x06,
+				0x05, 0x04, 0x0b, 0x0a, 0x09, 0x08},
+		{0x02, 0x01, 0x00, 0x80, 0x04, 0x03, 0x80, 0x80, 0x08, 0x07,
+				0x06, 0x05, 0x0c, 0x0b, 0x0a, 0x09},
+		{0x03, 0x02, 0x01, 0x00, 0x05, 0x04, 0x80, 0x80, 0x09, 0x08,
+				0x07, 0x06, 0x0d, 0x0c, 0x0b, 0x0a},
+		{0x00, 0x80, 0x80, 0x80, 0x03, 0x02, 0x01, 0x80, 0x07, 0x06,
+				0x05, 0x04, 0x0b, 0x0a, 0x09, 0x08},
+		{0x01, 0x00, 0x80, 0x80, 0x04, 0x03, 0x02, 0x80, 0x08, 0x07,
+				0x06, 0x05, 0x0c, 0x0b, 0x0a, 0x09},
+		{0x02, 0x01, 0x00, 0x80, 0x05, 0x04, 0x03, 0x80, 0x09, 0x08,
+				0x07, 0x06, 0x0d, 0x0c, 0x0b, 0x0a},
+		{0x03, 0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x80, 0x0a, 0x09,
+				0x08, 0x07, 0x0e, 0x0d, 0x0c, 0x0b},
+		{0x00, 0x80, 0x80, 0x80, 0x04, 0x03, 0x02, 0x01, 0x08, 0x07,
+				0x06, 0x05, 0x0c, 0x0b, 0x0a, 0x09},
+		{0x01, 0x00, 0x80, 0x80, 0x05, 0x04, 0x03, 0x02, 0x09, 0x08,
+				0x07, 0x06, 0x0d, 0x0c, 0x0b, 0x0a},
+		{0x02, 0x01, 0x00, 0x80, 0x06, 0x05, 0x04, 0x03, 0x0a, 0x09,
+				0x08, 0x07, 0x0e, 0x0d, 0x0c, 0x0b},
+		{0x03, 0x02, 0x01, 0x00, 0x07, 0x06, 0x05, 0x04, 0x0b, 0x0a,
+				0x09, 0x08, 0x0f, 0x0e, 0x0d, 0x0c},
+};
+
+// The bits of a byte which are part of a codepoint, indexed by its high
+// nybble.
+static const uint8_t payload_mask_table[16] = {
+		// 00..7F
+		0x7f,
+		0x7f,
+		0x7f,
+		0x7f,
+		0x7f,
+		0x7f,
+		0x7f,
+		0x7f,
+		// 80..BF
+		0x3f,
+		0x3f,
+		0x3f,
+		0x3f,
+		// C0..DF
+		0x1f,
+		0x1f,
+		// E0..EF
+		0x0f,
+		// F0..FF
+		0x07,
+};
+
+// How much of str is validated at a time before decoding it, so that it's
+// still in the cache when it's decoded.
+#define DECODE_CHUNK_LEN 4096
+
+// Writes the 16 ASCII characters in in to out as codepoints.
+static inline void
+store_ascii(const __m128i in, uint32_t* out)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i lo   = _mm_unpacklo_epi8(in, zero);
+	const __m128i hi   = _mm_unpackhi_epi8(in, zero);
+
+	__m128i* o = (__m128i*)out;
+	_mm_storeu_si128(o, _mm_unpacklo_epi16(lo, zero));
+	_mm_storeu_si128(o + 1, _mm_unpackhi_epi16(lo, zero));
+	_mm_storeu_si128(o + 2, _mm_unpacklo_epi16(hi, zero));
+	_mm_storeu_si128(o + 3, _mm_unpackhi_epi16(hi, zero));
+}
+
+// Decodes the valid UTF-8 in str into out while more than 64 bytes of str are
+// left and out has room for 64 codepoints. Returns how many bytes of str were
+// decoded, and sets *written to the number of codepoints written.
+//
+// str is read 64 bytes at a time, and the starts of its characters are found
+// once for all of them. Then 16 bytes of ASCII or 4 characters are decoded at
+// a time, until fewer than 16 bytes of the block are left. The only thing
+// carried from one group of characters to the next is the mask of starts, so
+// decoding one group doesn't need to wait for the one before it.
+ENCODING_TARGET("ssse3")
+static size_t
+decode_valid_ssse3(const size_t str_len, const uint8_t* str,
+		const size_t out_len, uint32_t* out, size_t* written)
+{
+	const __m128i payload_masks =
+			_mm_loadu_si128((const __m128i*)payload_mask_table);
+	const __m128i nybble   = _mm_set1_epi8(0x0f);
+	const __m128i pair_mul = _mm_set1_epi16(0x4001);
+	const __m128i quad_mul = _mm_set1_epi32(0x10000001);
+
+	// As signed bytes, continuation bytes are the only ones less than
+	// 0xc0.
+	const __m128i cont_end = _mm_set1_epi8((char)0xc0);
+
+	size_t i = 0;
+	size_t j = 0;
+	while (str_len - i > 64 && out_len - j >= 64) {
+		__m128i  in[4];
+		uint64_t non_ascii     = 0;
+		uint64_t continuations = 0;
+		for (int k = 0; k < 4; k += 1) {
+			in[k] = _mm_loadu_si128((const __m128i*)&str[i] + k);
+
+			const __m128i conts = _mm_cmplt_epi8(in[k], cont_end);
+			const int     high  = _mm_movemask_epi8(in[k]);
+			const int     cont  = _mm_movemask_epi8(conts);
+			non_ascii |= (uint64_t)high << (16 * k);
+			continuations |= (uint64_t)cont << (16 * k);
+		}
+
+		if (non_ascii == 0) {
+			for (int k = 0; k < 4; k += 1) {
+				store_ascii(in[k], &out[j + 16 * k]);
 			}
 
-			i += 2;
+			i += 64;
+			j += 64;
 			continue;
 		}
 
-		if (b >= 0xee && b <= 0xef) {
-			if (i + 2 >= str_len) {
-				return false;
+		// Bit k of starts is set if str[i + k] starts a character.
+		uint64_t starts = ~continuations;
+		size_t   p      = 0;
+		while (p < 48) {
+			const __m128i block = _mm_loadu_si128(
+					(const __m128i*)&str[i + p]);
+			if (((non_ascii >> p) & 0xffff) == 0) {
+				store_ascii(block, &out[j]);
+				p += 16;
+				j += 16;
+				starts &= ~UINT64_C(0) << p;
+				continue;
 			}
 
-			if (!is_continuation(str[i + 1]) ||
-					!is_continuation(str[i + 2])) {
-				return false;
-			}
+			// The 4 characters starting at p end within 16 bytes,
+			// so before the end of the block.
+			starts &= starts - 1;
+			const size_t end_1 = (size_t)__builtin_ctzll(starts);
+			starts &= starts - 1;
+			const size_t end_2 = (size_t)__builtin_ctzll(starts);
+			starts &= starts - 1;
+			const size_t end_3 = (size_t)__builtin_ctzll(starts);
+			starts &= starts - 1;
+			const size_t end_4 = (size_t)__builtin_ctzll(starts);
+
+			const size_t index = (end_1 - p - 1) |
+					     ((end_2 - end_1 - 1) << 2) |
+					     ((end_3 - end_2 - 1) << 4) |
+					     ((end_4 - end_3 - 1) << 6);
+
+			// Clear the bits which mark the length of each
+			// character, and move the bytes of each into its lane.
+			const __m128i nybbles = _mm_and_si128(
+					_mm_srli_epi16(block, 4), nybble);
+			const __m128i masks   = _mm_shuffle_epi8(
+					payload_masks, nybbles);
+			const __m128i shuffle = _mm_loadu_si128(
+					(const __m128i*)decode_table[index]);
+			const __m128i lanes   = _mm_shuffle_epi8(
+					_mm_and_si128(block, masks), shuffle);
+
+			// Join the 6 bits of each pair of bytes, then the 12
+			// bits of each pair of pairs.
+			const __m128i pairs =
+					_mm_maddubs_epi16(lanes, pair_mul);
+			_mm_storeu_si128((__m128i*)&out[j],
+					_mm_madd_epi16(pairs, quad_mul));
+
+			p = end_4;
+			j += 4;
+		}
 
-			i += 2;
-			continue;
+		i += p;
+	}
+
+	*written = j;
+	return i;
+}
+
+// Decodes as much of str as possible into out, validating it a chunk at a
+// time with the best validator the CPU supports and decoding what's valid.
+// Returns how many bytes of str were decoded, which is always the start of a
+// character, and sets *written to the number of codepoints written.
+static size_t
+decode_simd(const size_t str_len, const uint8_t* str, const size_t out_len,
+		uint32_t* out, size_t* written)
+{
+	*written = 0;
+	if (!(encoding_cpu_features() & ENCODING_CPU_SSSE3)) {
+		return 0;
+	}
+
+	size_t i = 0;
+	size_t j = 0;
+	for (;;) {
+		size_t len = str_len - i;
+		if (len > DECODE_CHUNK_LEN) {
+			len = DECODE_CHUNK_LEN;
 		}
 
-		if (b == 0xf0) {
-			if (i + 3 >= str_len) {
-				return false;
-			}
+		size_t       n         = 0;
+		const size_t valid_len = valid_simd(len, &str[i], NULL);
+		const size_t decoded   = decode_valid_ssse3(valid_len, &str[i],
+				  out_len - j, &out[j], &n);
+		if (decoded == 0) {
+			break;
+		}
 
-			if (!(str[i + 1] >= 0x90 && str[i + 1] <= 0xbf) ||
-					!is_continuation(str[i + 2]) ||
-					!is_continuation(str[i + 3])) {
-				return false;
-			}
+		i += decoded;
+		j += n;
+	}
 
-			i += 3;
-			continue;
+	*written = j;
+	return i;
+}
+
+// The encoders below put each of 4 codepoints below U+10000 into its own
+// 32-bit lane, with the last byte of its encoding lowest, then the byte before
+// it, then the lead byte of a 3 byte character. Bit k of an index into these
+// tables is set if codepoint k takes more than 1 byte, and bit k + 4 if it
+// takes more than 2.
+//
+// The first holds the pshufb indices which move the bytes of the 4 codepoints
+// next to each other, and the second holds how many bytes they take up.
+//
+// Generated using tools/gen_utf8_encode_table.c
+static const uint8_t encode_table[256][16] = {
+		{0x00, 0x04, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x04, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x06, 0x05, 0x04, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x06, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x08, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x04, 0x0a, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x0a, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x0a, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x04, 0x0a, 0x09, 0x08, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x06, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x06, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d,
+				0x0c, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x04, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x04, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x06, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x06, 0x05, 0x04, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x08, 0x0e, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d,
+				0x0c, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x04, 0x0a, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x0a, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0e, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x04, 0x0a, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x04, 0x0a, 0x09, 0x08, 0x0e, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0e, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0e, 0x0d,
+				0x0c, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x06, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0e, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x00, 0x06, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0e, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0e, 0x0d,
+				0x0c, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0d,
+				0x0c, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c, 0x80,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x09, 0x08, 0x0e, 0x0d,
+				0x0c, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0e, 0x0d, 0x0c,
+				0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0e, 0x0d,
+				0x0c, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x01, 0x00, 0x06, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0e, 0x0d,
+				0x0c, 0x80, 0x80, 0x80, 0x80, 0x80},
+		{0x02, 0x01, 0x00, 0x06, 0x05, 0x04, 0x0a, 0x09, 0x08, 0x0e,
+				0x0d, 0x0c, 0x80, 0x80, 0x80, 0x80},
+};
+
+static const uint8_t encode_lengths[256] = {
+		//
+		4, 5, 5, 6, 5, 6, 6, 7, 5, 6, 6, 7, 6, 7, 7, 8, 5, 6, 6, 7, 6,
+		7, 7, 8, 6, 7, 7, 8, 7, 8, 8, 9, 5, 6, 6, 7, 6, 7, 7, 8, 6, 7,
+		7, 8, 7, 8, 8, 9, 6, 7, 7, 8, 7, 8, 8, 9, 7, 8, 8, 9, 8, 9, 9,
+		10, 5, 6, 6, 7, 6, 7, 7, 8, 6, 7, 7, 8, 7, 8, 8, 9, 6, 7, 7, 8,
+		7, 8, 8, 9, 7, 8, 8, 9, 8, 9, 9, 10, 6, 7, 7, 8, 7, 8, 8, 9, 7,
+		8, 8, 9, 8, 9, 9, 10, 7, 8, 8, 9, 8, 9, 9, 10, 8, 9, 9, 10, 9,
+		10, 10, 11, 5, 6, 6, 7, 6, 7, 7, 8, 6, 7, 7, 8, 7, 8, 8, 9, 6,
+		7, 7, 8, 7, 8, 8, 9, 7, 8, 8, 9, 8, 9, 9, 10, 6, 7, 7, 8, 7, 8,
+		8, 9, 7, 8, 8, 9, 8, 9, 9, 10, 7, 8, 8, 9, 8, 9, 9, 10, 8, 9,
+		9, 10, 9, 10, 10, 11, 6, 7, 7, 8, 7, 8, 8, 9, 7, 8, 8, 9, 8, 9,
+		9, 10, 7, 8, 8, 9, 8, 9, 9, 10, 8, 9, 9, 10, 9, 10, 10, 11, 7,
+		8, 8, 9, 8, 9, 9, 10, 8, 9, 9, 10, 9, 10, 10, 11, 8, 9, 9, 10,
+		9, 10, 10, 11, 9, 10, 10, 11, 10, 11, 11, 12,
+};
+
+// Encodes the 4 codepoints below U+10000 in in to out, which must have room
+// for 16 bytes, and returns the number of bytes they take up.
+ENCODING_TARGET("ssse3")
+static inline size_t
+encode_bmp_ssse3(const __m128i in, uint8_t* out)
+{
+	const __m128i multi = _mm_cmpgt_epi32(in, _mm_set1_epi32(0x7f));
+	const __m128i three = _mm_cmpgt_epi32(in, _mm_set1_epi32(0x7ff));
+	const __m128i low_6 = _mm_set1_epi32(0x3f);
+	const __m128i cont  = _mm_set1_epi32(0x80);
+
+	// ASCII is kept as it is, and the rest end in a continuation byte.
+	const __m128i tail = _mm_or_si128(_mm_and_si128(in, low_6), cont);
+	const __m128i last = _mm_or_si128(_mm_and_si128(multi, tail),
+			_mm_andnot_si128(multi, in));
+
+	// The byte before it is the lead byte of a 2 byte character, or
+	// another continuation byte.
+	const __m128i two_lead = _mm_andnot_si128(three, _mm_set1_epi32(0x40));
+	const __m128i mid_bits = _mm_and_si128(_mm_srli_epi32(in, 6), low_6);
+	const __m128i mid =
+			_mm_or_si128(_mm_or_si128(mid_bits, cont), two_lead);
+
+	const __m128i lead = _mm_or_si128(
+			_mm_srli_epi32(in, 12), _mm_set1_epi32(0xe0));
+	const __m128i lanes = _mm_or_si128(
+			_mm_or_si128(last, _mm_slli_epi32(mid, 8)),
+			_mm_slli_epi32(lead, 16));
+
+	const int index = _mm_movemask_ps(_mm_castsi128_ps(multi)) |
+			  (_mm_movemask_ps(_mm_castsi128_ps(three)) << 4);
+	const __m128i shuffle =
+			_mm_loadu_si128((const __m128i*)encode_table[index]);
+	_mm_storeu_si128((__m128i*)out, _mm_shuffle_epi8(lanes, shuffle));
+	return encode_lengths[index];
+}
+
+// Encodes the 4 codepoints at the start of str, which are also in in, to
+// out, which must have room for 16 bytes. Returns the number of bytes they
+// take up.
+ENCODING_TARGET("ssse3")
+static inline size_t
+encode_4_ssse3(const uint32_t* str, const __m128i in, uint8_t* out)
+{
+	const __m128i high = _mm_and_si128(in, _mm_set1_epi32(~0xffff));
+	if (UNLIKELY(_mm_movemask_epi8(_mm_cmpeq_epi32(
+				     high, _mm_setzero_si128())) != 0xffff)) {
+		size_t j = 0;
+		for (size_t k = 0; k < 4; k += 1) {
+			j += codepoint_encode_unchecked(str[k], &out[j]);
 		}
 
-		if (b >= 0xf1 && b <= 0xf3) {
-			if (i + 3 >= str_len) {
-				return false;
-			}
+		return j;
+	}
 
-			if (!is_continuation(str[i + 1]) ||
-					!is_continuation(str[i + 2]) ||
-					!is_continuation(str[i + 3])) {
-				return false;
-			}
+	return encode_bmp_ssse3(in, out);
+}
+
+// Encodes str into out 16 codepoints at a time while at least 16 are left.
+// Returns how many codepoints were encoded, and sets *written to the number of
+// bytes written. out must have room for 4 bytes for each codepoint in str.
+ENCODING_TARGET("ssse3")
+static size_t
+encode_ssse3(const size_t str_len, const uint32_t* str, uint8_t* out,
+		size_t* written)
+{
+	const __m128i zero      = _mm_setzero_si128();
+	const __m128i not_ascii = _mm_set1_epi32(~0x7f);
+
+	size_t i = 0;
+	size_t j = 0;
+	for (; str_len - i >= 16; i += 16) {
+		__m128i in[4];
+		__m128i any = zero;
+		for (int k = 0; k < 4; k += 1) {
+			in[k] = _mm_loadu_si128((const __m128i*)&str[i] + k);
+			any   = _mm_or_si128(any, in[k]);
+		}
 
-			i += 3;
+		// A run of ASCII is narrowed to bytes with saturating packs,
+		// which leave values below 0x80 alone.
+		const __m128i high = _mm_and_si128(any, not_ascii);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, zero)) == 0xffff) {
+			const __m128i lo = _mm_packs_epi32(in[0], in[1]);
+			const __m128i hi = _mm_packs_epi32(in[2], in[3]);
+			_mm_storeu_si128((__m128i*)&out[j],
+					_mm_packus_epi16(lo, hi));
+			j += 16;
 			continue;
 		}
 
-		if (b == 0xf4) {
-			if (i + 3 >= str_len) {
-				return false;
-			}
+		for (int k = 0; k < 4; k += 1) {
+			j += encode_4_ssse3(&str[i + 4 * k], in[k], &out[j]);
+		}
+	}
 
-			if (!(str[i + 1] >= 0x80 && str[i + 1] <= 0x8f) ||
-					!is_continuation(str[i + 2]) ||
-					!is_continuation(str[i + 3])) {
-				return false;
-			}
+	*written = j;
+	return i;
+}
+
+// Encodes the 8 codepoints below U+10000 in in to out, which must have room
+// for 28 bytes, and returns the number of bytes they take up.
+ENCODING_TARGET("avx2")
+static inline size_t
+encode_bmp_avx2(const __m256i in, uint8_t* out)
+{
+	const __m256i multi = _mm256_cmpgt_epi32(in, _mm256_set1_epi32(0x7f));
+	const __m256i three = _mm256_cmpgt_epi32(in, _mm256_set1_epi32(0x7ff));
+	const __m256i low_6 = _mm256_set1_epi32(0x3f);
+	const __m256i cont  = _mm256_set1_epi32(0x80);
+
+	// The same as encode_bmp_ssse3, with the two halves of in shuffled
+	// using separate entries of encode_table.
+	const __m256i tail =
+			_mm256_or_si256(_mm256_and_si256(in, low_6), cont);
+	const __m256i last = _mm256_or_si256(_mm256_and_si256(multi, tail),
+			_mm256_andnot_si256(multi, in));
+
+	const __m256i two_lead =
+			_mm256_andnot_si256(three, _mm256_set1_epi32(0x40));
+	const __m256i mid_bits =
+			_mm256_and_si256(_mm256_srli_epi32(in, 6), low_6);
+	const __m256i mid = _mm256_or_si256(
+			_mm256_or_si256(mid_bits, cont), two_lead);
+
+	const __m256i lead = _mm256_or_si256(
+			_mm256_srli_epi32(in, 12), _mm256_set1_epi32(0xe0));
+	const __m256i lanes = _mm256_or_si256(
+			_mm256_or_si256(last, _mm256_slli_epi32(mid, 8)),
+			_mm256_slli_epi32(lead, 16));
+
+	const int multi_mask = _mm256_movemask_ps(_mm256_castsi256_ps(multi));
+	const int three_mask = _mm256_movemask_ps(_mm256_castsi256_ps(three));
+	const int lo = (multi_mask & 0x0f) | ((three_mask & 0x0f) << 4);
+	const int hi = (multi_mask >> 4) | (three_mask & 0xf0);
+
+	const __m128i lo_shuffle =
+			_mm_loadu_si128((const __m128i*)encode_table[lo]);
+	const __m128i hi_shuffle =
+			_mm_loadu_si128((const __m128i*)encode_table[hi]);
+	const __m256i shuffle = _mm256_inserti128_si256(
+			_mm256_castsi128_si256(lo_shuffle), hi_shuffle, 1);
+	const __m256i bytes = _mm256_shuffle_epi8(lanes, shuffle);
+
+	const size_t lo_len = encode_lengths[lo];
+	_mm_storeu_si128((__m128i*)out, _mm256_castsi256_si128(bytes));
+	_mm_storeu_si128((__m128i*)&out[lo_len],
+			_mm256_extracti128_si256(bytes, 1));
+	return lo_len + encode_lengths[hi];
+}
+
+// Encodes the 8 codepoints at the start of str, which are also in in, to
+// out, which must have room for 32 bytes. Returns the number of bytes they
+// take up.
+ENCODING_TARGET("avx2")
+static inline size_t
+encode_8_avx2(const uint32_t* str, const __m256i in, uint8_t* out)
+{
+	if (UNLIKELY(!_mm256_testz_si256(in, _mm256_set1_epi32(~0xffff)))) {
+		// Half of them may still be below U+10000.
+		const __m128i lo = _mm256_castsi256_si128(in);
+		const __m128i hi = _mm256_extracti128_si256(in, 1);
+		const size_t  j  = encode_4_ssse3(str, lo, out);
+		return j + encode_4_ssse3(&str[4], hi, &out[j]);
+	}
+
+	return encode_bmp_avx2(in, out);
+}
+
+// The same as encode_ssse3, 32 codepoints at a time.
+ENCODING_TARGET("avx2")
+static size_t
+encode_avx2(const size_t str_len, const uint32_t* str, uint8_t* out,
+		size_t* written)
+{
+	const __m256i not_ascii = _mm256_set1_epi32(~0x7f);
+
+	// The packs below work within each 128-bit half, which leaves the
+	// groups of 4 bytes out of order.
+	const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+	size_t i = 0;
+	size_t j = 0;
+	for (; str_len - i >= 32; i += 32) {
+		__m256i in[4];
+		__m256i any = _mm256_setzero_si256();
+		for (int k = 0; k < 4; k += 1) {
+			in[k] = _mm256_loadu_si256(
+					(const __m256i*)&str[i] + k);
+			any = _mm256_or_si256(any, in[k]);
+		}
 
-			i += 3;
+		if (_mm256_testz_si256(any, not_ascii)) {
+			const __m256i lo = _mm256_packs_epi32(in[0], in[1]);
+			const __m256i hi = _mm256_packs_epi32(in[2], in[3]);
+			const __m256i bytes = _mm256_permutevar8x32_epi32(
+					_mm256_packus_epi16(lo, hi), order);
+			_mm256_storeu_si256((__m256i*)&out[j], bytes);
+			j += 32;
 			continue;
 		}
 
+		for (int k = 0; k < 4; k += 1) {
+			j += encode_8_avx2(&str[i + 8 * k], in[k], &out[j]);
+		}
+	}
+
+	*written = j;
+	return i;
+}
+
+// Encodes as much of str as possible using the best kernels the CPU supports.
+// Returns how many codepoints were encoded, and sets *written to the number
+// of bytes written. out must have room for 4 bytes for each codepoint in str.
+static size_t
+encode_simd(const size_t str_len, const uint32_t* str, uint8_t* out,
+		size_t* written)
+{
+	const int features = encoding_cpu_features();
+
+	size_t i = 0;
+	size_t j = 0;
+	size_t n = 0;
+	if (features & ENCODING_CPU_AVX2) {
+		i = encode_avx2(str_len, str, out, &n);
+		j = n;
+	}
+
+	if (features & ENCODING_CPU_SSSE3) {
+		i += encode_ssse3(str_len - i, str + i, out + j, &n);
+		j += n;
+	}
+
+	*written = j;
+	return i;
+}
+#endif // ENCODING_X86_SIMD
+
+ENCODING_PUBLIC
+bool
+utf8_valid(const size_t str_len, const uint8_t* str)
+{
+	if (UNLIKELY(str == NULL)) {
 		return false;
 	}
 
-	return true;
+	// Unicode Standard Version 14, Table 3-7. Well-Formed UTF-8 Byte
+	// Sequences:
+	//
+	// +--------------------+--------+--------+--------+--------+
+	// |   Code Points      | First  | Second | Third  | Fourth |
+	// +--------------------+--------+--------+--------+--------+
+	// | U+0000..U+007F     | 00..7F |        |        |        |
+	// | U+0080..U+07FF     | C2..DF | 80..BF |        |        |
+	// | U+0800..U+0FFF     | E0     | A0..BF | 80..BF |        |
+	// | U+1000..U+CFFF     | E1..EC | 80..BF | 80..BF |        |
+	// | U+D000..U+D7FF     | ED     | 80..9F | 80..BF |        |
+	// | U+E000..U+FFFF     | EE..EF | 80..BF | 80..BF |        |
+	// | U+10000..U+3FFFF   | F0     | 90..BF | 80..BF | 80..BF |
+	// | U+40000..U+FFFFF   | F1..F3 | 80..BF | 80..BF | 80..BF |
+	// | U+100000..U+10FFFF | F4     | 80..8F | 80..BF | 80..BF |
+	// +--------------------+--------+--------+--------+--------+
+	size_t i = 0;
+#if ENCODING_X86_SIMD
+	i = valid_simd(str_len, str, NULL);
+#endif
+
+	// The DFA encodes the table. Since it never leaves DFA_ERROR, we only
+	// need to check for it once every 8 bytes, and 8 bytes of ASCII
+	// between characters can be skipped entirely.
+	uint32_t state = DFA_ACCEPT;
+	for (; i + 8 <= str_len; i += 8) {
+		if ((state == DFA_ACCEPT) & ascii_8(&str[i])) {
+			continue;
+		}
+
+		for (size_t k = 0; k < 8; k += 1) {
+			state = dfa_step(state, str[i + k]);
+		}
+
+		if (UNLIKELY(state == DFA_ERROR)) {
+			return false;
+		}
+	}
+
+	for (; i < str_len; i += 1) {
+		state = dfa_step(state, str[i]);
+		if (UNLIKELY(state == DFA_ERROR)) {
+			return false;
+		}
+	}
+
+	return state == DFA_ACCEPT;
 }
 
 ENCODING_PUBLIC
@@ -245,44 +2206,16 @@ utf8_codepoint_encode(const uint32_t cp, const size_t out_len, uint8_t* out)
 	assert(out_len == 0 || out != NULL);
 
 	size_t size = utf8_codepoint_size(cp);
-	if (out_len < size) {
-		return ENCODING_BUFFER_TOO_SMALL;
+	if (size == 0) {
+		// Invalid codepoints are encoded as U+FFFD.
+		size = 3;
 	}
 
-	uint8_t* bytes = out;
-
-	switch (size) {
-	case 1:
-		bytes[0] = (uint8_t)cp;
-		break;
-	case 2:
-		bytes[0] = ((cp >> 6) & 0x1f) | 0xc0;
-		bytes[1] = ((cp >> 0) & 0x3f) | 0x80;
-		break;
-	case 3:
-		bytes[0] = ((cp >> 12) & 0x0f) | 0xe0;
-		bytes[1] = ((cp >> 6) & 0x3f) | 0x80;
-		bytes[2] = ((cp >> 0) & 0x3f) | 0x80;
-		break;
-	case 4:
-		bytes[0] = ((cp >> 18) & 0x07) | 0xf0;
-		bytes[1] = ((cp >> 12) & 0x3f) | 0x80;
-		bytes[2] = ((cp >> 6) & 0x3f) | 0x80;
-		bytes[3] = ((cp >> 0) & 0x3f) | 0x80;
-		break;
-	default:
-		if (out_len < 3) {
-			return ENCODING_BUFFER_TOO_SMALL;
-		}
-
-		bytes[0] = utf8_replacement[0];
-		bytes[1] = utf8_replacement[1];
-		bytes[2] = utf8_replacement[2];
-
-		return 3;
+	if (out_len < size) {
+		return ENCODING_BUFFER_TOO_SMALL;
 	}
 
-	return (int)size;
+	return (int)codepoint_encode_unchecked(cp, out);
 }
 
 ENCODING_PUBLIC
@@ -296,22 +2229,154 @@ utf8_encode(const size_t str_len, const uint32_t* str, const size_t out_len,
 
 	assert(str != NULL);
 
-	size_t encoded_size = utf8_encoded_length(str_len, str);
-
-	if (encoded_size > out_len) {
+	if (out_len == 0) {
 		return ENCODING_BUFFER_TOO_SMALL;
 	}
 
 	assert(out != NULL);
 
+	// No codepoint takes more than 4 bytes, so while out has room for 4
+	// bytes for each codepoint left we can encode without checking. We do
+	// that for as many codepoints as are sure to fit, until there are
+	// only a few left which might not.
+	size_t i = 0;
 	size_t j = 0;
-	for (size_t i = 0; i < str_len; i += 1) {
-		j += utf8_codepoint_encode(str[i], out_len - j, &out[j]);
+	while (i < str_len && out_len - j >= 256) {
+		size_t n = (out_len - j) / 4;
+		if (n > str_len - i) {
+			n = str_len - i;
+		}
+
+		j += utf8_encode_unchecked(n, &str[i], &out[j]);
+		i += n;
+	}
+
+	for (; i < str_len; i += 1) {
+		const int size = utf8_codepoint_encode(
+				str[i], out_len - j, &out[j]);
+		if (UNLIKELY(size < 0)) {
+			// We don't want to partially write to out if we
+			// couldn't encode the entire buffer.
+			for (size_t k = 0; k < out_len; k += 1) {
+				out[k] = 0;
+			}
+
+			return size;
+		}
+
+		j += (size_t)size;
 	}
 
 	return (int)j;
 }
 
+ENCODING_PUBLIC
+size_t
+utf8_encode_unchecked(const size_t str_len, const uint32_t* str, uint8_t* out)
+{
+	if (str_len == 0) {
+		return 0;
+	}
+
+	assert(str != NULL);
+	assert(out != NULL);
+
+	size_t i = 0;
+	size_t j = 0;
+#if ENCODING_X86_SIMD
+	i = encode_simd(str_len, str, out, &j);
+#endif
+
+	for (; str_len - i >= 8; i += 8) {
+		uint32_t any = 0;
+		for (size_t k = 0; k < 8; k += 1) {
+			any |= str[i + k];
+		}
+
+		if (any <= 0x7f) {
+			for (size_t k = 0; k < 8; k += 1) {
+				out[j + k] = (uint8_t)str[i + k];
+			}
+
+			j += 8;
+			continue;
+		}
+
+		for (size_t k = 0; k < 8; k += 1) {
+			j += codepoint_encode_unchecked(str[i + k], &out[j]);
+		}
+	}
+
+	for (; i < str_len; i += 1) {
+		j += codepoint_encode_unchecked(str[i], &out[j]);
+	}
+
+	return j;
+}
+
+// Counts the codepoints utf8_decode writes for str using the DFA, starting at
+// str[*pos], which must be the start of a character. Stops at the end of str,
+// or just after the first byte which isn't part of a character so that the
+// SIMD validator can take over again, and updates *pos.
+static size_t
+count_dfa(const size_t str_len, const uint8_t* str, size_t* pos)
+{
+	// The DFA checks 8 bytes at a time, and if they're valid we count
+	// them all at once. If they weren't, the loop below handles them.
+	size_t   result = 0;
+	size_t   i      = *pos;
+	uint32_t state  = DFA_ACCEPT;
+	for (; i + 8 <= str_len; i += 8) {
+		const uint64_t word = load_64(&str[i]);
+		if ((state == DFA_ACCEPT) & ((word & high_bits_64) == 0)) {
+			result += 8;
+			continue;
+		}
+
+		uint32_t next = state;
+		for (size_t k = 0; k < 8; k += 1) {
+			next = dfa_step(next, str[i + k]);
+		}
+
+		if (UNLIKELY(next == DFA_ERROR)) {
+			break;
+		}
+
+		state = next;
+		result += characters_8(word);
+	}
+
+	// The first byte of an unfinished character was counted, but the loop
+	// below needs to start at it.
+	if (state != DFA_ACCEPT) {
+		i     = dfa_character_start(str, i);
+		state = DFA_ACCEPT;
+		result -= 1;
+	}
+
+	size_t start = i;
+	for (; i < str_len; i += 1) {
+		start = state == DFA_ACCEPT ? i : start;
+		state = dfa_step(state, str[i]);
+		if (UNLIKELY(state == DFA_ERROR)) {
+			// The first byte is counted on its own, and we start
+			// again from the byte after it.
+			*pos = start + 1;
+			return result + 1;
+		}
+
+		result += state == DFA_ACCEPT;
+	}
+
+	// None of the bytes of a truncated character are part of one.
+	if (state != DFA_ACCEPT) {
+		result += str_len - start;
+	}
+
+	*pos = str_len;
+	return result;
+}
+
 ENCODING_PUBLIC
 size_t
 utf8_decoded_length(const size_t str_len, const uint8_t* str)
@@ -322,11 +2387,19 @@ utf8_decoded_length(const size_t str_len, const uint8_t* str)
 
 	assert(str != NULL);
 
+	// This counts exactly what utf8_decode writes: one codepoint for each
+	// character, and one for each byte which isn't part of one. In valid
+	// UTF-8, that's the number of bytes which aren't continuation bytes,
+	// so once a stretch of str is known to be valid we count those. After
+	// each invalid byte we go back to the fastest way of doing that.
 	size_t result = 0;
 	size_t i      = 0;
 	while (i < str_len) {
-		result += 1;
-		i += encoded_size_table[str[i]];
+#if ENCODING_X86_SIMD
+		i += valid_simd(str_len - i, &str[i], &result);
+#endif
+
+		result += count_dfa(str_len, str, &i);
 	}
 
 	return result;
@@ -342,67 +2415,117 @@ utf8_codepoint_decode(const size_t str_len, const uint8_t* str, size_t* size)
 		out_size = &tmp;
 	}
 
+	// On failure, size is the width of the Unicode Replacement Character.
+	*out_size = 3;
 	if (UNLIKELY(str == NULL || str_len == 0)) {
-		*out_size = 3;
 		return ENCODING_CODEPOINT_ERROR;
 	}
 
-	const size_t len = encoded_size_table[str[0]];
-	if (UNLIKELY(str_len < len)) {
-		*out_size = 3;
-		return ENCODING_CODEPOINT_ERROR;
+	const size_t len   = str_len < 4 ? str_len : 4;
+	uint32_t     cp    = 0;
+	uint32_t     state = DFA_ACCEPT;
+	for (size_t i = 0; i < len; i += 1) {
+		state = dfa_decode_step(state, str[i], &cp);
+		if (state == DFA_ACCEPT) {
+			*out_size = i + 1;
+			return cp;
+		}
+
+		if (state == DFA_ERROR) {
+			break;
+		}
 	}
 
-	switch (len) {
-	case 2:
-		if (!is_continuation(str[1])) {
-			*out_size = 3;
-			return ENCODING_CODEPOINT_ERROR;
+	return ENCODING_CODEPOINT_ERROR;
+}
+
+// Decodes str into out using the DFA, starting at str[*str_pos], which must
+// be the start of a character, and out[*out_pos]. Stops at the end of str,
+// or just after the first byte which isn't part of a character so that the
+// SIMD decoder can take over again, and updates *str_pos and *out_pos.
+//
+// Returns 0 or one of the errors utf8_decode returns.
+static int
+decode_dfa(const size_t str_len, const uint8_t* str, const size_t out_len,
+		uint32_t* out, size_t* str_pos, size_t* out_pos)
+{
+	// Every byte is fed to the DFA, and out[j] is overwritten with the
+	// codepoint read so far until a character is finished. This keeps the
+	// loop free of branches which depend on the lengths of characters.
+	//
+	// We first go 8 bytes at a time while there's room for 8 codepoints,
+	// only checking for errors at the end. If there was one, we go back to
+	// the start of the 8 bytes and let the loop below handle it.
+	size_t   i     = *str_pos;
+	size_t   j     = *out_pos;
+	uint32_t cp    = 0;
+	uint32_t state = DFA_ACCEPT;
+	for (; i + 8 <= str_len && out_len - j >= 8; i += 8) {
+		if ((state == DFA_ACCEPT) & ascii_8(&str[i])) {
+			for (size_t k = 0; k < 8; k += 1) {
+				out[j + k] = str[i + k];
+			}
+
+			j += 8;
+			continue;
 		}
 
-		*out_size = 2;
-		return ((0x1f & str[0]) << 6) | (0x3f & str[1]);
-	case 3: {
-		const bool ranges = (str[1] >= 0xa0 && str[1] <= 0xbf) ||
-				    (str[1] >= 0x80 && str[1] <= 0x9f);
-		if (!is_continuation(str[2]) || !ranges) {
-			*out_size = 3;
-			return ENCODING_CODEPOINT_ERROR;
+		const uint32_t chunk_state = state;
+		const uint32_t chunk_cp    = cp;
+		const size_t   chunk_j     = j;
+		for (size_t k = 0; k < 8; k += 1) {
+			state  = dfa_decode_step(state, str[i + k], &cp);
+			out[j] = cp;
+			j += state == DFA_ACCEPT;
 		}
 
-		*out_size = 3;
-		return ((0x0f & str[0]) << 12) | ((0x3f & str[1]) << 6) |
-		       (0x3f & str[2]);
-	}
-	case 4: {
-		const bool byte2checks = is_continuation(str[1]) ||
-					 (str[1] >= 0x90 && str[1] <= 0xbf) ||
-					 (str[1] >= 0x80 && str[1] <= 0x8f);
-		if (!is_continuation(str[2]) || !is_continuation(str[3]) ||
-				!byte2checks) {
-			*out_size = 3;
-			return ENCODING_CODEPOINT_ERROR;
+		if (UNLIKELY(state == DFA_ERROR)) {
+			state = chunk_state;
+			cp    = chunk_cp;
+			j     = chunk_j;
+			break;
 		}
+	}
 
-		*out_size = 4;
-		return ((0x07 & str[0]) << 18) | ((0x3f & str[1]) << 12) |
-		       ((0x3f & str[2]) << 6) | (0x3f & str[3]);
+	// The loop below needs to know where the current character started,
+	// so we begin it at the start of one.
+	if (state != DFA_ACCEPT) {
+		i     = dfa_character_start(str, i);
+		state = DFA_ACCEPT;
 	}
-	default:
-		break;
+
+	size_t start = i;
+	for (; i < str_len; i += 1) {
+		// j only reaches out_len between characters, so there is
+		// still at least one codepoint left in str.
+		if (UNLIKELY(j == out_len)) {
+			return ENCODING_BUFFER_TOO_SMALL;
+		}
+
+		start = state == DFA_ACCEPT ? i : start;
+		state = dfa_decode_step(state, str[i], &cp);
+		if (UNLIKELY(state == DFA_ERROR)) {
+			// The first byte is decoded as U+FFFD on its own, and
+			// we start again from the byte after it.
+			out[j]   = ENCODING_CODEPOINT_ERROR;
+			*str_pos = start + 1;
+			*out_pos = j + 1;
+			return 0;
+		}
+
+		out[j] = cp;
+		j += state == DFA_ACCEPT;
 	}
 
-	// Invalid bytes are 1 in encoded_size_table, so we still have
-	// to check for correctness here.
-	//
-	// In every other case, the first byte can be assumed valid.
-	if (str[0] >= 0x7f) {
-		*out_size = 3;
-		return ENCODING_CODEPOINT_ERROR;
+	*str_pos = i;
+	*out_pos = j;
+
+	// A codepoint in the input was truncated.
+	if (state != DFA_ACCEPT) {
+		return ENCODING_INVALID_ARGUMENT;
 	}
 
-	*out_size = 1;
-	return str[0];
+	return 0;
 }
 
 ENCODING_PUBLIC
@@ -422,38 +2545,29 @@ utf8_decode(const size_t str_len, const uint8_t* str, const size_t out_len,
 
 	assert(out != NULL);
 
-	bool   truncated = false;
-	size_t j         = 0;
-	size_t i         = 0;
-	while (i < str_len && j < out_len) {
-		size_t len = encoded_size_table[str[i]];
-		if (UNLIKELY(i + len > str_len)) {
-			truncated = true;
-			break;
-		}
+	int    result = 0;
+	size_t i      = 0;
+	size_t j      = 0;
+	while (result == 0 && i < str_len) {
+#if ENCODING_X86_SIMD
+		size_t written = 0;
+		i += decode_simd(str_len - i, &str[i], out_len - j, &out[j],
+				&written);
+		j += written;
+#endif
 
-		out[j] = utf8_codepoint_decode(str_len - i, str + i, &len);
-		i += len;
-		j += 1;
+		result = decode_dfa(str_len, str, out_len, out, &i, &j);
 	}
 
-	// We couldn't decode the entire output.
-	if (UNLIKELY(i < str_len)) {
+	if (UNLIKELY(result != 0)) {
 		// We don't want to partially write to out if we couldn't
 		// decode the entire buffer.
 		for (size_t k = 0; k < out_len; k += 1) {
 			out[k] = 0;
 		}
-
-		// A codepoint in the input was truncated.
-		if (truncated) {
-			return ENCODING_INVALID_ARGUMENT;
-		}
-
-		return ENCODING_BUFFER_TOO_SMALL;
 	}
 
-	return 0;
+	return result;
 }
 
 #if defined(__cplusplus)
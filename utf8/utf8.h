@@ -55,11 +55,24 @@ bool utf8_valid(const size_t str_len, const uint8_t* str);
 // ENCODING_BUFFER_TOO_SMALL
 // 	out_len was too small to hold the encoded data. To find out how many
 //      bytes are needed to encode the data, call
-//      utf8_encoded_length.
+//      utf8_encoded_length. The first out_len bytes of out are set to 0,
+//      so that no partially encoded data is left in it.
 ENCODING_PUBLIC
 int utf8_encode(const size_t str_len, const uint32_t* str,
 		const size_t out_len, uint8_t* out);
 
+// utf8_encode_unchecked encodes the unicode codepoint sequence str into out in
+// the same way as utf8_encode, reading at most str_len codepoints of str, but
+// without checking how much room is left in out. out must have room for at
+// least 4 * str_len bytes, which is enough for any str.
+//
+// out and str must not be NULL.
+//
+// Returns the number of bytes written.
+ENCODING_PUBLIC
+size_t utf8_encode_unchecked(
+		const size_t str_len, const uint32_t* str, uint8_t* out);
+
 // utf8_encoded_length returns the number of bytes str will take up when
 // encoded as UTF-8. Invalid codepoints will be said to take up 3 bytes, since
 // they are encoded as the Unicode Replacement Character (U+FFFD).
@@ -88,7 +101,10 @@ int utf8_codepoint_encode(
 // utf8_decode decodes the UTF-8 encoded string str into a sequence of Unicode
 // codepoints out, reading at most len bytes of str and writing at most out_len
 // codepoints to out. Any invalid bytes are decoded as the Unicode Replacement
-// Character (U+FFFD).
+// Character (U+FFFD), one for each byte, so the number of codepoints written
+// is utf8_decoded_length(str_len, str). The exception is when str ends partway
+// through a character: utf8_decode returns ENCODING_INVALID_ARGUMENT, while
+// utf8_decoded_length counts each of that character's bytes as a codepoint.
 //
 // out and str must not be NULL.
 //
@@ -108,7 +124,7 @@ int utf8_decode(const size_t str_len, const uint8_t* str, const size_t out_len,
 
 // utf8_decoded_length counts the number of codepoints found in the first len
 // bytes of str. Invalid UTF-8 is treated as a sequence of single byte
-// codepoints.
+// codepoints, in the same way as utf8_decode.
 //
 // str must not be NULL.
 ENCODING_PUBLIC